@@ -0,0 +1,986 @@
+/***************************************************************************//**
+ * @file bytecode.c
+ * @author Dorian Weber und die Studenten
+ * @brief Implementation des Bytecodeübersetzers und der virtuellen Maschine.
+ ******************************************************************************/
+
+#include "bytecode.h"
+#include "stack.h"
+#include "quota.h"
+#include "definite.h"
+#include "minako.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/**@brief Maximale Anzahl der Register in einem Rahmen.
+ */
+#define BYTECODE_MAX_REGS 0xFFFFu
+
+/* ******************************************************* private structures */
+
+/**@brief Zustand des Übersetzers.
+ */
+typedef struct bytecode_compiler_s
+{
+	bytecode_t* prog;       /**<@brief Das entstehende Programm. */
+	const syntree_t* tree;  /**<@brief Der übersetzte Syntaxbaum. */
+	unsigned int* index;    /**<@brief Abbildung Knoten-ID -> Funktion + 1. */
+	unsigned int func;      /**<@brief Index der aktuellen Funktion. */
+	unsigned int top;       /**<@brief Nächstes freies Register. */
+	definite_t defs;        /**<@brief Uninitialisiert lesbare Plätze. */
+} bytecode_compiler_t;
+
+/**@brief Aufrufrahmen der virtuellen Maschine.
+ */
+typedef struct bytecode_frame_s
+{
+	const bytecode_instr_t* pc; /**<@brief Rücksprungadresse. */
+	bytecode_value_t* base;     /**<@brief Registerbasis des Aufrufers. */
+	bytecode_value_t* ret;      /**<@brief Zielregister für das Ergebnis. */
+} bytecode_frame_t;
+
+/* ******************************************************** private functions */
+
+/* Hilfsfunktionen */
+
+/**@brief Gibt den Zeiger auf einen Knoten der entsprechenden ID zurück.
+ */
+static inline const syntree_node_t*
+nodePtr(const bytecode_compiler_t* c, syntree_nid id)
+{
+	return syntreeNodePtr(c->tree, id);
+}
+
+/**@brief Gibt die ID des ersten Kindknotens eines Containers zurück.
+ */
+static inline syntree_nid
+nodeFirst(const bytecode_compiler_t* c, syntree_nid id)
+{
+	return nodePtr(c, id)->value.container.first;
+}
+
+/**@brief Gibt die ID des Folgeknotens eines Knotens zurück.
+ */
+static inline syntree_nid
+nodeNext(const bytecode_compiler_t* c, syntree_nid id)
+{
+	return nodePtr(c, id)->next;
+}
+
+/**@brief Gibt die aktuell übersetzte Funktion zurück.
+ */
+static inline bytecode_func_t*
+currentFunc(bytecode_compiler_t* c)
+{
+	return &c->prog->funcs[c->func];
+}
+
+/**@brief Gibt die Adresse der nächsten Instruktion zurück.
+ */
+static inline int
+here(bytecode_compiler_t* c)
+{
+	return stackCount(currentFunc(c)->code);
+}
+
+/**@brief Hängt eine Instruktion an die aktuelle Funktion an.
+ * @return Adresse der Instruktion
+ */
+static int
+emit(bytecode_compiler_t* c, bytecode_op op,
+     unsigned int a, unsigned int b, unsigned int r, int k)
+{
+	bytecode_func_t* fn = currentFunc(c);
+	bytecode_instr_t* instr = &stackPush(fn->code);
+
+	instr->op = op;
+	instr->a = a;
+	instr->b = b;
+	instr->c = r;
+	instr->k.integer = k;
+
+	return stackCount(fn->code) - 1;
+}
+
+/**@brief Setzt das Sprungziel einer Instruktion auf die nächste Adresse.
+ * @note Sprungziele werden relativ zur springenden Instruktion gespeichert.
+ */
+static inline void
+patch(bytecode_compiler_t* c, int pc)
+{
+	currentFunc(c)->code[pc].k.integer = here(c) - pc;
+}
+
+/**@brief Erzeugt einen bedingten Rücksprung an eine Schleifenadresse.
+ */
+static inline void
+jumpBack(bytecode_compiler_t* c, unsigned int cond, int loop)
+{
+	emit(c, BYTECODE_OP_JumpTrue, 0, cond, 0, loop - here(c));
+}
+
+/**@brief Reserviert ein Register für ein Zwischenergebnis.
+ */
+static unsigned int
+alloc(bytecode_compiler_t* c)
+{
+	bytecode_func_t* fn = currentFunc(c);
+
+	if (c->top >= BYTECODE_MAX_REGS)
+	{
+		fputs("too many registers in function\n", stderr);
+		exit(-1);
+	}
+
+	if (++c->top > fn->frame)
+		fn->frame = c->top;
+
+	return c->top - 1;
+}
+
+/**@brief Ermittelt den Funktionsindex eines Funktionsknotens und meldet die
+ * Funktion gegebenenfalls zur Übersetzung an.
+ */
+static unsigned int
+funcIndex(bytecode_compiler_t* c, syntree_nid id)
+{
+	if (c->index[id] == 0)
+	{
+		bytecode_func_t* fn = &stackPush(c->prog->funcs);
+
+		if (stackInit(fn->code))
+		{
+			fputs("out-of-memory error\n", stderr);
+			exit(-1);
+		}
+
+		fn->node = id;
+		fn->locals = fn->frame = nodePtr(c, id)->value.function.locals;
+		c->index[id] = stackCount(c->prog->funcs);
+	}
+
+	return c->index[id] - 1;
+}
+
+/**@brief Prüft, ob ein Ausdruck der lokalen Variable \p slot einen Wert
+ * zuweist.
+ */
+static int
+assignsLocal(const bytecode_compiler_t* c, syntree_nid id, int slot)
+{
+	const syntree_node_t* node = nodePtr(c, id);
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+		return 0;
+
+	case SYNTREE_TAG_Call:
+		/* nur die Argumente, nicht den Funktionskörper betrachten */
+		return assignsLocal(c, node->value.container.first, slot);
+
+	case SYNTREE_TAG_Assign:
+		if (nodePtr(c, node->value.container.first)->tag == SYNTREE_TAG_LocVar
+		 && nodePtr(c, node->value.container.first)->value.variable == slot)
+			return 1;
+
+		/* fall through */
+	default:
+		for (id = node->value.container.first; id != 0; id = nodeNext(c, id))
+			if (assignsLocal(c, id, slot))
+				return 1;
+
+		return 0;
+	}
+}
+
+/**@brief Wählt den Opcode einer binären Operation.
+ * @param tag    Knotenart des Operators
+ * @param type   Typ der Operanden
+ * @param konst  1, falls die Variante mit konstantem Operanden gesucht ist
+ * @return der Opcode oder -1, falls keine passende Instruktion existiert
+ */
+static int
+binaryOp(syntree_node_tag tag, syntree_node_type type, int konst)
+{
+	int isFloat = (type == SYNTREE_TYPE_Float);
+
+	if (konst && (isFloat || type == SYNTREE_TYPE_Boolean))
+		return -1;
+
+	switch (tag)
+	{
+	case SYNTREE_TAG_Plus:
+		return isFloat ? BYTECODE_OP_AddFloat
+		     : konst ? BYTECODE_OP_AddIntK : BYTECODE_OP_AddInt;
+	case SYNTREE_TAG_Minus:
+		return isFloat ? BYTECODE_OP_SubFloat
+		     : konst ? BYTECODE_OP_SubIntK : BYTECODE_OP_SubInt;
+	case SYNTREE_TAG_Times:
+		return isFloat ? BYTECODE_OP_MulFloat
+		     : konst ? BYTECODE_OP_MulIntK : BYTECODE_OP_MulInt;
+	case SYNTREE_TAG_Divide:
+		return isFloat ? BYTECODE_OP_DivFloat
+		     : konst ? -1 : BYTECODE_OP_DivInt;
+	case SYNTREE_TAG_Eqt:
+		return isFloat ? BYTECODE_OP_EqFloat
+		     : konst ? BYTECODE_OP_EqIntK : BYTECODE_OP_EqInt;
+	case SYNTREE_TAG_Neq:
+		return isFloat ? BYTECODE_OP_NeFloat
+		     : konst ? BYTECODE_OP_NeIntK : BYTECODE_OP_NeInt;
+	case SYNTREE_TAG_Leq:
+		return isFloat ? BYTECODE_OP_LeFloat
+		     : konst ? BYTECODE_OP_LeIntK : BYTECODE_OP_LeInt;
+	case SYNTREE_TAG_Geq:
+		return isFloat ? BYTECODE_OP_GeFloat
+		     : konst ? BYTECODE_OP_GeIntK : BYTECODE_OP_GeInt;
+	case SYNTREE_TAG_Lst:
+		return isFloat ? BYTECODE_OP_LtFloat
+		     : konst ? BYTECODE_OP_LtIntK : BYTECODE_OP_LtInt;
+	case SYNTREE_TAG_Grt:
+		return isFloat ? BYTECODE_OP_GtFloat
+		     : konst ? BYTECODE_OP_GtIntK : BYTECODE_OP_GtInt;
+	default:
+		assert(!"unexpected binary operator");
+		return -1;
+	}
+}
+
+/* Übersetzung */
+
+static unsigned int
+compileExpr(bytecode_compiler_t* c, syntree_nid id, int dst);
+
+static void
+compileStmt(bytecode_compiler_t* c, syntree_nid id);
+
+/**@brief Übersetzt eine binäre arithmetische Operation oder einen Vergleich.
+ */
+static unsigned int
+compileBinary(bytecode_compiler_t* c, const syntree_node_t* node, int dst)
+{
+	syntree_nid lhs = node->value.container.first;
+	syntree_nid rhs = node->value.container.last;
+	const syntree_node_t* l = nodePtr(c, lhs);
+	const syntree_node_t* r = nodePtr(c, rhs);
+	unsigned int saved = c->top, a, b;
+	int op;
+
+	/* Variante mit konstantem rechten Operanden */
+	if (r->tag == SYNTREE_TAG_Integer
+	 && (op = binaryOp(node->tag, l->type, 1)) >= 0)
+	{
+		a = compileExpr(c, lhs, -1);
+		c->top = saved;
+
+		if (dst < 0)
+			dst = alloc(c);
+
+		emit(c, op, dst, a, 0, r->value.integer);
+		return dst;
+	}
+
+	/* die linke Seite muss vor Zuweisungen auf der rechten Seite
+	 * gesichert werden */
+	if (l->tag == SYNTREE_TAG_LocVar && assignsLocal(c, rhs, l->value.variable))
+		a = compileExpr(c, lhs, alloc(c));
+	else
+		a = compileExpr(c, lhs, -1);
+
+	b = compileExpr(c, rhs, -1);
+	c->top = saved;
+
+	if (dst < 0)
+		dst = alloc(c);
+
+	emit(c, binaryOp(node->tag, l->type, 0), dst, a, b, 0);
+	return dst;
+}
+
+/**@brief Übersetzt eine logische Verknüpfung mit Kurzschlussauswertung.
+ */
+static unsigned int
+compileLogical(bytecode_compiler_t* c, const syntree_node_t* node, int dst)
+{
+	/* Variablenregister dürfen erst nach der Auswertung überschrieben werden */
+	unsigned int res = (dst < 0 || (unsigned int) dst < currentFunc(c)->locals)
+	                 ? alloc(c) : (unsigned int) dst;
+	int jump;
+
+	compileExpr(c, node->value.container.first, res);
+	jump = emit(c, node->tag == SYNTREE_TAG_LogOr
+	             ? BYTECODE_OP_JumpTrue : BYTECODE_OP_JumpFalse, 0, res, 0, 0);
+	compileExpr(c, node->value.container.last, res);
+	patch(c, jump);
+
+	if (dst >= 0 && res != (unsigned int) dst)
+	{
+		emit(c, BYTECODE_OP_Move, dst, res, 0, 0);
+		return dst;
+	}
+
+	return res;
+}
+
+/**@brief Übersetzt einen Funktionsaufruf.
+ */
+static unsigned int
+compileCall(bytecode_compiler_t* c, const syntree_node_t* node, int dst)
+{
+	unsigned int base = c->top, reg;
+	unsigned int func = funcIndex(c, node->value.container.last);
+	syntree_nid arg;
+
+	/* Argumente in aufeinanderfolgende Register */
+	for (arg = nodeFirst(c, node->value.container.first); arg != 0;
+	     arg = nodeNext(c, arg))
+	{
+		reg = alloc(c);
+		compileExpr(c, arg, reg);
+		c->top = reg + 1;
+	}
+
+	c->top = base;
+
+	if (dst < 0)
+		dst = alloc(c);
+
+	emit(c, BYTECODE_OP_Call, dst, base, 0, func);
+	return dst;
+}
+
+/**@brief Übersetzt eine Zuweisung.
+ * @param used  != 0, falls ein umgebender Ausdruck den Wert verwendet
+ */
+static unsigned int
+compileAssign(bytecode_compiler_t* c, const syntree_node_t* node, int dst,
+              int used)
+{
+	const syntree_node_t* var = nodePtr(c, node->value.container.first);
+	unsigned int res;
+
+	if (var->tag == SYNTREE_TAG_LocVar)
+	{
+		res = compileExpr(c, node->value.container.last, var->value.variable);
+
+		if (dst >= 0 && (unsigned int) dst != res)
+		{
+			emit(c, BYTECODE_OP_Move, dst, res, 0, 0);
+			return dst;
+		}
+	}
+	else
+	{
+		res = compileExpr(c, node->value.container.last, dst);
+		emit(c, BYTECODE_OP_SetGlobal, 0, res, 0, var->value.variable);
+	}
+
+	/* ein Variablenregister könnte von einer späteren Zuweisung im selben
+	 * Ausdruck überschrieben werden, bevor der Wert verwendet wird */
+	if (used && dst < 0 && res < currentFunc(c)->locals)
+	{
+		dst = alloc(c);
+		emit(c, BYTECODE_OP_Move, dst, res, 0, 0);
+		return dst;
+	}
+
+	return res;
+}
+
+/**@brief Übersetzt einen Ausdruck.
+ * @param c    der Übersetzer
+ * @param id   Knoten-ID des Ausdrucks
+ * @param dst  Zielregister oder -1, falls das Register frei wählbar ist
+ * @return das Register, das den Wert des Ausdrucks enthält
+ */
+static unsigned int
+compileExpr(bytecode_compiler_t* c, syntree_nid id, int dst)
+{
+	const syntree_node_t* node = nodePtr(c, id);
+	unsigned int saved = c->top, a;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+		if (dst < 0)
+			dst = alloc(c);
+
+		a = emit(c, BYTECODE_OP_LoadK, dst, 0, 0, 0);
+
+		if (node->tag == SYNTREE_TAG_Float)
+			currentFunc(c)->code[a].k.real = node->value.real;
+		else
+			currentFunc(c)->code[a].k.integer = node->value.integer;
+
+		return dst;
+
+	case SYNTREE_TAG_LocVar:
+		if (dst < 0 || dst == node->value.variable)
+			return node->value.variable;
+
+		emit(c, BYTECODE_OP_Move, dst, node->value.variable, 0, 0);
+		return dst;
+
+	case SYNTREE_TAG_GlobVar:
+		if (dst < 0)
+			dst = alloc(c);
+
+		emit(c, BYTECODE_OP_GetGlobal, dst, 0, 0, node->value.variable);
+		return dst;
+
+	case SYNTREE_TAG_Call:
+		return compileCall(c, node, dst);
+
+	case SYNTREE_TAG_Assign:
+		return compileAssign(c, node, dst, 1);
+
+	case SYNTREE_TAG_Cast:
+		assert(node->type == SYNTREE_TYPE_Float);
+		a = compileExpr(c, node->value.container.first, -1);
+		c->top = saved;
+
+		if (dst < 0)
+			dst = alloc(c);
+
+		emit(c, BYTECODE_OP_IntToFloat, dst, a, 0, 0);
+		return dst;
+
+	case SYNTREE_TAG_Uminus:
+		a = compileExpr(c, node->value.container.first, -1);
+		c->top = saved;
+
+		if (dst < 0)
+			dst = alloc(c);
+
+		emit(c, node->type == SYNTREE_TYPE_Float
+		      ? BYTECODE_OP_NegFloat : BYTECODE_OP_NegInt, dst, a, 0, 0);
+		return dst;
+
+	case SYNTREE_TAG_LogOr:
+	case SYNTREE_TAG_LogAnd:
+		return compileLogical(c, node, dst);
+
+	case SYNTREE_TAG_Plus:
+	case SYNTREE_TAG_Minus:
+	case SYNTREE_TAG_Times:
+	case SYNTREE_TAG_Divide:
+	case SYNTREE_TAG_Eqt:
+	case SYNTREE_TAG_Neq:
+	case SYNTREE_TAG_Leq:
+	case SYNTREE_TAG_Geq:
+	case SYNTREE_TAG_Lst:
+	case SYNTREE_TAG_Grt:
+		return compileBinary(c, node, dst);
+
+	default:
+		assert(!"unexpected node in expression");
+		return 0;
+	}
+}
+
+/**@brief Übersetzt eine Ausgabeanweisung.
+ */
+static void
+compilePrint(bytecode_compiler_t* c, const syntree_node_t* node)
+{
+	const syntree_node_t* arg = nodePtr(c, node->value.container.first);
+	unsigned int reg;
+
+	if (arg->tag == SYNTREE_TAG_String)
+	{
+		stackPush(c->prog->strings) = arg->value.string;
+		emit(c, BYTECODE_OP_PrintString, 0, 0, 0,
+		     stackCount(c->prog->strings) - 1);
+		return;
+	}
+
+	reg = compileExpr(c, node->value.container.first, -1);
+
+	switch (arg->type)
+	{
+	case SYNTREE_TYPE_Boolean:
+		emit(c, BYTECODE_OP_PrintBool, 0, reg, 0, 0);
+		break;
+
+	case SYNTREE_TYPE_Integer:
+		emit(c, BYTECODE_OP_PrintInt, 0, reg, 0, 0);
+		break;
+
+	case SYNTREE_TYPE_Float:
+		emit(c, BYTECODE_OP_PrintFloat, 0, reg, 0, 0);
+		break;
+
+	default:
+		emit(c, BYTECODE_OP_PrintVoid, 0, reg, 0, 0);
+	}
+}
+
+/**@brief Übersetzt eine Anweisung.
+ */
+static void
+compileStmt(bytecode_compiler_t* c, syntree_nid id)
+{
+	const syntree_node_t* node = nodePtr(c, id);
+	unsigned int saved = c->top;
+	syntree_nid init, cond, step, body;
+	int jump, loop;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Sequence:
+		for (id = node->value.container.first; id != 0; id = nodeNext(c, id))
+			compileStmt(c, id);
+
+		break;
+
+	case SYNTREE_TAG_Function:
+		/* der Aufruf von main() im Programmknoten */
+		init = alloc(c);
+		emit(c, BYTECODE_OP_Call, init, init, 0, funcIndex(c, id));
+		break;
+
+	case SYNTREE_TAG_If:
+		cond = node->value.container.first;
+		body = nodeNext(c, cond);
+
+		jump = emit(c, BYTECODE_OP_JumpFalse, 0, compileExpr(c, cond, -1), 0, 0);
+		c->top = saved;
+		compileStmt(c, body);
+
+		if (nodeNext(c, body) != 0)
+		{
+			loop = jump;
+			jump = emit(c, BYTECODE_OP_Jump, 0, 0, 0, 0);
+			patch(c, loop);
+			compileStmt(c, nodeNext(c, body));
+		}
+
+		patch(c, jump);
+		break;
+
+	case SYNTREE_TAG_For:
+		init = node->value.container.first;
+		cond = nodeNext(c, init);
+		step = nodeNext(c, cond);
+		body = nodeNext(c, step);
+
+		compileStmt(c, init);
+		jump = emit(c, BYTECODE_OP_Jump, 0, 0, 0, 0);
+		loop = here(c);
+		compileStmt(c, body);
+		compileStmt(c, step);
+		patch(c, jump);
+		jumpBack(c, compileExpr(c, cond, -1), loop);
+		break;
+
+	case SYNTREE_TAG_While:
+		cond = node->value.container.first;
+		body = node->value.container.last;
+
+		jump = emit(c, BYTECODE_OP_Jump, 0, 0, 0, 0);
+		loop = here(c);
+		compileStmt(c, body);
+		patch(c, jump);
+		jumpBack(c, compileExpr(c, cond, -1), loop);
+		break;
+
+	case SYNTREE_TAG_DoWhile:
+		cond = node->value.container.first;
+		body = node->value.container.last;
+
+		loop = here(c);
+		compileStmt(c, body);
+		jumpBack(c, compileExpr(c, cond, -1), loop);
+		break;
+
+	case SYNTREE_TAG_Print:
+		compilePrint(c, node);
+		break;
+
+	case SYNTREE_TAG_Return:
+		if (node->value.container.first != 0)
+			emit(c, BYTECODE_OP_Return, 0,
+			     compileExpr(c, node->value.container.first, -1), 0, 0);
+		else
+			emit(c, BYTECODE_OP_ReturnVoid, 0, 0, 0, 0);
+
+		break;
+
+	case SYNTREE_TAG_Assign:
+		compileAssign(c, node, -1, 0);
+		break;
+
+	default:
+		/* Ausdrucksanweisungen (Aufrufe) */
+		compileExpr(c, id, -1);
+	}
+
+	c->top = saved;
+}
+
+/**@brief Übersetzt eine Funktion, deren Eintrag bereits angelegt ist.
+ */
+static void
+compileFunc(bytecode_compiler_t* c, unsigned int func)
+{
+	syntree_nid id = c->prog->funcs[func].node;
+	unsigned int i;
+
+	c->func = func;
+	c->top = currentFunc(c)->locals;
+
+	/* Register werden nicht aufgeräumt; Plätze, die vor ihrer Zuweisung
+	 * gelesen werden können, sind wie in den anderen Interpretern vorbelegt */
+	for (i = c->defs.start[id]; i < c->defs.start[id + 1]; ++i)
+		emit(c, BYTECODE_OP_LoadK, c->defs.slots[i], 0, 0, DUMMY);
+
+	compileStmt(c, nodeFirst(c, currentFunc(c)->node));
+	emit(c, BYTECODE_OP_ReturnVoid, 0, 0, 0, 0);
+}
+
+/* Ausgabe */
+
+/**@brief Gibt einen Stapelüberlauf aus und beendet das Programm.
+ */
+static void
+overflow(void)
+{
+	fflush(stdout);
+	fputs("stack overflow\n", stderr);
+	exit(QUOTA_EXIT_STACK);
+}
+
+/* ********************************************************* public functions */
+
+int
+bytecodeInit(bytecode_t* self)
+{
+	if (stackInit(self->funcs))
+		goto err0;
+
+	if (stackInit(self->strings))
+		goto err1;
+
+	self->globals = 0;
+	return 0;
+
+err1:	stackRelease(self->funcs);
+err0:	return -1;
+}
+
+void
+bytecodeRelease(bytecode_t* self)
+{
+	unsigned int i;
+
+	for (i = 0; i < stackCount(self->funcs); ++i)
+		stackRelease(self->funcs[i].code);
+
+	stackRelease(self->funcs);
+	stackRelease(self->strings);
+}
+
+void
+bytecodeCompile(bytecode_t* self, const syntree_t* tree)
+{
+	bytecode_compiler_t c;
+	unsigned int func;
+
+	c.prog = self;
+	c.tree = tree;
+	c.index = calloc(tree->len, sizeof(*c.index));
+
+	if (c.index == NULL || definiteInit(&c.defs, tree))
+	{
+		fputs("out-of-memory error\n", stderr);
+		exit(-1);
+	}
+
+	self->globals = tree->nodes[0].value.program.globals;
+
+	/* die Einstiegsfunktion hat keine Variablen; ihr "Körper" ist der
+	 * Programmknoten selbst, dessen erstes Kind die globale Sequenz ist */
+	funcIndex(&c, 0);
+	self->funcs[0].locals = self->funcs[0].frame = 0;
+
+	/* übersetze alle erreichbaren Funktionen (die Liste wächst dabei) */
+	for (func = 0; func < stackCount(self->funcs); ++func)
+		compileFunc(&c, func);
+
+	definiteRelease(&c.defs);
+	free(c.index);
+}
+
+int
+bytecodeRun(const bytecode_t* self, size_t size)
+{
+	bytecode_value_t *stack, *end, *base, *globals, val;
+	bytecode_frame_t *frames, *fp, *fend;
+	const bytecode_instr_t *pc, *i;
+	const bytecode_func_t* fn;
+	size_t len, g;
+
+	/* Register und Aufrufrahmen teilen sich die Stackgröße, wobei auf jeden
+	 * Rahmen mindestens ein Register kommt */
+	len = (size << 20) / (sizeof(*stack) + sizeof(*frames));
+
+	if (len == 0)
+		len = 1;
+
+	stack = malloc(len * sizeof(*stack));
+	frames = malloc(len * sizeof(*frames));
+	globals = malloc((self->globals + 1) * sizeof(*globals));
+
+	if (stack == NULL || frames == NULL || globals == NULL)
+	{
+		fputs("out-of-memory error\n", stderr);
+		exit(-1);
+	}
+
+	/* globale Variablen sind wie in den anderen Interpretern vorbelegt */
+	for (g = 0; g <= self->globals; ++g)
+		globals[g].integer = DUMMY;
+
+	end = stack + len;
+	fend = frames + len;
+	fp = frames;
+	base = stack;
+	pc = self->funcs[0].code;
+
+	#define R(X) base[X]
+
+	for (;;)
+	{
+		i = pc++;
+
+		switch ((bytecode_op) i->op)
+		{
+		/* Datentransfer */
+		case BYTECODE_OP_Move:      R(i->a) = R(i->b); break;
+		case BYTECODE_OP_LoadK:     R(i->a) = i->k; break;
+		case BYTECODE_OP_GetGlobal: R(i->a) = globals[i->k.integer]; break;
+		case BYTECODE_OP_SetGlobal: globals[i->k.integer] = R(i->b); break;
+
+		/* Ganzzahlarithmetik */
+		case BYTECODE_OP_AddInt:
+			R(i->a).integer = R(i->b).integer + R(i->c).integer; break;
+		case BYTECODE_OP_SubInt:
+			R(i->a).integer = R(i->b).integer - R(i->c).integer; break;
+		case BYTECODE_OP_MulInt:
+			R(i->a).integer = R(i->b).integer * R(i->c).integer; break;
+		case BYTECODE_OP_DivInt:
+			R(i->a).integer = R(i->b).integer / R(i->c).integer; break;
+		case BYTECODE_OP_AddIntK:
+			R(i->a).integer = R(i->b).integer + i->k.integer; break;
+		case BYTECODE_OP_SubIntK:
+			R(i->a).integer = R(i->b).integer - i->k.integer; break;
+		case BYTECODE_OP_MulIntK:
+			R(i->a).integer = R(i->b).integer * i->k.integer; break;
+		case BYTECODE_OP_NegInt:
+			R(i->a).integer = -R(i->b).integer; break;
+
+		/* Fließkommaarithmetik */
+		case BYTECODE_OP_AddFloat:
+			R(i->a).real = R(i->b).real + R(i->c).real; break;
+		case BYTECODE_OP_SubFloat:
+			R(i->a).real = R(i->b).real - R(i->c).real; break;
+		case BYTECODE_OP_MulFloat:
+			R(i->a).real = R(i->b).real * R(i->c).real; break;
+		case BYTECODE_OP_DivFloat:
+			R(i->a).real = R(i->b).real / R(i->c).real; break;
+		case BYTECODE_OP_NegFloat:
+			R(i->a).real = -R(i->b).real; break;
+		case BYTECODE_OP_IntToFloat:
+			R(i->a).real = R(i->b).integer; break;
+
+		/* Vergleiche */
+		case BYTECODE_OP_EqInt:
+			R(i->a).boolean = R(i->b).integer == R(i->c).integer; break;
+		case BYTECODE_OP_NeInt:
+			R(i->a).boolean = R(i->b).integer != R(i->c).integer; break;
+		case BYTECODE_OP_LeInt:
+			R(i->a).boolean = R(i->b).integer <= R(i->c).integer; break;
+		case BYTECODE_OP_GeInt:
+			R(i->a).boolean = R(i->b).integer >= R(i->c).integer; break;
+		case BYTECODE_OP_LtInt:
+			R(i->a).boolean = R(i->b).integer < R(i->c).integer; break;
+		case BYTECODE_OP_GtInt:
+			R(i->a).boolean = R(i->b).integer > R(i->c).integer; break;
+		case BYTECODE_OP_EqIntK:
+			R(i->a).boolean = R(i->b).integer == i->k.integer; break;
+		case BYTECODE_OP_NeIntK:
+			R(i->a).boolean = R(i->b).integer != i->k.integer; break;
+		case BYTECODE_OP_LeIntK:
+			R(i->a).boolean = R(i->b).integer <= i->k.integer; break;
+		case BYTECODE_OP_GeIntK:
+			R(i->a).boolean = R(i->b).integer >= i->k.integer; break;
+		case BYTECODE_OP_LtIntK:
+			R(i->a).boolean = R(i->b).integer < i->k.integer; break;
+		case BYTECODE_OP_GtIntK:
+			R(i->a).boolean = R(i->b).integer > i->k.integer; break;
+		case BYTECODE_OP_EqFloat:
+			R(i->a).boolean = R(i->b).real == R(i->c).real; break;
+		case BYTECODE_OP_NeFloat:
+			R(i->a).boolean = R(i->b).real != R(i->c).real; break;
+		case BYTECODE_OP_LeFloat:
+			R(i->a).boolean = R(i->b).real <= R(i->c).real; break;
+		case BYTECODE_OP_GeFloat:
+			R(i->a).boolean = R(i->b).real >= R(i->c).real; break;
+		case BYTECODE_OP_LtFloat:
+			R(i->a).boolean = R(i->b).real < R(i->c).real; break;
+		case BYTECODE_OP_GtFloat:
+			R(i->a).boolean = R(i->b).real > R(i->c).real; break;
+
+		/* Kontrollfluss */
+		case BYTECODE_OP_Jump:
+			pc = i + i->k.integer;
+			break;
+
+		case BYTECODE_OP_JumpFalse:
+			if (!R(i->b).boolean)
+				pc = i + i->k.integer;
+			break;
+
+		case BYTECODE_OP_JumpTrue:
+			if (R(i->b).boolean)
+			{
+				/* nur Schleifen springen zurück */
+				if (i->k.integer < 0)
+					QUOTA_BURN();
+
+				pc = i + i->k.integer;
+			}
+			break;
+
+		case BYTECODE_OP_Call:
+			QUOTA_BURN();
+			fn = &self->funcs[i->k.integer];
+
+			if (fp == fend || base + i->b + fn->frame > end)
+				overflow();
+
+			fp->pc = pc;
+			fp->base = base;
+			fp->ret = &R(i->a);
+			++fp;
+
+			base += i->b;
+			pc = fn->code;
+			break;
+
+		case BYTECODE_OP_Return:
+			val = R(i->b);
+
+			if (fp == frames)
+				goto halt;
+
+			--fp;
+			*fp->ret = val;
+			pc = fp->pc;
+			base = fp->base;
+			break;
+
+		case BYTECODE_OP_ReturnVoid:
+			if (fp == frames)
+				goto halt;
+
+			--fp;
+			pc = fp->pc;
+			base = fp->base;
+			break;
+
+		/* Ausgabe */
+		case BYTECODE_OP_PrintInt:
+			printf("%i\n", R(i->b).integer);
+			break;
+
+		case BYTECODE_OP_PrintFloat:
+			printf("%g\n", R(i->b).real);
+			break;
+
+		case BYTECODE_OP_PrintBool:
+			puts(R(i->b).boolean ? "true" : "false");
+			break;
+
+		case BYTECODE_OP_PrintString:
+			puts(self->strings[i->k.integer]);
+			break;
+
+		case BYTECODE_OP_PrintVoid:
+			putc('\n', stdout);
+			break;
+
+		default:
+			assert(!"unknown opcode");
+		}
+	}
+
+	#undef R
+
+halt:
+	free(globals);
+	free(frames);
+	free(stack);
+	return 0;
+}
+
+void
+bytecodePrint(const bytecode_t* self, FILE* out)
+{
+	const bytecode_func_t* fn;
+	const bytecode_instr_t* i;
+	unsigned int func, pc;
+
+	for (func = 0; func < stackCount(self->funcs); ++func)
+	{
+		fn = &self->funcs[func];
+		fprintf(out, "function %u [nid=%u, locals=%u, frame=%u] {\n",
+		        func, fn->node, fn->locals, fn->frame);
+
+		for (pc = 0; pc < stackCount(fn->code); ++pc)
+		{
+			i = &fn->code[pc];
+			fprintf(out, "%6u  %-12s %5u %5u %5u  ",
+			        pc, bytecodeOpName[i->op], i->a, i->b, i->c);
+
+			switch ((bytecode_op) i->op)
+			{
+			case BYTECODE_OP_Jump:
+			case BYTECODE_OP_JumpFalse:
+			case BYTECODE_OP_JumpTrue:
+				fprintf(out, "-> %i\n", (int) pc + i->k.integer);
+				break;
+
+			case BYTECODE_OP_LoadK:
+				fprintf(out, "%i (%g)\n", i->k.integer, i->k.real);
+				break;
+
+			case BYTECODE_OP_PrintString:
+				fprintf(out, "\"%s\"\n", self->strings[i->k.integer]);
+				break;
+
+			default:
+				fprintf(out, "%i\n", i->k.integer);
+			}
+		}
+
+		fputs("}\n", out);
+	}
+}
+
+/* *** external variables *************************************************** */
+
+const char* const bytecodeOpName[] = {
+#define NAME(OP) #OP,
+	BYTECODE_OP_LIST(NAME)
+#undef NAME
+};
@@ -0,0 +1,208 @@
+/***************************************************************************//**
+ * @file bytecode.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält einen registerbasierten Bytecode für C1-Programme sowie die
+ * virtuelle Maschine, die ihn ausführt.
+ * @details
+ * Hier ist ein Beispiel für die Übersetzung und Ausführung eines Programms:
+ * @code
+ * bytecode_t code;
+ *
+ * bytecodeInit(&code);
+ * bytecodeCompile(&code, ast);
+ * bytecodePrint(&code, stdout);
+ * bytecodeRun(&code, 1024);
+ * bytecodeRelease(&code);
+ * @endcode
+ *
+ * Jede C1-Funktion wird in eine Folge von Instruktionen übersetzt, die auf
+ * durchnummerierten virtuellen Registern arbeiten. Die ersten Register eines
+ * Rahmens entsprechen den lokalen Variablen der Funktion (Index aus
+ * symtab_symbol_t::pos, Anzahl aus syntree_node_t::function.locals), danach
+ * folgen die Register für Zwischenergebnisse. Da C1 statisch getypt ist,
+ * tragen die Register keinen Typ; die Instruktionen sind stattdessen nach
+ * Operandentyp spezialisiert.
+ *
+ * Die Aufrufkonvention legt die Argumente in aufeinanderfolgende Register
+ * des Aufrufers, die dann die Parameterregister des aufgerufenen Rahmens
+ * bilden (überlappende Registerfenster). Aufrufe werden ohne Rekursion auf
+ * dem C-Stack ausgeführt.
+ ******************************************************************************/
+
+#ifndef BYTECODE_H_INCLUDED
+#define BYTECODE_H_INCLUDED
+
+/**@brief X-Liste aller Instruktionen der virtuellen Maschine.
+ *
+ * Operanden: a ist das Zielregister, b und c sind Quellregister, k ist eine
+ * Konstante (Direktwert, Sprungziel oder Index). Die Endung \c K bezeichnet
+ * Varianten mit einem konstanten rechten Operanden.
+ * @see https://en.wikipedia.org/wiki/X_Macro
+ */
+#define BYTECODE_OP_LIST(OP) \
+	/* Datentransfer */ \
+	OP(Move)      /* a = b */ \
+	OP(LoadK)     /* a = k */ \
+	OP(GetGlobal) /* a = globals[k] */ \
+	OP(SetGlobal) /* globals[k] = b */ \
+	/* Ganzzahlarithmetik */ \
+	OP(AddInt) \
+	OP(SubInt) \
+	OP(MulInt) \
+	OP(DivInt) \
+	OP(AddIntK) \
+	OP(SubIntK) \
+	OP(MulIntK) \
+	OP(NegInt) \
+	/* Fließkommaarithmetik */ \
+	OP(AddFloat) \
+	OP(SubFloat) \
+	OP(MulFloat) \
+	OP(DivFloat) \
+	OP(NegFloat) \
+	OP(IntToFloat) \
+	/* Vergleiche */ \
+	OP(EqInt) \
+	OP(NeInt) \
+	OP(LeInt) \
+	OP(GeInt) \
+	OP(LtInt) \
+	OP(GtInt) \
+	OP(EqIntK) \
+	OP(NeIntK) \
+	OP(LeIntK) \
+	OP(GeIntK) \
+	OP(LtIntK) \
+	OP(GtIntK) \
+	OP(EqFloat) \
+	OP(NeFloat) \
+	OP(LeFloat) \
+	OP(GeFloat) \
+	OP(LtFloat) \
+	OP(GtFloat) \
+	/* Kontrollfluss */ \
+	OP(Jump)      /* pc = k */ \
+	OP(JumpFalse) /* if (!b) pc = k */ \
+	OP(JumpTrue)  /* if (b) pc = k */ \
+	OP(Call)      /* a = funcs[k](b, b+1, ...) */ \
+	OP(Return)    /* return b */ \
+	OP(ReturnVoid) \
+	/* Ausgabe */ \
+	OP(PrintInt) \
+	OP(PrintFloat) \
+	OP(PrintBool) \
+	OP(PrintString) /* puts(strings[k]) */ \
+	OP(PrintVoid)
+
+/* *** includes ************************************************************* */
+
+#include <stdio.h>
+#include "syntree.h"
+
+/* *** structures *********************************************************** */
+
+#define OP(NAME) BYTECODE_OP_ ## NAME,
+
+/**@brief Enumeration aller Instruktionen.
+ */
+typedef enum bytecode_op_e
+{
+	BYTECODE_OP_LIST(OP)
+} bytecode_op;
+
+#undef OP
+
+/**@brief Inhalt eines Registers.
+ * @note Der Typ ist statisch bekannt und wird nicht mitgeführt.
+ */
+typedef union bytecode_value_u
+{
+	int boolean;  /**<@brief Boolescher Wert. */
+	int integer;  /**<@brief Ganzzahliger Wert. */
+	float real;   /**<@brief Fließkommawert. */
+} bytecode_value_t;
+
+/**@brief Eine Instruktion der virtuellen Maschine.
+ */
+typedef struct bytecode_instr_s
+{
+	unsigned short op; /**<@brief Opcode (bytecode_op). */
+	unsigned short a;  /**<@brief Zielregister. */
+	unsigned short b;  /**<@brief Erstes Quellregister. */
+	unsigned short c;  /**<@brief Zweites Quellregister. */
+	bytecode_value_t k; /**<@brief Konstante, Sprungziel oder Index. */
+} bytecode_instr_t;
+
+/**@brief Übersetzte Funktion.
+ */
+typedef struct bytecode_func_s
+{
+	bytecode_instr_t* code; /**<@brief Instruktionsstack. */
+	syntree_nid node;       /**<@brief Knoten-ID der Funktion im Syntaxbaum. */
+	unsigned int locals;    /**<@brief Anzahl der Variablenregister. */
+	unsigned int frame;     /**<@brief Anzahl aller Register im Rahmen. */
+} bytecode_func_t;
+
+/**@brief Übersetztes Programm.
+ * @note Die Funktion mit dem Index 0 initialisiert die globalen Variablen und
+ * ruft main() auf; mit ihr beginnt die Ausführung.
+ */
+typedef struct bytecode_s
+{
+	bytecode_func_t* funcs; /**<@brief Stack der übersetzten Funktionen. */
+	const char** strings;   /**<@brief Stack der Zeichenkettenkonstanten. */
+	unsigned int globals;   /**<@brief Anzahl der globalen Variablen. */
+} bytecode_t;
+
+/* *** interface ************************************************************ */
+
+/**@brief Initialisiert ein leeres Bytecodeprogramm.
+ * @param self  das Programm
+ * @return 0, falls keine Fehler bei der Initialisierung aufgetreten sind\n
+ *      != 0 ansonsten
+ */
+extern int
+bytecodeInit(bytecode_t* self);
+
+/**@brief Gibt ein Bytecodeprogramm und alle assoziierten Strukturen frei.
+ * @param self  das Programm
+ * @note Die Zeichenkettenkonstanten gehören weiterhin dem Syntaxbaum.
+ */
+extern void
+bytecodeRelease(bytecode_t* self);
+
+/**@brief Übersetzt einen vollständig geparsten Syntaxbaum in Bytecode.
+ *
+ * Es werden nur Funktionen übersetzt, die von main() aus erreichbar sind.
+ *
+ * @param self  das (leere) Programm
+ * @param tree  der Syntaxbaum
+ */
+extern void
+bytecodeCompile(bytecode_t* self, const syntree_t* tree);
+
+/**@brief Führt ein übersetztes Programm aus.
+ * @param self  das Programm
+ * @param size  Größe des Register- und Aufrufstacks in MiB; wird sie
+ *              überschritten, endet das Programm mit \c QUOTA_EXIT_STACK
+ * @return 0, falls das Programm regulär beendet wurde\n
+ *      != 0 ansonsten
+ */
+extern int
+bytecodeRun(const bytecode_t* self, size_t size);
+
+/**@brief Gibt den Bytecode aller Funktionen in lesbarer Form aus.
+ * @param self  das Programm
+ * @param out   der Ausgabestrom
+ */
+extern void
+bytecodePrint(const bytecode_t* self, FILE* out);
+
+/* *** external variables *************************************************** */
+
+/**@brief Konstantes Array, das von Opcodes auf Strings abbildet.
+ */
+extern const char* const
+bytecodeOpName[];
+
+#endif /* BYTECODE_H_INCLUDED */
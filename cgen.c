@@ -0,0 +1,654 @@
+/***************************************************************************//**
+ * @file cgen.c
+ * @author Dorian Weber und die Studenten
+ * @brief Implementation des C-Backends.
+ ******************************************************************************/
+
+#include "cgen.h"
+#include "minako.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+
+/* ******************************************************* private structures */
+
+/**@brief Zustand des Codegenerators.
+ */
+typedef struct cgen_emitter_s
+{
+	const syntree_t* tree; /**<@brief Der übersetzte Syntaxbaum. */
+	FILE* out;             /**<@brief Ausgabestrom. */
+	int* params;           /**<@brief Knoten-ID -> Parameteranzahl oder -1. */
+	unsigned int indent;   /**<@brief Aktuelle Einrücktiefe. */
+	unsigned int temps;    /**<@brief Zuletzt vergebene Hilfsvariable. */
+} cgen_emitter_t;
+
+/* ******************************************************** private functions */
+
+/**@brief Gibt den Zeiger auf einen Knoten der entsprechenden ID zurück.
+ */
+static inline const syntree_node_t*
+nodePtr(const cgen_emitter_t* e, syntree_nid id)
+{
+	return syntreeNodePtr(e->tree, id);
+}
+
+/**@brief Gibt die ID des Folgeknotens eines Knotens zurück.
+ */
+static inline syntree_nid
+nodeNext(const cgen_emitter_t* e, syntree_nid id)
+{
+	return nodePtr(e, id)->next;
+}
+
+/**@brief Gibt die Einrückung der aktuellen Zeile aus.
+ */
+static void
+indent(const cgen_emitter_t* e)
+{
+	unsigned int i;
+
+	for (i = 0; i < e->indent; ++i)
+		putc('\t', e->out);
+}
+
+/**@brief Gibt das Feld der Vereinigung zu einem Typ zurück.
+ */
+static inline const char*
+field(syntree_node_type type)
+{
+	return (type == SYNTREE_TYPE_Float) ? "f" : "i";
+}
+
+/**@brief Gibt eine Zeichenkette als C-Literal aus.
+ */
+static void
+emitString(FILE* out, const char* str)
+{
+	putc('"', out);
+
+	for (; *str != '\0'; ++str)
+	{
+		if (*str == '"' || *str == '\\')
+			fprintf(out, "\\%c", *str);
+		else if (*str >= ' ' && *str <= '~')
+			putc(*str, out);
+		else
+			fprintf(out, "\\%03o", (unsigned char) *str);
+	}
+
+	putc('"', out);
+}
+
+/**@brief Prüft, ob ein Ausdruck einen Aufruf oder eine Zuweisung enthält.
+ */
+static int
+effects(const cgen_emitter_t* e, syntree_nid id)
+{
+	const syntree_node_t* node = nodePtr(e, id);
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Call:
+	case SYNTREE_TAG_Assign:
+		return 1;
+
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+		return 0;
+
+	default:
+		for (id = node->value.container.first; id != 0; id = nodeNext(e, id))
+			if (effects(e, id))
+				return 1;
+
+		return 0;
+	}
+}
+
+/**@brief Prüft, ob die Auswertungsreihenfolge einer Operandenliste durch
+ * Hilfsvariablen festgelegt werden muss.
+ * @note C legt die Reihenfolge von Argumenten und Operanden nicht fest, der
+ * Interpreter wertet sie von links nach rechts aus.
+ * @return die Anzahl der benötigten Hilfsvariablen oder 0
+ */
+static unsigned int
+ordered(const cgen_emitter_t* e, syntree_nid id)
+{
+	unsigned int count = 0;
+	int res = 0;
+
+	for (; id != 0; id = nodeNext(e, id), ++count)
+		res = res || effects(e, id);
+
+	return (res && count > 1) ? count : 0;
+}
+
+/**@brief Prüft, ob ein Knoten ein binärer Operator mit nicht festgelegter
+ * Auswertungsreihenfolge ist.
+ */
+static int
+unsequenced(const syntree_node_t* node)
+{
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Plus:
+	case SYNTREE_TAG_Minus:
+	case SYNTREE_TAG_Times:
+	case SYNTREE_TAG_Divide:
+	case SYNTREE_TAG_Eqt:
+	case SYNTREE_TAG_Neq:
+	case SYNTREE_TAG_Leq:
+	case SYNTREE_TAG_Geq:
+	case SYNTREE_TAG_Lst:
+	case SYNTREE_TAG_Grt:
+		return 1;
+
+	default:
+		return 0;
+	}
+}
+
+/**@brief Zählt die Hilfsvariablen, die ein Teilbaum benötigt.
+ */
+static unsigned int
+countTemps(const cgen_emitter_t* e, syntree_nid id)
+{
+	const syntree_node_t* node = nodePtr(e, id);
+	unsigned int count = 0;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+	case SYNTREE_TAG_Function:
+		return 0;
+
+	case SYNTREE_TAG_Call:
+		/* nur die Argumente, der letzte Kindknoten ist die Funktion */
+		id = nodePtr(e, node->value.container.first)->value.container.first;
+		count = ordered(e, id);
+		break;
+
+	default:
+		id = node->value.container.first;
+
+		if (unsequenced(node))
+			count = ordered(e, id);
+	}
+
+	for (; id != 0; id = nodeNext(e, id))
+		count += countTemps(e, id);
+
+	return count;
+}
+
+static void
+genExpr(cgen_emitter_t* e, syntree_nid id);
+
+/**@brief Wertet eine Operandenliste von links nach rechts in die
+ * Hilfsvariablen <tt>t</tt><em>base + 1</em> bis <tt>t</tt><em>base + n</em>
+ * aus; jeder Wert wird von einem Komma gefolgt.
+ */
+static void
+genTemps(cgen_emitter_t* e, syntree_nid id, unsigned int base)
+{
+	for (; id != 0; id = nodeNext(e, id))
+	{
+		fprintf(e->out, "t%u.%s = ", ++base, field(nodePtr(e, id)->type));
+		genExpr(e, id);
+		fputs(", ", e->out);
+	}
+}
+
+/**@brief Gibt den C-Operator eines binären Knotens zurück.
+ */
+static const char*
+binaryOp(syntree_node_tag tag)
+{
+	switch (tag)
+	{
+	case SYNTREE_TAG_Plus:   return "+";
+	case SYNTREE_TAG_Minus:  return "-";
+	case SYNTREE_TAG_Times:  return "*";
+	case SYNTREE_TAG_Divide: return "/";
+	case SYNTREE_TAG_Eqt:    return "==";
+	case SYNTREE_TAG_Neq:    return "!=";
+	case SYNTREE_TAG_Leq:    return "<=";
+	case SYNTREE_TAG_Geq:    return ">=";
+	case SYNTREE_TAG_Lst:    return "<";
+	case SYNTREE_TAG_Grt:    return ">";
+	case SYNTREE_TAG_LogOr:  return "||";
+	case SYNTREE_TAG_LogAnd: return "&&";
+	default:
+		assert(!"unexpected binary operator");
+		return "?";
+	}
+}
+
+/**@brief Erzeugt einen Funktionsaufruf (als Vereinigung).
+ */
+static void
+genCall(cgen_emitter_t* e, syntree_nid func, syntree_nid args)
+{
+	unsigned int count = ordered(e, args);
+	unsigned int base = e->temps;
+
+	if (count > 0)
+	{
+		e->temps += count;
+		putc('(', e->out);
+		genTemps(e, args, base);
+		fprintf(e->out, "f%u(", func);
+
+		for (; count > 0; --count)
+			fprintf(e->out, (count > 1) ? "t%u, " : "t%u", ++base);
+
+		fputs("))", e->out);
+		return;
+	}
+
+	fprintf(e->out, "f%u(", func);
+
+	for (; args != 0; args = nodeNext(e, args))
+	{
+		fprintf(e->out, "(v) { .%s = ", field(nodePtr(e, args)->type));
+		genExpr(e, args);
+		fputs(nodeNext(e, args) ? " }, " : " }", e->out);
+	}
+
+	putc(')', e->out);
+}
+
+/**@brief Erzeugt einen Ausdruck.
+ */
+static void
+genExpr(cgen_emitter_t* e, syntree_nid id)
+{
+	const syntree_node_t* node = nodePtr(e, id);
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Boolean:
+		fprintf(e->out, "%i", node->value.integer);
+		break;
+
+	case SYNTREE_TAG_Float:
+		/* gefaltete Divisionen durch 0 haben kein Literal */
+		if (isnan(node->value.real))
+			fputs("(0.0f / 0.0f)", e->out);
+		else if (isinf(node->value.real))
+			fputs((node->value.real < 0) ? "(-1.0f / 0.0f)" : "(1.0f / 0.0f)", e->out);
+		/* hexadezimale Darstellung ist exakt */
+		else
+			fprintf(e->out, "%af", (double) node->value.real);
+		break;
+
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+		fprintf(e->out, "%c%i.%s", (node->tag == SYNTREE_TAG_GlobVar) ? 'g' : 'l',
+		        node->value.variable, field(node->type));
+		break;
+
+	case SYNTREE_TAG_Call:
+		genCall(e, node->value.container.last,
+		        nodePtr(e, node->value.container.first)->value.container.first);
+
+		if (node->type != SYNTREE_TYPE_Void)
+			fprintf(e->out, ".%s", field(node->type));
+
+		break;
+
+	case SYNTREE_TAG_Assign:
+		putc('(', e->out);
+		genExpr(e, node->value.container.first);
+		fputs(" = ", e->out);
+		genExpr(e, node->value.container.last);
+		putc(')', e->out);
+		break;
+
+	case SYNTREE_TAG_Cast:
+		fputs("(float) ", e->out);
+		genExpr(e, node->value.container.first);
+		break;
+
+	case SYNTREE_TAG_Uminus:
+		fputs("(-", e->out);
+		genExpr(e, node->value.container.first);
+		putc(')', e->out);
+		break;
+
+	default:
+		if (unsequenced(node) && ordered(e, node->value.container.first))
+		{
+			unsigned int base = e->temps;
+
+			e->temps += 2;
+			putc('(', e->out);
+			genTemps(e, node->value.container.first, base);
+			fprintf(e->out, "t%u.%s %s t%u.%s)",
+			        base + 1, field(nodePtr(e, node->value.container.first)->type),
+			        binaryOp(node->tag),
+			        base + 2, field(nodePtr(e, node->value.container.last)->type));
+			break;
+		}
+
+		putc('(', e->out);
+		genExpr(e, node->value.container.first);
+		fprintf(e->out, " %s ", binaryOp(node->tag));
+		genExpr(e, node->value.container.last);
+		putc(')', e->out);
+	}
+}
+
+/**@brief Erzeugt eine Ausgabeanweisung.
+ */
+static void
+genPrint(cgen_emitter_t* e, const syntree_node_t* node)
+{
+	const syntree_node_t* arg = nodePtr(e, node->value.container.first);
+
+	switch (arg->tag == SYNTREE_TAG_String ? SYNTREE_TYPE_String : arg->type)
+	{
+	case SYNTREE_TYPE_Boolean:
+		fputs("puts(", e->out);
+		genExpr(e, node->value.container.first);
+		fputs(" ? \"true\" : \"false\");\n", e->out);
+		break;
+
+	case SYNTREE_TYPE_Integer:
+		fputs("printf(\"%i\\n\", ", e->out);
+		genExpr(e, node->value.container.first);
+		fputs(");\n", e->out);
+		break;
+
+	case SYNTREE_TYPE_Float:
+		fputs("printf(\"%g\\n\", (double) ", e->out);
+		genExpr(e, node->value.container.first);
+		fputs(");\n", e->out);
+		break;
+
+	case SYNTREE_TYPE_String:
+		fputs("puts(", e->out);
+		emitString(e->out, arg->value.string);
+		fputs(");\n", e->out);
+		break;
+
+	default:
+		genExpr(e, node->value.container.first);
+		fputs(";\n", e->out);
+		indent(e);
+		fputs("putc('\\n', stdout);\n", e->out);
+	}
+}
+
+static void
+genStmt(cgen_emitter_t* e, syntree_nid id);
+
+/**@brief Erzeugt den Rumpf einer Verzweigung oder Schleife; Blöcke werden
+ * nicht zusätzlich eingerückt.
+ */
+static void
+genBody(cgen_emitter_t* e, syntree_nid id)
+{
+	int nested = (nodePtr(e, id)->tag != SYNTREE_TAG_Sequence);
+
+	e->indent += nested;
+	genStmt(e, id);
+	e->indent -= nested;
+}
+
+/**@brief Erzeugt eine Anweisung.
+ */
+static void
+genStmt(cgen_emitter_t* e, syntree_nid id)
+{
+	const syntree_node_t* node = nodePtr(e, id);
+	syntree_nid init, cond, step, body;
+
+	indent(e);
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Sequence:
+		fputs("{\n", e->out);
+		++e->indent;
+
+		for (id = node->value.container.first; id != 0; id = nodeNext(e, id))
+			genStmt(e, id);
+
+		--e->indent;
+		indent(e);
+		fputs("}\n", e->out);
+		break;
+
+	case SYNTREE_TAG_Function:
+		/* Aufruf der Hauptfunktion im Programmkörper */
+		fprintf(e->out, "f%u();\n", id);
+		break;
+
+	case SYNTREE_TAG_If:
+		cond = node->value.container.first;
+		body = nodeNext(e, cond);
+
+		fputs("if (", e->out);
+		genExpr(e, cond);
+		fputs(")\n", e->out);
+		genBody(e, body);
+
+		if (nodeNext(e, body) != 0)
+		{
+			indent(e);
+			fputs("else\n", e->out);
+			genBody(e, nodeNext(e, body));
+		}
+
+		break;
+
+	case SYNTREE_TAG_For:
+		init = node->value.container.first;
+		cond = nodeNext(e, init);
+		step = nodeNext(e, cond);
+		body = nodeNext(e, step);
+
+		fputs("for (", e->out);
+		genExpr(e, init);
+		fputs("; ", e->out);
+		genExpr(e, cond);
+		fputs("; ", e->out);
+		genExpr(e, step);
+		fputs(")\n", e->out);
+		genBody(e, body);
+		break;
+
+	case SYNTREE_TAG_While:
+		fputs("while (", e->out);
+		genExpr(e, node->value.container.first);
+		fputs(")\n", e->out);
+		genBody(e, node->value.container.last);
+		break;
+
+	case SYNTREE_TAG_DoWhile:
+		fputs("do\n", e->out);
+		genBody(e, node->value.container.last);
+		indent(e);
+		fputs("while (", e->out);
+		genExpr(e, node->value.container.first);
+		fputs(");\n", e->out);
+		break;
+
+	case SYNTREE_TAG_Print:
+		genPrint(e, node);
+		break;
+
+	case SYNTREE_TAG_Return:
+		if (node->value.container.first == 0)
+			fputs("return dummy;\n", e->out);
+		else
+		{
+			fprintf(e->out, "return (v) { .%s = ",
+			        field(nodePtr(e, node->value.container.first)->type));
+			genExpr(e, node->value.container.first);
+			fputs(" };\n", e->out);
+		}
+
+		break;
+
+	default:
+		/* Ausdrucksanweisungen (Zuweisungen und Aufrufe) */
+		genExpr(e, id);
+		fputs(";\n", e->out);
+	}
+}
+
+/**@brief Gibt den Kopf einer Funktion aus.
+ */
+static void
+genSignature(cgen_emitter_t* e, syntree_nid id, int names)
+{
+	int i;
+
+	fprintf(e->out, "static v\nf%u(", id);
+
+	for (i = 0; i < e->params[id]; ++i)
+	{
+		fputs(i ? ", v" : "v", e->out);
+
+		if (names)
+			fprintf(e->out, " l%i", i);
+	}
+
+	fputs(i ? ")" : "void)", e->out);
+}
+
+/**@brief Deklariert die Hilfsvariablen einer Anweisung.
+ */
+static void
+genTempDecls(cgen_emitter_t* e, syntree_nid id)
+{
+	unsigned int i, count = countTemps(e, id);
+
+	for (i = 1; i <= count; ++i)
+		fprintf(e->out, "\tv t%u;\n", i);
+
+	e->temps = 0;
+}
+
+/**@brief Übersetzt eine Funktion.
+ */
+static void
+genFunction(cgen_emitter_t* e, syntree_nid id)
+{
+	const syntree_node_t* node = nodePtr(e, id);
+	unsigned int i;
+
+	putc('\n', e->out);
+	genSignature(e, id, 1);
+	fputs("\n{\n", e->out);
+
+	/* übrige Variablen sind wie im Interpreter vorbelegt */
+	for (i = e->params[id]; i < node->value.function.locals; ++i)
+		fprintf(e->out, "\tv l%u = { %i };\n", i, DUMMY);
+
+	genTempDecls(e, node->value.function.body);
+	e->indent = 1;
+	genStmt(e, node->value.function.body);
+	fputs("\treturn dummy;\n}\n", e->out);
+}
+
+/* ********************************************************* public functions */
+
+void
+cgenEmit(const syntree_t* self, FILE* out)
+{
+	const syntree_node_t* prog = syntreeNodePtr(self, 0);
+	const syntree_node_t* node;
+	cgen_emitter_t e;
+	syntree_nid id, arg;
+	int count;
+	unsigned int i;
+
+	e.tree = self;
+	e.out = out;
+	e.indent = 0;
+	e.temps = 0;
+	e.params = malloc(self->len * sizeof(*e.params));
+
+	if (e.params == NULL)
+	{
+		fputs("out-of-memory error\n", stderr);
+		exit(-1);
+	}
+
+	/* ermittle die Parameteranzahl aller aufgerufenen Funktionen */
+	for (id = 0; id < self->len; ++id)
+		e.params[id] = -1;
+
+	for (id = nodePtr(&e, prog->value.program.body)->value.container.first;
+	     id != 0; id = nodeNext(&e, id))
+		if (nodePtr(&e, id)->tag == SYNTREE_TAG_Function)
+			e.params[id] = 0;
+
+	for (id = 1; id < self->len; ++id)
+	{
+		node = nodePtr(&e, id);
+
+		if (node->tag != SYNTREE_TAG_Call)
+			continue;
+
+		count = 0;
+
+		for (arg = nodePtr(&e, node->value.container.first)->value.container.first;
+		     arg != 0; arg = nodeNext(&e, arg))
+			++count;
+
+		e.params[node->value.container.last] = count;
+	}
+
+	fputs("#include <stdio.h>\n\n"
+	      "typedef union { int i; float f; } v;\n\n"
+	      "static const v dummy = { -1 };\n", out);
+
+	/* globale Variablen */
+	if (prog->value.program.globals > 0)
+		putc('\n', out);
+
+	for (i = 0; i < prog->value.program.globals; ++i)
+		fprintf(out, "static v g%u = { %i };\n", i, DUMMY);
+
+	/* Prototypen und Funktionen */
+	putc('\n', out);
+
+	for (id = 1; id < self->len; ++id)
+		if (e.params[id] >= 0)
+		{
+			genSignature(&e, id, 0);
+			fputs(";\n", out);
+		}
+
+	for (id = 1; id < self->len; ++id)
+		if (e.params[id] >= 0)
+			genFunction(&e, id);
+
+	/* Einstiegspunkt: globale Initialisierungen und Aufruf von main() */
+	fputs("\nint\nmain(void)\n{\n", out);
+	genTempDecls(&e, prog->value.program.body);
+	e.indent = 1;
+
+	for (id = nodePtr(&e, prog->value.program.body)->value.container.first;
+	     id != 0; id = nodeNext(&e, id))
+		genStmt(&e, id);
+
+	fputs("\treturn 0;\n}\n", out);
+	free(e.params);
+}
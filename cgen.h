@@ -0,0 +1,41 @@
+/***************************************************************************//**
+ * @file cgen.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält ein Backend, das C1-Programme in äquivalenten C99-Quelltext
+ * übersetzt.
+ * @details
+ * Hier ist ein Beispiel für die Benutzung:
+ * @code
+ * cgenEmit(ast, stdout);
+ * @endcode
+ *
+ * Jeder Variablenplatz wird zu einer benannten C-Variable (\c g0, \c g1, ...
+ * für globale, \c l0, \c l1, ... für lokale Variablen). Da sich Geschwister-
+ * blöcke Plätze unterschiedlichen Typs teilen können, sind die Variablen wie
+ * im Interpreter Vereinigungen aus Ganzzahl- und Fließkommawert und wie dort
+ * mit \c DUMMY vorbelegt. Die Parameteranzahl einer Funktion ergibt sich aus
+ * ihren Aufrufen; nie aufgerufene Funktionen werden nicht ausgegeben.
+ * Haben Argumente oder Operanden Nebeneffekte, werden sie der Reihe nach in
+ * Hilfsvariablen (\c t1, \c t2, ...) ausgewertet, da C die
+ * Auswertungsreihenfolge im Gegensatz zum Interpreter nicht festlegt.
+ * Die Ausgaben entsprechen exakt denen von execPrint().
+ ******************************************************************************/
+
+#ifndef CGEN_H_INCLUDED
+#define CGEN_H_INCLUDED
+
+/* *** includes ************************************************************* */
+
+#include <stdio.h>
+#include "syntree.h"
+
+/* *** interface ************************************************************ */
+
+/**@brief Übersetzt einen Syntaxbaum in C99-Quelltext.
+ * @param self  der Syntaxbaum (mit den ursprünglichen Knotenarten)
+ * @param out   Ausgabestrom für den Quelltext
+ */
+extern void
+cgenEmit(const syntree_t* self, FILE* out);
+
+#endif /* CGEN_H_INCLUDED */
@@ -0,0 +1,728 @@
+/***************************************************************************//**
+ * @file closure.c
+ * @author Dorian Weber und die Studenten
+ * @brief Implementation der Closure-Ausführungsstufe.
+ ******************************************************************************/
+
+#include "closure.h"
+#include "stack.h"
+#include "quicken.h"
+#include "quota.h"
+#include "vmstack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/**@brief Anzahl der Closures, die gemeinsam alloziert werden.
+ */
+#define CLOSURE_BLOCK_SIZE 256
+
+/* ****************************************************************** globals */
+
+/**@brief Zeiger auf den Zustand der virtuellen Maschine während der
+ * Ausführung.
+ */
+static minako_vm_t* vm;
+
+/**@brief Syntaxbaum, dessen Literale die Zeichenkettenkonstanten enthalten.
+ */
+static const syntree_t* strings;
+
+/**@brief Ziel eines ausstehenden Endaufrufs oder \c NULL (siehe tailcall.h).
+ */
+static const closure_t* pending;
+
+/* ******************************************************** private functions */
+
+/* Handler: Literale und Variablen */
+
+static minako_data_t
+closConst(const closure_t* self)
+{
+	return self->k;
+}
+
+static minako_data_t
+closLocVar(const closure_t* self)
+{
+	return vm->ebp[self->k.integer];
+}
+
+static minako_data_t
+closGlobVar(const closure_t* self)
+{
+	return vm->stack[self->k.integer];
+}
+
+/* Handler: Ausdrücke */
+
+/**@brief Definiert einen Handler für eine binäre Operation.
+ * @param NAME   Name des Handlers
+ * @param FIELD  Feld der Operanden
+ * @param OP     C-Operator
+ * @param RES    Feld des Ergebnisses
+ */
+#define BINARY(NAME, FIELD, OP, RES) \
+	static minako_data_t \
+	clos ## NAME(const closure_t* self) \
+	{ \
+		minako_data_t lhs = self->a->fn(self->a); \
+		minako_data_t rhs = self->b->fn(self->b); \
+		minako_data_t res; \
+		res.RES = lhs.FIELD OP rhs.FIELD; \
+		return res; \
+	}
+
+BINARY(PlusInt,     integer, +,  integer)
+BINARY(MinusInt,    integer, -,  integer)
+BINARY(TimesInt,    integer, *,  integer)
+BINARY(DivideInt,   integer, /,  integer)
+BINARY(PlusFloat,   real,    +,  real)
+BINARY(MinusFloat,  real,    -,  real)
+BINARY(TimesFloat,  real,    *,  real)
+BINARY(DivideFloat, real,    /,  real)
+BINARY(EqtInt,      integer, ==, boolean)
+BINARY(NeqInt,      integer, !=, boolean)
+BINARY(LeqInt,      integer, <=, boolean)
+BINARY(GeqInt,      integer, >=, boolean)
+BINARY(LstInt,      integer, <,  boolean)
+BINARY(GrtInt,      integer, >,  boolean)
+BINARY(EqtFloat,    real,    ==, boolean)
+BINARY(NeqFloat,    real,    !=, boolean)
+BINARY(LeqFloat,    real,    <=, boolean)
+BINARY(GeqFloat,    real,    >=, boolean)
+BINARY(LstFloat,    real,    <,  boolean)
+BINARY(GrtFloat,    real,    >,  boolean)
+
+#undef BINARY
+
+static minako_data_t
+closLogOr(const closure_t* self)
+{
+	minako_data_t lhs = self->a->fn(self->a);
+	return lhs.boolean ? lhs : self->b->fn(self->b);
+}
+
+static minako_data_t
+closLogAnd(const closure_t* self)
+{
+	minako_data_t lhs = self->a->fn(self->a);
+	return !lhs.boolean ? lhs : self->b->fn(self->b);
+}
+
+static minako_data_t
+closUminusInt(const closure_t* self)
+{
+	minako_data_t res = self->a->fn(self->a);
+	res.integer = -res.integer;
+	return res;
+}
+
+static minako_data_t
+closUminusFloat(const closure_t* self)
+{
+	minako_data_t res = self->a->fn(self->a);
+	res.real = -res.real;
+	return res;
+}
+
+static minako_data_t
+closCast(const closure_t* self)
+{
+	minako_data_t res = self->a->fn(self->a);
+	res.real = res.integer;
+	return res;
+}
+
+static minako_data_t
+closAssignLocal(const closure_t* self)
+{
+	minako_data_t res = self->a->fn(self->a);
+
+	vm->ebp[self->k.integer] = res;
+	return res;
+}
+
+static minako_data_t
+closAssignGlobal(const closure_t* self)
+{
+	minako_data_t res = self->a->fn(self->a);
+
+	vm->stack[self->k.integer] = res;
+	return res;
+}
+
+static minako_data_t
+closCall(const closure_t* self)
+{
+	const closure_t* func = self->b;
+	const closure_t* arg;
+	minako_data_t* params = vm->esp;
+	minako_data_t* old_ebp = vm->ebp;
+	minako_data_t res;
+	unsigned int i;
+
+	/* werte die Argumente oberhalb des neuen Rahmens aus */
+	vm->esp += self->n;
+
+	for (arg = self->a, i = 0; arg != NULL; arg = arg->next, ++i)
+		params[i] = arg->fn(arg);
+
+	vm->esp = params;
+	res = func->fn(func);
+
+	vm->esp = vm->ebp;
+	vm->ebp = old_ebp;
+	return res;
+}
+
+static minako_data_t
+closTailCall(const closure_t* self)
+{
+	const closure_t* arg;
+	minako_data_t* args = vm->esp;
+	unsigned int i;
+
+	/* die Argumente können noch den alten Rahmen lesen */
+	vm->esp += self->n;
+
+	for (arg = self->a, i = 0; arg != NULL; arg = arg->next, ++i)
+		args[i] = arg->fn(arg);
+
+	vm->esp = args;
+	memmove(vm->ebp, args, i * sizeof(*args));
+	pending = self->b;
+	return vm->eax.value;
+}
+
+/* Handler: Anweisungen */
+
+static minako_data_t
+closProgram(const closure_t* self)
+{
+	vm->returnFlag = 0;
+	vm->ebp = vm->esp = vm->stack;
+
+	/* allocate space for global variables (pages start out as DUMMY) */
+	vm->esp += self->n;
+
+	return self->a->fn(self->a);
+}
+
+static minako_data_t
+closFunction(const closure_t* self)
+{
+	unsigned int i;
+
+	vm->ebp = vm->esp;
+	VMSTACK_PROBE();
+
+	do
+	{
+		QUOTA_BURN();
+		vm->esp = vm->ebp + self->n;
+
+		for (i = 0; i < self->m; ++i)
+			vm->ebp[self->slots[i]].integer = DUMMY;
+
+		self->a->fn(self->a);
+		vm->returnFlag = 0;
+
+		/* Endaufruf: der Rahmen enthält bereits die Argumente */
+		self = pending;
+		pending = NULL;
+	}
+	while (self != NULL);
+
+	return vm->eax.value;
+}
+
+static minako_data_t
+closSequence(const closure_t* self)
+{
+	const closure_t* stmt;
+
+	for (stmt = self->a; stmt != NULL; stmt = stmt->next)
+	{
+		stmt->fn(stmt);
+
+		if (vm->returnFlag)
+			break;
+	}
+
+	return vm->eax.value;
+}
+
+static minako_data_t
+closIf(const closure_t* self)
+{
+	if (self->a->fn(self->a).boolean)
+		self->b->fn(self->b);
+	else if (self->c != NULL)
+		self->c->fn(self->c);
+
+	return vm->eax.value;
+}
+
+static minako_data_t
+closFor(const closure_t* self)
+{
+	const closure_t *cond = self->b, *step = self->c, *body = self->d;
+
+	self->a->fn(self->a);
+
+	while (cond->fn(cond).boolean)
+	{
+		body->fn(body);
+
+		if (vm->returnFlag)
+			break;
+
+		QUOTA_BURN();
+		step->fn(step);
+	}
+
+	return vm->eax.value;
+}
+
+static minako_data_t
+closWhile(const closure_t* self)
+{
+	const closure_t *cond = self->a, *body = self->b;
+
+	while (cond->fn(cond).boolean)
+	{
+		body->fn(body);
+
+		if (vm->returnFlag)
+			break;
+
+		QUOTA_BURN();
+	}
+
+	return vm->eax.value;
+}
+
+static minako_data_t
+closDoWhile(const closure_t* self)
+{
+	const closure_t *cond = self->a, *body = self->b;
+
+	do
+	{
+		body->fn(body);
+
+		if (vm->returnFlag)
+			break;
+
+		QUOTA_BURN();
+	}
+	while (cond->fn(cond).boolean);
+
+	return vm->eax.value;
+}
+
+static minako_data_t
+closReturn(const closure_t* self)
+{
+	if (self->a != NULL)
+		vm->eax.value = self->a->fn(self->a);
+
+	vm->returnFlag = 1;
+	return vm->eax.value;
+}
+
+static minako_data_t
+closPrintInt(const closure_t* self)
+{
+	printf("%i\n", self->a->fn(self->a).integer);
+	return vm->eax.value;
+}
+
+static minako_data_t
+closPrintFloat(const closure_t* self)
+{
+	printf("%g\n", self->a->fn(self->a).real);
+	return vm->eax.value;
+}
+
+static minako_data_t
+closPrintBool(const closure_t* self)
+{
+	puts(self->a->fn(self->a).boolean ? "true" : "false");
+	return vm->eax.value;
+}
+
+static minako_data_t
+closPrintString(const closure_t* self)
+{
+	puts(syntreeNodePtr(strings, self->a->k.string)->value.string);
+	return vm->eax.value;
+}
+
+static minako_data_t
+closPrintVoid(const closure_t* self)
+{
+	self->a->fn(self->a);
+	putc('\n', stdout);
+	return vm->eax.value;
+}
+
+/* Übersetzung */
+
+/**@brief Alloziert eine leere Closure.
+ */
+static closure_t*
+closureAlloc(closure_program_t* self)
+{
+	closure_t* block;
+
+	if (stackIsEmpty(self->blocks) || self->used == CLOSURE_BLOCK_SIZE)
+	{
+		block = calloc(CLOSURE_BLOCK_SIZE, sizeof(*block));
+
+		if (block == NULL)
+		{
+			fputs("out-of-memory error\n", stderr);
+			exit(-1);
+		}
+
+		stackPush(self->blocks) = block;
+		self->used = 0;
+	}
+
+	return &stackTop(self->blocks)[self->used++];
+}
+
+/**@brief Wählt den Handler einer binären Operation.
+ * @param tag   Knotenart des Operators
+ * @param type  Typ der Operanden
+ */
+static closure_fn*
+binaryHandler(syntree_node_tag tag, syntree_node_type type)
+{
+	int isFloat = (type == SYNTREE_TYPE_Float);
+
+	switch (tag)
+	{
+	case SYNTREE_TAG_Plus:   return isFloat ? closPlusFloat   : closPlusInt;
+	case SYNTREE_TAG_Minus:  return isFloat ? closMinusFloat  : closMinusInt;
+	case SYNTREE_TAG_Times:  return isFloat ? closTimesFloat  : closTimesInt;
+	case SYNTREE_TAG_Divide: return isFloat ? closDivideFloat : closDivideInt;
+	case SYNTREE_TAG_Eqt:    return isFloat ? closEqtFloat    : closEqtInt;
+	case SYNTREE_TAG_Neq:    return isFloat ? closNeqFloat    : closNeqInt;
+	case SYNTREE_TAG_Leq:    return isFloat ? closLeqFloat    : closLeqInt;
+	case SYNTREE_TAG_Geq:    return isFloat ? closGeqFloat    : closGeqInt;
+	case SYNTREE_TAG_Lst:    return isFloat ? closLstFloat    : closLstInt;
+	case SYNTREE_TAG_Grt:    return isFloat ? closGrtFloat    : closGrtInt;
+	default:
+		assert(!"unexpected binary operator");
+		return NULL;
+	}
+}
+
+/**@brief Übersetzt einen Knoten samt aller Kindknoten in eine Closure.
+ * @param self  das Programm
+ * @param tree  der Syntaxbaum
+ * @param id    Knoten-ID oder 0 für einen fehlenden Knoten
+ * @return die Closure oder \c NULL, falls \p id 0 ist
+ */
+static const closure_t*
+compile(closure_program_t* self, const syntree_t* tree, syntree_nid id)
+{
+	const syntree_node_t* node = syntreeNodePtr(tree, id);
+	closure_t *cl, *prev, *elem;
+	syntree_nid child;
+
+	if (id == 0)
+		return NULL;
+
+	/* Funktionen werden nur einmal übersetzt (auch bei Rekursion) */
+	if (node->tag == SYNTREE_TAG_Function && self->funcs[id] != NULL)
+		return self->funcs[id];
+
+	cl = closureAlloc(self);
+	cl->type = node->type;
+
+	/* der Bauminterpreter übersetzt heiße Funktionen nach dem Quickening */
+	switch (quickenGeneric(node->tag))
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Boolean:
+		cl->fn = closConst;
+		cl->k.integer = node->value.integer;
+		break;
+
+	case SYNTREE_TAG_Float:
+		cl->fn = closConst;
+		cl->k.real = node->value.real;
+		break;
+
+	case SYNTREE_TAG_String:
+		cl->fn = closConst;
+		cl->k.string = id;
+		break;
+
+	case SYNTREE_TAG_LocVar:
+		cl->fn = closLocVar;
+		cl->k.integer = node->value.variable;
+		break;
+
+	case SYNTREE_TAG_GlobVar:
+		cl->fn = closGlobVar;
+		cl->k.integer = node->value.variable;
+		break;
+
+	case SYNTREE_TAG_Function:
+		self->funcs[id] = cl;
+		cl->fn = closFunction;
+		cl->n = node->value.function.locals;
+		cl->slots = self->defs.slots + self->defs.start[id];
+		cl->m = self->defs.start[id + 1] - self->defs.start[id];
+		cl->a = compile(self, tree, node->value.function.body);
+		break;
+
+	case SYNTREE_TAG_Call:
+		cl->fn = (node->tag == SYNTREE_TAG_TailCall) ? closTailCall : closCall;
+		cl->b = compile(self, tree, node->value.container.last);
+		cl->n = cl->b->n;
+		/* fall through */
+	case SYNTREE_TAG_Sequence:
+		if (node->tag == SYNTREE_TAG_Sequence)
+			cl->fn = closSequence;
+
+		child = (node->tag != SYNTREE_TAG_Sequence)
+		      ? syntreeNodePtr(tree, node->value.container.first)->value.container.first
+		      : node->value.container.first;
+
+		for (prev = NULL; child != 0; child = syntreeNodePtr(tree, child)->next)
+		{
+			elem = (closure_t*) compile(self, tree, child);
+
+			if (prev == NULL)
+				cl->a = elem;
+			else
+				prev->next = elem;
+
+			prev = elem;
+		}
+
+		break;
+
+	case SYNTREE_TAG_If:
+	case SYNTREE_TAG_For:
+		cl->fn = (node->tag == SYNTREE_TAG_If) ? closIf : closFor;
+		child = node->value.container.first;
+		cl->a = compile(self, tree, child);
+		child = syntreeNodePtr(tree, child)->next;
+		cl->b = compile(self, tree, child);
+		child = syntreeNodePtr(tree, child)->next;
+		cl->c = compile(self, tree, child);
+
+		if (child != 0)
+			cl->d = compile(self, tree, syntreeNodePtr(tree, child)->next);
+
+		break;
+
+	case SYNTREE_TAG_While:
+	case SYNTREE_TAG_DoWhile:
+		cl->fn = (node->tag == SYNTREE_TAG_While) ? closWhile : closDoWhile;
+		cl->a = compile(self, tree, node->value.container.first);
+		cl->b = compile(self, tree, node->value.container.last);
+		break;
+
+	case SYNTREE_TAG_Print:
+		cl->a = compile(self, tree, node->value.container.first);
+
+		switch (cl->a->type)
+		{
+		case SYNTREE_TYPE_Boolean: cl->fn = closPrintBool;   break;
+		case SYNTREE_TYPE_Integer: cl->fn = closPrintInt;    break;
+		case SYNTREE_TYPE_Float:   cl->fn = closPrintFloat;  break;
+		case SYNTREE_TYPE_String:  cl->fn = closPrintString; break;
+		default:                   cl->fn = closPrintVoid;
+		}
+
+		break;
+
+	case SYNTREE_TAG_Assign:
+		child = node->value.container.first;
+		cl->fn = syntreeNodePtr(tree, child)->tag == SYNTREE_TAG_LocVar
+		       ? closAssignLocal : closAssignGlobal;
+		cl->type = syntreeNodePtr(tree, child)->type;
+		cl->k.integer = syntreeNodePtr(tree, child)->value.variable;
+		cl->a = compile(self, tree, node->value.container.last);
+		break;
+
+	case SYNTREE_TAG_Return:
+		cl->fn = closReturn;
+		cl->a = compile(self, tree, node->value.container.first);
+		break;
+
+	case SYNTREE_TAG_Cast:
+		assert(node->type == SYNTREE_TYPE_Float);
+		cl->fn = closCast;
+		cl->a = compile(self, tree, node->value.container.first);
+		break;
+
+	case SYNTREE_TAG_Uminus:
+		cl->fn = (node->type == SYNTREE_TYPE_Float)
+		       ? closUminusFloat : closUminusInt;
+		cl->a = compile(self, tree, node->value.container.first);
+		break;
+
+	case SYNTREE_TAG_LogOr:
+	case SYNTREE_TAG_LogAnd:
+		cl->fn = (node->tag == SYNTREE_TAG_LogOr) ? closLogOr : closLogAnd;
+		cl->a = compile(self, tree, node->value.container.first);
+		cl->b = compile(self, tree, node->value.container.last);
+		break;
+
+	default:
+		cl->a = compile(self, tree, node->value.container.first);
+		cl->b = compile(self, tree, node->value.container.last);
+		cl->fn = binaryHandler(quickenGeneric(node->tag), cl->a->type);
+	}
+
+	return cl;
+}
+
+/**@brief Legt die Abbildung der Funktionsclosures an, falls nötig.
+ */
+static void
+prepare(closure_program_t* self, const syntree_t* tree)
+{
+	strings = tree;
+
+	if (self->funcs != NULL)
+		return;
+
+	self->funcs = calloc(tree->len, sizeof(*self->funcs));
+
+	if (self->funcs == NULL || definiteInit(&self->defs, tree))
+	{
+		fputs("out-of-memory error\n", stderr);
+		exit(-1);
+	}
+}
+
+/* ********************************************************* public functions */
+
+int
+closureInit(closure_program_t* self)
+{
+	if (stackInit(self->blocks))
+		return -1;
+
+	self->funcs = NULL;
+	self->defs.start = self->defs.slots = NULL;
+	self->used = 0;
+	self->root = NULL;
+	return 0;
+}
+
+void
+closureRelease(closure_program_t* self)
+{
+	while (!stackIsEmpty(self->blocks))
+		free(stackPop(self->blocks));
+
+	stackRelease(self->blocks);
+	free(self->funcs);
+	definiteRelease(&self->defs);
+}
+
+void
+closureCompile(closure_program_t* self, const syntree_t* tree)
+{
+	const syntree_node_t* program = syntreeNodePtr(tree, 0);
+	closure_t* root;
+
+	prepare(self, tree);
+
+	/* der Programmknoten hat die ID 0 und wird deshalb gesondert übersetzt */
+	root = closureAlloc(self);
+	root->fn = closProgram;
+	root->n = program->value.program.globals;
+	root->a = compile(self, tree, program->value.program.body);
+	self->root = root;
+}
+
+void
+closureRun(const closure_program_t* self, minako_vm_t* state)
+{
+	vm = state;
+	self->root->fn(self->root);
+}
+
+const closure_t*
+closureCompileFunction(closure_program_t* self, const syntree_t* tree,
+                       syntree_nid id)
+{
+	assert(syntreeNodePtr(tree, id)->tag == SYNTREE_TAG_Function);
+
+	prepare(self, tree);
+	return compile(self, tree, id);
+}
+
+minako_data_t
+closureInvoke(const closure_t* func, minako_vm_t* state)
+{
+	vm = state;
+	return func->fn(func);
+}
+
+const closure_t*
+closureCompileLoop(closure_program_t* self, const syntree_t* tree,
+                   syntree_nid id)
+{
+	assert(syntreeNodePtr(tree, id)->tag == SYNTREE_TAG_For
+	    || syntreeNodePtr(tree, id)->tag == SYNTREE_TAG_While
+	    || syntreeNodePtr(tree, id)->tag == SYNTREE_TAG_DoWhile);
+
+	prepare(self, tree);
+	return compile(self, tree, id);
+}
+
+void
+closureResume(const closure_t* loop, minako_vm_t* state)
+{
+	const closure_t *cond, *step, *body;
+
+	vm = state;
+
+	/* der Rumpf wurde gerade ausgeführt, es folgen (Schritt und) Bedingung */
+	if (loop->fn == closFor)
+	{
+		cond = loop->b, step = loop->c, body = loop->d;
+		step->fn(step);
+	}
+	else
+		cond = loop->a, step = NULL, body = loop->b;
+
+	while (cond->fn(cond).boolean)
+	{
+		body->fn(body);
+
+		if (vm->returnFlag)
+			break;
+
+		QUOTA_BURN();
+
+		if (step != NULL)
+			step->fn(step);
+	}
+
+	/* ein Endaufruf in der Schleife wird hier als gewöhnlicher Aufruf auf dem
+	 * Rahmen der interpretierten Funktion ausgeführt */
+	if (pending != NULL)
+	{
+		loop = pending;
+		pending = NULL;
+		vm->returnFlag = 0;
+		vm->esp = vm->ebp;
+		vm->eax.value = loop->fn(loop);
+		vm->returnFlag = 1;
+	}
+}
@@ -0,0 +1,146 @@
+/***************************************************************************//**
+ * @file closure.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält eine Ausführungsstufe, die den Syntaxbaum einmalig in einen
+ * Baum vorgebundener Closures übersetzt.
+ * @details
+ * Hier ist ein Beispiel für die Übersetzung und Ausführung eines Programms:
+ * @code
+ * closure_program_t prog;
+ *
+ * closureInit(&prog);
+ * closureCompile(&prog, ast);
+ * closureRun(&prog, vm);
+ * closureRelease(&prog);
+ * @endcode
+ *
+ * Jeder Knoten des Syntaxbaumes wird zu einer Closure, die einen direkten
+ * Zeiger auf eine nach Knotenart und Typ spezialisierte Handlerfunktion,
+ * bereits aufgelöste Zeiger auf ihre Kinder und bereits dekodierte Operanden
+ * (Variablenindex, Konstante) enthält. Die Ausführung besteht damit nur noch
+ * aus indirekten Funktionsaufrufen, ohne Übersetzung von Knoten-IDs in Zeiger
+ * und ohne Nachschlagen in der Dispatchtabelle. Die Closures arbeiten auf dem
+ * gleichen Variablenstack wie der Bauminterpreter.
+ ******************************************************************************/
+
+#ifndef CLOSURE_H_INCLUDED
+#define CLOSURE_H_INCLUDED
+
+/* *** includes ************************************************************* */
+
+#include "syntree.h"
+#include "minako.h"
+#include "definite.h"
+
+/* *** structures *********************************************************** */
+
+struct closure_s;
+
+/**@brief Prototyp der Handlerfunktionen.
+ * @param self  die auszuführende Closure
+ * @return das Ergebnis bei Ausdrücken, ansonsten undefiniert
+ */
+typedef minako_data_t closure_fn(const struct closure_s* self);
+
+/**@brief Ein vorgebundener Knoten.
+ */
+typedef struct closure_s
+{
+	closure_fn* fn;               /**<@brief Handlerfunktion. */
+	const struct closure_s* a;    /**<@brief Erstes Kind. */
+	const struct closure_s* b;    /**<@brief Zweites Kind. */
+	const struct closure_s* c;    /**<@brief Drittes Kind. */
+	const struct closure_s* d;    /**<@brief Viertes Kind. */
+	const struct closure_s* next; /**<@brief Nächste Anweisung (Sequenzen). */
+	minako_data_t k;              /**<@brief Konstante oder Variablenindex. */
+	unsigned int n;               /**<@brief Variablenanzahl (Funktionen). */
+	const unsigned int* slots;    /**<@brief Vorzubelegende Plätze (Funktionen). */
+	unsigned int m;               /**<@brief Anzahl der Plätze in \c slots. */
+	syntree_node_type type;       /**<@brief Ergebnistyp. */
+} closure_t;
+
+/**@brief Ein übersetztes Programm.
+ */
+typedef struct closure_program_s
+{
+	closure_t** blocks;  /**<@brief Stack der allozierten Closureblöcke. */
+	closure_t** funcs;   /**<@brief Abbildung Knoten-ID -> Funktionsclosure. */
+	unsigned int used;   /**<@brief Belegte Closures im letzten Block. */
+	const closure_t* root; /**<@brief Closure des Programmknotens. */
+	definite_t defs;     /**<@brief Uninitialisiert lesbare Plätze. */
+} closure_program_t;
+
+/* *** interface ************************************************************ */
+
+/**@brief Initialisiert ein leeres Closureprogramm.
+ * @param self  das Programm
+ * @return 0, falls keine Fehler bei der Initialisierung aufgetreten sind\n
+ *      != 0 ansonsten
+ */
+extern int
+closureInit(closure_program_t* self);
+
+/**@brief Gibt ein Closureprogramm und alle Closures frei.
+ * @param self  das Programm
+ */
+extern void
+closureRelease(closure_program_t* self);
+
+/**@brief Übersetzt einen vollständig geparsten Syntaxbaum in Closures.
+ * @param self  das (leere) Programm
+ * @param tree  der Syntaxbaum
+ */
+extern void
+closureCompile(closure_program_t* self, const syntree_t* tree);
+
+/**@brief Führt ein übersetztes Programm aus.
+ * @param self  das Programm
+ * @param vm    der Zustand der virtuellen Maschine
+ */
+extern void
+closureRun(const closure_program_t* self, minako_vm_t* vm);
+
+/**@brief Übersetzt eine einzelne Funktion (und alle von ihr aufgerufenen
+ * Funktionen) in Closures.
+ * @note Wird vom Bauminterpreter zum Befördern heißer Funktionen verwendet;
+ * bereits übersetzte Funktionen werden wiederverwendet.
+ * @param self  das Programm
+ * @param tree  der Syntaxbaum
+ * @param id    Knoten-ID der Funktion
+ * @return die Closure der Funktion
+ */
+extern const closure_t*
+closureCompileFunction(closure_program_t* self, const syntree_t* tree,
+                       syntree_nid id);
+
+/**@brief Führt eine einzelne übersetzte Funktion aus.
+ * @note Wie beim Bauminterpreter muss der Aufrufer den Rahmen ab \c vm->esp
+ * mit den Parametern belegt haben und nach der Rückkehr wieder abbauen.
+ * @param func  die Closure der Funktion
+ * @param vm    der Zustand der virtuellen Maschine
+ * @return der Rückgabewert der Funktion
+ */
+extern minako_data_t
+closureInvoke(const closure_t* func, minako_vm_t* vm);
+
+/**@brief Übersetzt eine einzelne Schleife in Closures.
+ * @param self  das Programm
+ * @param tree  der Syntaxbaum
+ * @param id    Knoten-ID der For-, While- oder DoWhile-Schleife
+ * @return die Closure der Schleife
+ */
+extern const closure_t*
+closureCompileLoop(closure_program_t* self, const syntree_t* tree,
+                   syntree_nid id);
+
+/**@brief Setzt eine interpretierte Schleife nach einem Durchlauf ihres
+ * Rumpfes in den Closures fort (On-Stack-Replacement).
+ * @note Die Schleife arbeitet direkt auf dem Rahmen ab \c vm->ebp und den
+ * globalen Variablen in \c vm->stack; es müssen keine Werte übertragen werden.
+ * @param loop  die Closure der Schleife
+ * @param vm    der Zustand der virtuellen Maschine
+ */
+extern void
+closureResume(const closure_t* loop, minako_vm_t* vm);
+
+#endif /* CLOSURE_H_INCLUDED */
@@ -0,0 +1,572 @@
+/***************************************************************************//**
+ * @file dce.c
+ * @author Dorian Weber und die Studenten
+ * @brief Implementation der Entfernung toten Codes.
+ ******************************************************************************/
+
+#include "dce.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ******************************************************* private structures */
+
+/**@brief Zustand während des Aufbaus des neuen Knotenarrays.
+ */
+typedef struct dce_layout_s
+{
+	const syntree_t* tree;   /**<@brief Der Syntaxbaum. */
+	syntree_nid* map;        /**<@brief Alte Knoten-ID -> neue Knoten-ID. */
+	unsigned char* mapped;   /**<@brief Alte Knoten-ID -> bereits platziert. */
+	syntree_nid* order;      /**<@brief Neue Knoten-ID -> alte Knoten-ID. */
+	syntree_nid* queue;      /**<@brief Noch zu platzierende Funktionen. */
+	unsigned int len;        /**<@brief Anzahl der platzierten Knoten. */
+	unsigned int pending;    /**<@brief Anzahl der wartenden Funktionen. */
+} dce_layout_t;
+
+/* ******************************************************** private functions */
+
+/**@brief Prüft, ob ein Knoten keine Knoten-IDs als Nutzlast trägt.
+ */
+static inline int
+primitive(const syntree_node_t* node)
+{
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+		return 1;
+
+	default:
+		return 0;
+	}
+}
+
+/**@brief Prüft, ob ein Ausdruck ohne Nebeneffekte ausgewertet werden kann.
+ * @note Divisionen sind ausgenommen, da sie abbrechen können.
+ */
+static int
+pure(const syntree_t* tree, syntree_nid id)
+{
+	const syntree_node_t* node = syntreeNodePtr(tree, id);
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+		return 1;
+
+	case SYNTREE_TAG_Cast:
+	case SYNTREE_TAG_Plus:
+	case SYNTREE_TAG_Minus:
+	case SYNTREE_TAG_Times:
+	case SYNTREE_TAG_Uminus:
+	case SYNTREE_TAG_LogOr:
+	case SYNTREE_TAG_LogAnd:
+	case SYNTREE_TAG_Eqt:
+	case SYNTREE_TAG_Neq:
+	case SYNTREE_TAG_Leq:
+	case SYNTREE_TAG_Geq:
+	case SYNTREE_TAG_Lst:
+	case SYNTREE_TAG_Grt:
+		for (id = node->value.container.first; id != 0;
+		     id = syntreeNodePtr(tree, id)->next)
+			if (!pure(tree, id))
+				return 0;
+
+		return 1;
+
+	default:
+		return 0;
+	}
+}
+
+/**@brief Prüft, ob eine Anweisung ein leerer Block ist.
+ */
+static inline int
+empty(const syntree_t* tree, syntree_nid id)
+{
+	const syntree_node_t* node = syntreeNodePtr(tree, id);
+	return node->tag == SYNTREE_TAG_Sequence && node->value.container.first == 0;
+}
+
+/**@brief Macht eine Anweisung zum leeren Block.
+ */
+static void
+clear(syntree_t* tree, syntree_nid id)
+{
+	syntree_node_t* node = syntreeNodePtr(tree, id);
+
+	node->tag = SYNTREE_TAG_Sequence;
+	node->type = SYNTREE_TYPE_Void;
+	node->value.container.first = node->value.container.last = 0;
+}
+
+/**@brief Ersetzt einen Knoten durch einen seiner Kindknoten.
+ * @note Der Kindknoten wird an die Stelle des Elternknotens kopiert, damit die
+ * Verweise auf den Elternknoten gültig bleiben; das Original ist danach nicht
+ * mehr erreichbar.
+ */
+static void
+replace(syntree_t* tree, syntree_nid id, syntree_nid child)
+{
+	syntree_node_t* node = syntreeNodePtr(tree, id);
+	syntree_nid next = node->next;
+
+	*node = *syntreeNodePtr(tree, child);
+	node->next = next;
+}
+
+/**@brief Bereinigt eine Anweisung an Ort und Stelle.
+ * @return != 0, falls jeder Pfad durch die Anweisung zurückspringt
+ */
+static int
+statement(syntree_t* tree, syntree_nid id)
+{
+	syntree_node_t* node = syntreeNodePtr(tree, id);
+	syntree_nid first = node->value.container.first;
+	syntree_nid child, next, head = 0, tail = 0, cons, alt;
+	int done = 0, ret;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Return:
+		return 1;
+
+	case SYNTREE_TAG_Sequence:
+		for (child = first; child != 0 && !done; child = next)
+		{
+			/* Anweisungen hinter einem Rücksprung entfallen */
+			next = syntreeNodePtr(tree, child)->next;
+			done = statement(tree, child);
+			node = syntreeNodePtr(tree, child);
+
+			if (node->tag == SYNTREE_TAG_Sequence)
+			{
+				/* geschachtelte Blöcke werden eingefügt */
+				if (node->value.container.first == 0)
+					continue;
+
+				if (tail != 0)
+					syntreeNodePtr(tree, tail)->next = node->value.container.first;
+				else
+					head = node->value.container.first;
+
+				tail = node->value.container.last;
+				continue;
+			}
+
+			if (tail != 0)
+				syntreeNodePtr(tree, tail)->next = child;
+			else
+				head = child;
+
+			tail = child;
+		}
+
+		if (tail != 0)
+			syntreeNodePtr(tree, tail)->next = 0;
+
+		node = syntreeNodePtr(tree, id);
+		node->value.container.first = head;
+		node->value.container.last = tail;
+		return done;
+
+	case SYNTREE_TAG_If:
+		cons = syntreeNodePtr(tree, first)->next;
+		alt = syntreeNodePtr(tree, cons)->next;
+
+		if (syntreeNodePtr(tree, first)->tag == SYNTREE_TAG_Boolean)
+		{
+			if (syntreeNodePtr(tree, first)->value.boolean)
+				replace(tree, id, cons);
+			else if (alt != 0)
+				replace(tree, id, alt);
+			else
+				clear(tree, id);
+
+			return statement(tree, id);
+		}
+
+		ret = statement(tree, cons);
+		done = (alt != 0) && statement(tree, alt) && ret;
+
+		/* ein leerer Alternativzweig entfällt */
+		if (alt != 0 && empty(tree, alt))
+		{
+			syntreeNodePtr(tree, cons)->next = 0;
+			syntreeNodePtr(tree, id)->value.container.last = cons;
+			alt = 0;
+		}
+
+		if (alt == 0 && empty(tree, cons) && pure(tree, first))
+			clear(tree, id);
+
+		return done;
+
+	case SYNTREE_TAG_While:
+		if (syntreeNodePtr(tree, first)->tag == SYNTREE_TAG_Boolean
+		 && !syntreeNodePtr(tree, first)->value.boolean)
+		{
+			clear(tree, id);
+			return 0;
+		}
+
+		statement(tree, node->value.container.last);
+		return 0;
+
+	case SYNTREE_TAG_DoWhile:
+		if (syntreeNodePtr(tree, first)->tag == SYNTREE_TAG_Boolean
+		 && !syntreeNodePtr(tree, first)->value.boolean)
+		{
+			replace(tree, id, node->value.container.last);
+			return statement(tree, id);
+		}
+
+		statement(tree, node->value.container.last);
+		return 0;
+
+	case SYNTREE_TAG_For:
+		child = syntreeNodePtr(tree, first)->next;
+
+		if (syntreeNodePtr(tree, child)->tag == SYNTREE_TAG_Boolean
+		 && !syntreeNodePtr(tree, child)->value.boolean)
+		{
+			replace(tree, id, first);
+			return statement(tree, id);
+		}
+
+		/* Initialisierung und Schritt sind Ausdrücke (siehe cgen.c) */
+		statement(tree, node->value.container.last);
+		return 0;
+
+	default:
+		return 0;
+	}
+}
+
+/**@brief Markiert alle gelesenen lokalen Variablen eines Teilbaumes.
+ */
+static void
+reads(const syntree_t* tree, syntree_nid id, unsigned char* read)
+{
+	const syntree_node_t* node = syntreeNodePtr(tree, id);
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_LocVar:
+		read[node->value.variable] = 1;
+		return;
+
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_GlobVar:
+	case SYNTREE_TAG_Function:
+		return;
+
+	case SYNTREE_TAG_Assign:
+		/* das Ziel ist kein Lesezugriff */
+		id = syntreeNodePtr(tree, node->value.container.first)->next;
+		break;
+
+	case SYNTREE_TAG_Call:
+	case SYNTREE_TAG_TailCall:
+		/* nur die Argumente, der letzte Kindknoten ist die Funktion */
+		id = syntreeNodePtr(tree, node->value.container.first)->value.container.first;
+		break;
+
+	default:
+		id = node->value.container.first;
+		break;
+	}
+
+	for (; id != 0; id = syntreeNodePtr(tree, id)->next)
+		reads(tree, id, read);
+}
+
+/**@brief Entfernt Zuweisungen an nie gelesene lokale Variablen.
+ * @param tree  der Syntaxbaum
+ * @param id    Wurzel des Teilbaumes
+ * @param read  Platz -> wird gelesen
+ * @param stmt  != 0, falls der Knoten als Anweisung steht und sein Wert
+ *              nicht gebraucht wird
+ * @return Anzahl der entfernten Zuweisungen
+ */
+static unsigned int
+stores(syntree_t* tree, syntree_nid id, const unsigned char* read, int stmt)
+{
+	const syntree_node_t* node = syntreeNodePtr(tree, id);
+	syntree_nid first = node->value.container.first, child;
+	const syntree_node_t* var;
+	unsigned int count = 0;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+	case SYNTREE_TAG_Function:
+		return 0;
+
+	case SYNTREE_TAG_Assign:
+		var = syntreeNodePtr(tree, first);
+		child = var->next;
+
+		if (var->tag == SYNTREE_TAG_LocVar && !read[var->value.variable])
+		{
+			/* der Wert bzw. der Aufruf bleibt erhalten */
+			if (!stmt || syntreeNodePtr(tree, child)->tag == SYNTREE_TAG_Call)
+			{
+				replace(tree, id, child);
+				return 1 + stores(tree, id, read, stmt);
+			}
+
+			if (pure(tree, child))
+			{
+				clear(tree, id);
+				return 1;
+			}
+		}
+
+		return stores(tree, child, read, 0);
+
+	case SYNTREE_TAG_Call:
+	case SYNTREE_TAG_TailCall:
+		/* nur die Argumente, der letzte Kindknoten ist die Funktion */
+		first = syntreeNodePtr(tree, first)->value.container.first;
+		stmt = 0;
+		break;
+
+	case SYNTREE_TAG_Sequence:
+		stmt = 1;
+		break;
+
+	case SYNTREE_TAG_If:
+	case SYNTREE_TAG_While:
+	case SYNTREE_TAG_DoWhile:
+		/* die Bedingung ist ein Ausdruck, der Rest sind Anweisungen */
+		count = stores(tree, first, read, 0);
+		first = syntreeNodePtr(tree, first)->next;
+		stmt = 1;
+		break;
+
+	case SYNTREE_TAG_For:
+		/* Initialisierung und Schritt bleiben Zuweisungen (siehe cgen.c) */
+		for (child = first; child != 0; child = syntreeNodePtr(tree, child)->next)
+		{
+			node = syntreeNodePtr(tree, child);
+
+			if (node->next == 0)
+				count += stores(tree, child, read, 1);
+			else if (node->tag == SYNTREE_TAG_Assign)
+				count += stores(tree, syntreeNodePtr(tree,
+					node->value.container.first)->next, read, 0);
+			else
+				count += stores(tree, child, read, 0);
+		}
+
+		return count;
+
+	default:
+		stmt = 0;
+		break;
+	}
+
+	for (child = first; child != 0; child = syntreeNodePtr(tree, child)->next)
+		count += stores(tree, child, read, stmt);
+
+	return count;
+}
+
+/**@brief Platziert einen Teilbaum in Vorordnung im neuen Knotenarray.
+ * @note Aufgerufene Funktionen werden erst nach dem Teilbaum platziert.
+ */
+static void
+place(dce_layout_t* self, syntree_nid id)
+{
+	const syntree_node_t* node;
+
+	for (; id != 0; id = node->next)
+	{
+		node = syntreeNodePtr(self->tree, id);
+
+		if (self->mapped[id])
+			return;
+
+		self->mapped[id] = 1;
+		self->map[id] = self->len;
+		self->order[self->len++] = id;
+
+		if (primitive(node))
+			continue;
+
+		switch (node->tag)
+		{
+		case SYNTREE_TAG_Function:
+			place(self, node->value.function.body);
+			break;
+
+		case SYNTREE_TAG_Call:
+		case SYNTREE_TAG_TailCall:
+			place(self, node->value.container.first);
+
+			if (!self->mapped[node->value.container.last])
+				self->queue[self->pending++] = node->value.container.last;
+			break;
+
+		default:
+			place(self, node->value.container.first);
+			break;
+		}
+	}
+}
+
+/**@brief Setzt eine Knoten-ID auf das neue Knotenarray um.
+ */
+static inline syntree_nid
+remap(const dce_layout_t* self, syntree_nid id)
+{
+	return (id != 0) ? self->map[id] : 0;
+}
+
+/**@brief Baut das Knotenarray aus den erreichbaren Knoten neu auf.
+ * @return Anzahl der entfernten Knoten
+ */
+static unsigned int
+compact(syntree_t* tree, symtab_t* tab)
+{
+	dce_layout_t layout;
+	syntree_node_t *nodes, *node;
+	unsigned int len = tree->len, id, i;
+
+	layout.tree = tree;
+	layout.map = malloc(len * sizeof(*layout.map));
+	layout.mapped = calloc(len, 1);
+	layout.order = malloc(len * sizeof(*layout.order));
+	layout.queue = malloc(len * sizeof(*layout.queue));
+	layout.len = layout.pending = 0;
+
+	if (layout.map == NULL || layout.mapped == NULL || layout.order == NULL
+	 || layout.queue == NULL)
+	{
+		fputs("out-of-memory error\n", stderr);
+		exit(-1);
+	}
+
+	/* der Programmknoten behält die ID 0, die sonst "kein Knoten" bedeutet,
+	 * danach folgt jede erreichte Funktion am Stück */
+	layout.mapped[0] = 1;
+	layout.map[0] = 0;
+	layout.order[layout.len++] = 0;
+	place(&layout, syntreeNodePtr(tree, 0)->value.program.body);
+
+	for (i = 0; i < layout.pending; ++i)
+		if (!layout.mapped[layout.queue[i]])
+			place(&layout, layout.queue[i]);
+
+	if ((nodes = malloc(layout.len * sizeof(*nodes))) == NULL)
+	{
+		fputs("out-of-memory error\n", stderr);
+		exit(-1);
+	}
+
+	for (i = 0; i < layout.len; ++i)
+	{
+		node = &nodes[i];
+		*node = tree->nodes[layout.order[i]];
+		node->next = remap(&layout, node->next);
+
+		if (primitive(node))
+			continue;
+
+		switch (node->tag)
+		{
+		case SYNTREE_TAG_Program:
+		case SYNTREE_TAG_Function:
+			node->value.function.body = remap(&layout, node->value.function.body);
+			break;
+
+		default:
+			node->value.container.first = remap(&layout, node->value.container.first);
+			node->value.container.last = remap(&layout, node->value.container.last);
+			break;
+		}
+	}
+
+	/* entfernte Funktionen haben keinen Knoten mehr */
+	for (i = 0; i < stackCount(tab->decl); ++i)
+		if (tab->decl[i]->is_function)
+			tab->decl[i]->body = layout.mapped[tab->decl[i]->body]
+			                   ? layout.map[tab->decl[i]->body] : 0;
+
+	/* Zeichenketten entfernter Knoten werden nicht mehr freigegeben */
+	for (id = 0; id < len; ++id)
+		if (!layout.mapped[id] && tree->nodes[id].tag == SYNTREE_TAG_String)
+			free(tree->nodes[id].value.string);
+
+	free(tree->nodes);
+	tree->nodes = nodes;
+	tree->len = tree->cap = layout.len;
+
+	free(layout.map);
+	free(layout.mapped);
+	free(layout.order);
+	free(layout.queue);
+	return len - layout.len;
+}
+
+/* ********************************************************* public functions */
+
+unsigned int
+dceTree(syntree_t* self, symtab_t* tab)
+{
+	syntree_node_t* node;
+	unsigned char* read;
+	unsigned int id;
+
+	statement(self, syntreeNodePtr(self, 0)->value.program.body);
+
+	for (id = 1; id < self->len; ++id)
+	{
+		node = syntreeNodePtr(self, id);
+
+		if (node->tag != SYNTREE_TAG_Function)
+			continue;
+
+		statement(self, node->value.function.body);
+
+		/* entfernte Zuweisungen können weitere Variablen ungelesen machen */
+		if ((read = malloc(node->value.function.locals + 1)) == NULL)
+		{
+			fputs("out-of-memory error\n", stderr);
+			exit(-1);
+		}
+
+		for (;;)
+		{
+			memset(read, 0, node->value.function.locals + 1);
+			reads(self, node->value.function.body, read);
+
+			if (stores(self, node->value.function.body, read, 1) == 0)
+				break;
+
+			statement(self, node->value.function.body);
+		}
+
+		free(read);
+	}
+
+	return compact(self, tab);
+}
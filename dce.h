@@ -0,0 +1,46 @@
+/***************************************************************************//**
+ * @file dce.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält einen Durchlauf, der toten Code, nie aufgerufene Funktionen
+ * und Zuweisungen an nie gelesene lokale Variablen entfernt.
+ * @details
+ * Der Durchlauf arbeitet auf den generischen Knotenarten und entfernt
+ *  - Anweisungen hinter einem Rücksprung (auch hinter Verzweigungen, deren
+ *    Zweige alle zurückspringen),
+ *  - Verzweigungen und Schleifen mit konstanter Bedingung (<tt>if (false)
+ *    A else B</tt> wird zu \c B, <tt>while (false) A</tt> verschwindet,
+ *    <tt>do A while (false)</tt> wird zu \c A, eine \c for-Schleife mit
+ *    konstant falscher Bedingung zu ihrer Initialisierung),
+ *  - leere Blöcke; geschachtelte Blöcke werden in den umgebenden eingefügt,
+ *  - Zuweisungen an lokale Variablen, die in der Funktion nirgends gelesen
+ *    werden; ein Aufruf auf der rechten Seite bleibt als Anweisung erhalten,
+ *    andere Ausdrücke mit Nebeneffekten behalten die Zuweisung.
+ *
+ * Danach wird das Knotenarray neu aufgebaut: Knoten, die weder vom
+ * Programmkörper noch von einer erreichbaren Funktion aus erreichbar sind,
+ * entfallen, und die übrigen liegen in Vorordnung hintereinander, jede
+ * Funktion mit ihrem Körper am Stück. Alle Knoten-IDs ändern sich dabei, der
+ * Durchlauf muss also vor allen Analysen laufen, die Knoten-IDs speichern,
+ * und vor definiteInit(), da er Lesezugriffe entfernt. Die Funktionssymbole
+ * der Symboltabelle werden auf die neuen Knoten-IDs umgesetzt.
+ ******************************************************************************/
+
+#ifndef DCE_H_INCLUDED
+#define DCE_H_INCLUDED
+
+/* *** includes ************************************************************* */
+
+#include "syntree.h"
+#include "symtab.h"
+
+/* *** interface ************************************************************ */
+
+/**@brief Entfernt toten Code und verdichtet das Knotenarray.
+ * @param self  der Syntaxbaum
+ * @param tab   die Symboltabelle, deren Funktionssymbole umgesetzt werden
+ * @return Anzahl der entfernten Knoten
+ */
+extern unsigned int
+dceTree(syntree_t* self, symtab_t* tab);
+
+#endif /* DCE_H_INCLUDED */
@@ -0,0 +1,298 @@
+/***************************************************************************//**
+ * @file definite.c
+ * @author Dorian Weber und die Studenten
+ * @brief Implementation der Analyse der definitiven Zuweisung.
+ ******************************************************************************/
+
+#include "definite.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ******************************************************* private structures */
+
+/**@brief Zustand während der Analyse einer Funktion.
+ */
+typedef struct definite_ctx_s
+{
+	const syntree_t* tree; /**<@brief Der Syntaxbaum. */
+	unsigned int locals;   /**<@brief Variablenanzahl der Funktion. */
+	unsigned char* maybe;  /**<@brief Plätze, die uninitialisiert gelesen werden können. */
+	int failed;            /**<@brief Speichermangel aufgetreten. */
+} definite_ctx_t;
+
+/* ******************************************************** private functions */
+
+/**@brief Gibt die Knoten-ID des Folgeknotens zurück.
+ */
+static inline syntree_nid
+next(const definite_ctx_t* ctx, syntree_nid id)
+{
+	return syntreeNodePtr(ctx->tree, id)->next;
+}
+
+/**@brief Kopiert eine Menge zugewiesener Plätze.
+ */
+static unsigned char*
+copy(definite_ctx_t* ctx, const unsigned char* set)
+{
+	unsigned char* res = malloc(ctx->locals + 1);
+
+	if (res == NULL)
+		ctx->failed = 1;
+	else
+		memcpy(res, set, ctx->locals + 1);
+
+	return res;
+}
+
+/**@brief Schneidet \p set mit \p other und gibt \p other frei.
+ */
+static void
+meet(const definite_ctx_t* ctx, unsigned char* set, unsigned char* other)
+{
+	unsigned int i;
+
+	for (i = 0; i < ctx->locals; ++i)
+		set[i] &= other[i];
+
+	free(other);
+}
+
+/**@brief Verfolgt die Zuweisungen innerhalb eines Teilbaumes.
+ * @param ctx  der Analysezustand
+ * @param id   Wurzel des Teilbaumes
+ * @param set  Plätze, die vor dem Teilbaum sicher zugewiesen sind; enthält
+ *             danach die Plätze, die nach dem Teilbaum sicher zugewiesen sind
+ */
+static void
+walk(definite_ctx_t* ctx, syntree_nid id, unsigned char* set)
+{
+	const syntree_node_t* node = syntreeNodePtr(ctx->tree, id);
+	syntree_nid first = node->value.container.first;
+	unsigned char* other;
+
+	if (ctx->failed)
+		return;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_GlobVar:
+		break;
+
+	case SYNTREE_TAG_LocVar:
+		if (!set[node->value.variable])
+			ctx->maybe[node->value.variable] = 1;
+		break;
+
+	case SYNTREE_TAG_Assign:
+	case SYNTREE_TAG_AssignLocPlusK:
+		walk(ctx, node->value.container.last, set);
+		node = syntreeNodePtr(ctx->tree, first);
+
+		if (node->tag == SYNTREE_TAG_LocVar)
+			set[node->value.variable] = 1;
+		break;
+
+	case SYNTREE_TAG_Call:
+	case SYNTREE_TAG_TailCall:
+		/* nur die Argumente, der letzte Kindknoten ist die Funktion */
+		for (id = syntreeNodePtr(ctx->tree, first)->value.container.first;
+		     id != 0; id = next(ctx, id))
+			walk(ctx, id, set);
+		break;
+
+	case SYNTREE_TAG_Return:
+		if (first != 0)
+			walk(ctx, first, set);
+
+		/* der Rest ist unerreichbar und schränkt Schnittmengen nicht ein */
+		memset(set, 1, ctx->locals);
+		break;
+
+	case SYNTREE_TAG_If:
+		walk(ctx, first, set);
+
+		if ((other = copy(ctx, set)) == NULL)
+			break;
+
+		walk(ctx, next(ctx, first), other);
+
+		if (next(ctx, next(ctx, first)) != 0)
+			walk(ctx, next(ctx, next(ctx, first)), set);
+
+		meet(ctx, set, other);
+		break;
+
+	case SYNTREE_TAG_While:
+	case SYNTREE_TAG_LogOr:
+	case SYNTREE_TAG_LogAnd:
+		/* der zweite Kindknoten wird eventuell nicht ausgewertet */
+		walk(ctx, first, set);
+
+		if ((other = copy(ctx, set)) == NULL)
+			break;
+
+		walk(ctx, node->value.container.last, other);
+		free(other);
+		break;
+
+	case SYNTREE_TAG_DoWhile:
+		walk(ctx, node->value.container.last, set);
+		walk(ctx, first, set);
+		break;
+
+	case SYNTREE_TAG_For:
+		/* Initialisierung, Bedingung, Schritt, Körper */
+		walk(ctx, first, set);
+		id = next(ctx, first);
+		walk(ctx, id, set);
+
+		if ((other = copy(ctx, set)) == NULL)
+			break;
+
+		walk(ctx, next(ctx, next(ctx, id)), other);
+		walk(ctx, next(ctx, id), other);
+		free(other);
+		break;
+
+	default:
+		/* Sequenzen, Ausgaben und Operatoren werten alle Kinder aus */
+		for (id = first; id != 0; id = next(ctx, id))
+			walk(ctx, id, set);
+		break;
+	}
+}
+
+/* ********************************************************* public functions */
+
+int
+definiteInit(definite_t* self, const syntree_t* tree)
+{
+	const syntree_node_t* node;
+	definite_ctx_t ctx;
+	unsigned int* params;
+	unsigned int* slots;
+	unsigned char* set;
+	unsigned int id, i, count = 0, cap = 16;
+	syntree_nid arg;
+
+	self->start = malloc((tree->len + 1) * sizeof(*self->start));
+	self->slots = malloc(cap * sizeof(*self->slots));
+	params = calloc(tree->len, sizeof(*params));
+
+	if (self->start == NULL || self->slots == NULL || params == NULL)
+	{
+		free(params);
+		definiteRelease(self);
+		return -1;
+	}
+
+	/* die Parameteranzahl ergibt sich aus den Aufrufen */
+	for (id = 1; id < tree->len; ++id)
+	{
+		node = syntreeNodePtr(tree, id);
+
+		if (node->tag != SYNTREE_TAG_Call && node->tag != SYNTREE_TAG_TailCall)
+			continue;
+
+		i = 0;
+
+		for (arg = syntreeNodePtr(tree, node->value.container.first)->value.container.first;
+		     arg != 0; arg = syntreeNodePtr(tree, arg)->next)
+			++i;
+
+		params[node->value.container.last] = i;
+	}
+
+	ctx.tree = tree;
+	ctx.failed = 0;
+
+	for (id = 0; id < tree->len; ++id)
+	{
+		self->start[id] = count;
+		node = syntreeNodePtr(tree, id);
+
+		if (id == 0 || node->tag != SYNTREE_TAG_Function
+		 || node->value.function.locals == 0)
+			continue;
+
+		ctx.locals = node->value.function.locals;
+		set = calloc(2 * ctx.locals + 1, 1);
+
+		if (set == NULL)
+		{
+			ctx.failed = 1;
+			break;
+		}
+
+		ctx.maybe = set + ctx.locals + 1;
+		memset(set, 1, params[id]);
+		walk(&ctx, node->value.function.body, set);
+
+		for (i = 0; i < ctx.locals && !ctx.failed; ++i)
+		{
+			if (!ctx.maybe[i])
+				continue;
+
+			if (count == cap)
+			{
+				slots = realloc(self->slots, 2 * cap * sizeof(*slots));
+
+				if (slots == NULL)
+				{
+					ctx.failed = 1;
+					break;
+				}
+
+				self->slots = slots;
+				cap *= 2;
+			}
+
+			self->slots[count++] = i;
+		}
+
+		free(set);
+
+		if (ctx.failed)
+			break;
+	}
+
+	self->start[tree->len] = count;
+	free(params);
+
+	if (ctx.failed)
+	{
+		definiteRelease(self);
+		return -1;
+	}
+
+	return 0;
+}
+
+void
+definiteRelease(definite_t* self)
+{
+	free(self->start);
+	free(self->slots);
+	self->start = NULL;
+	self->slots = NULL;
+}
+
+unsigned int
+definiteReport(const definite_t* self, const syntree_t* tree,
+               const symtab_t* tab, FILE* out)
+{
+	unsigned int id, i;
+
+	for (id = 0; id < tree->len; ++id)
+		for (i = self->start[id]; i < self->start[id + 1]; ++i)
+			fprintf(out, "warning: function %s: local slot %u may be read "
+			        "before assignment\n", symtabFunctionName(tab, id),
+			        self->slots[i]);
+
+	return self->start[tree->len];
+}
@@ -0,0 +1,82 @@
+/***************************************************************************//**
+ * @file definite.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält eine Analyse der definitiven Zuweisung lokaler Variablen.
+ * @details
+ * Hier ist ein Beispiel für die Benutzung:
+ * @code
+ * definite_t defs;
+ * unsigned int i;
+ *
+ * definiteInit(&defs, ast);
+ *
+ * for (i = defs.start[func]; i < defs.start[func + 1]; ++i)
+ *     frame[defs.slots[i]].integer = DUMMY;
+ *
+ * definiteRelease(&defs);
+ * @endcode
+ *
+ * Für jede Funktion wird ermittelt, welche Variablenplätze auf irgendeinem
+ * Pfad gelesen werden können, bevor sie geschrieben wurden. Nur diese Plätze
+ * müssen beim Eintritt in die Funktion mit \c DUMMY vorbelegt werden; alle
+ * anderen Plätze werden garantiert vor dem ersten Lesen beschrieben, so dass
+ * der Rahmen nach einem Aufruf nicht mehr aufgeräumt werden muss. Parameter
+ * gelten als zugewiesen; ihre Anzahl ergibt sich aus den Aufrufen.
+ *
+ * Die Analyse arbeitet auf Plätzen, nicht auf Variablen: teilen sich
+ * Geschwisterblöcke einen Platz, sieht ein uninitialisiertes Lesen wie bisher
+ * den zuletzt geschriebenen Wert.
+ ******************************************************************************/
+
+#ifndef DEFINITE_H_INCLUDED
+#define DEFINITE_H_INCLUDED
+
+/* *** includes ************************************************************* */
+
+#include <stdio.h>
+#include "syntree.h"
+#include "symtab.h"
+
+/* *** structures *********************************************************** */
+
+/**@brief Ergebnis der Analyse.
+ * @note Die Plätze der Funktion mit der Knoten-ID \c f stehen in
+ * <tt>slots[start[f]]</tt> bis ausschließlich <tt>slots[start[f + 1]]</tt>.
+ */
+typedef struct definite_s
+{
+	unsigned int* start; /**<@brief Knoten-ID -> erster Eintrag in \c slots. */
+	unsigned int* slots; /**<@brief Vorzubelegende Plätze aller Funktionen. */
+} definite_t;
+
+/* *** interface ************************************************************ */
+
+/**@brief Analysiert alle Funktionen eines Syntaxbaumes.
+ * @note Versteht die ursprünglichen ebenso wie die spezialisierten und
+ * fusionierten Knotenarten.
+ * @param self  die zu initialisierende Analyse
+ * @param tree  der Syntaxbaum
+ * @return 0, falls keine Fehler aufgetreten sind\n
+ *      != 0 ansonsten
+ */
+extern int
+definiteInit(definite_t* self, const syntree_t* tree);
+
+/**@brief Gibt die Analyse frei.
+ * @param self  die Analyse
+ */
+extern void
+definiteRelease(definite_t* self);
+
+/**@brief Meldet alle Plätze, die vor ihrer Zuweisung gelesen werden können.
+ * @param self  die Analyse
+ * @param tree  der analysierte Syntaxbaum
+ * @param tab   Symboltabelle für die Funktionsnamen
+ * @param out   Ausgabestrom
+ * @return Anzahl der gemeldeten Plätze
+ */
+extern unsigned int
+definiteReport(const definite_t* self, const syntree_t* tree,
+               const symtab_t* tab, FILE* out);
+
+#endif /* DEFINITE_H_INCLUDED */
@@ -0,0 +1,659 @@
+/***************************************************************************//**
+ * @file fold.c
+ * @author Dorian Weber und die Studenten
+ * @brief Implementation der Konstantenfaltung und -weitergabe.
+ ******************************************************************************/
+
+#include "fold.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ******************************************************* private structures */
+
+/**@brief Bekannter Wert einer lokalen Variable.
+ */
+typedef struct fold_const_s
+{
+	syntree_node_type type;  /**<@brief Typ oder Void, falls unbekannt. */
+	union syntree_node_value_u value; /**<@brief Der Wert. */
+} fold_const_t;
+
+/**@brief Zustand während des Durchlaufs einer Funktion.
+ */
+typedef struct fold_ctx_s
+{
+	syntree_t* tree;         /**<@brief Der Syntaxbaum. */
+	fold_stats_t* stats;     /**<@brief Die Statistik. */
+	unsigned int locals;     /**<@brief Variablenanzahl der Funktion. */
+} fold_ctx_t;
+
+/* ******************************************************** private functions */
+
+/**@brief Gibt einen Zeiger auf einen Knoten zurück.
+ */
+static inline syntree_node_t*
+ptr(const fold_ctx_t* ctx, syntree_nid id)
+{
+	return syntreeNodePtr(ctx->tree, id);
+}
+
+/**@brief Prüft, ob ein Knoten ein Zahlen- oder Wahrheitswertliteral ist.
+ */
+static inline int
+literal(const syntree_node_t* node)
+{
+	return node->tag == SYNTREE_TAG_Integer || node->tag == SYNTREE_TAG_Float
+	    || node->tag == SYNTREE_TAG_Boolean;
+}
+
+/**@brief Prüft, ob ein Knoten ein Literal mit einem bestimmten Wert ist.
+ */
+static int
+equals(const syntree_node_t* node, int value)
+{
+	union syntree_node_value_u other;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+		return node->value.integer == value;
+
+	case SYNTREE_TAG_Float:
+		/* bitweise, damit -0.0 nicht als 0.0 gilt */
+		other.real = (float) value;
+		return node->value.integer == other.integer;
+
+	case SYNTREE_TAG_Boolean:
+		return node->value.boolean == value;
+
+	default:
+		return 0;
+	}
+}
+
+/**@brief Prüft, ob ein Ausdruck ohne Nebeneffekte ausgewertet werden kann.
+ * @note Solche Ausdrücke dürfen wegfallen. Divisionen sind ausgenommen, da sie
+ * abbrechen können.
+ */
+static int
+pure(const fold_ctx_t* ctx, syntree_nid id)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+		return 1;
+
+	case SYNTREE_TAG_Cast:
+	case SYNTREE_TAG_Plus:
+	case SYNTREE_TAG_Minus:
+	case SYNTREE_TAG_Times:
+	case SYNTREE_TAG_Uminus:
+	case SYNTREE_TAG_LogOr:
+	case SYNTREE_TAG_LogAnd:
+	case SYNTREE_TAG_Eqt:
+	case SYNTREE_TAG_Neq:
+	case SYNTREE_TAG_Leq:
+	case SYNTREE_TAG_Geq:
+	case SYNTREE_TAG_Lst:
+	case SYNTREE_TAG_Grt:
+		for (id = node->value.container.first; id != 0; id = ptr(ctx, id)->next)
+			if (!pure(ctx, id))
+				return 0;
+
+		return 1;
+
+	default:
+		return 0;
+	}
+}
+
+/**@brief Macht einen Knoten zum Literal.
+ * @note Die bisherigen Kindknoten sind danach nicht mehr erreichbar.
+ */
+static void
+constant(fold_ctx_t* ctx, syntree_nid id, syntree_node_type type,
+         union syntree_node_value_u value)
+{
+	syntree_node_t* node = ptr(ctx, id);
+
+	switch (type)
+	{
+	case SYNTREE_TYPE_Integer:
+		node->tag = SYNTREE_TAG_Integer;
+		break;
+
+	case SYNTREE_TYPE_Float:
+		node->tag = SYNTREE_TAG_Float;
+		break;
+
+	default:
+		node->tag = SYNTREE_TAG_Boolean;
+		break;
+	}
+
+	node->type = type;
+	node->value = value;
+}
+
+/**@brief Ersetzt einen Knoten durch einen seiner Kindknoten.
+ * @details
+ * Der Kindknoten wird an die Stelle des Elternknotens kopiert, damit die
+ * Verweise auf den Elternknoten gültig bleiben, und danach unschädlich
+ * gemacht, damit Durchläufe über alle Knoten keine verwaisten Aufrufe sehen.
+ */
+static void
+replace(fold_ctx_t* ctx, syntree_nid id, syntree_nid child)
+{
+	syntree_node_t* node = ptr(ctx, id);
+	syntree_node_t* old = ptr(ctx, child);
+	syntree_nid next = node->next;
+
+	*node = *old;
+	node->next = next;
+
+	old->tag = SYNTREE_TAG_Sequence;
+	old->type = SYNTREE_TYPE_Void;
+	old->next = 0;
+	old->value.container.first = old->value.container.last = 0;
+}
+
+/**@brief Faltet einen Operator mit konstanten Operanden.
+ * @return != 0, falls der Knoten zum Literal wurde
+ */
+static int
+fold(fold_ctx_t* ctx, syntree_nid id)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	const syntree_node_t* lhs = ptr(ctx, node->value.container.first);
+	const syntree_node_t* rhs = ptr(ctx, node->value.container.last);
+	union syntree_node_value_u res;
+	syntree_node_type type = node->type;
+	int a, b;
+	float x, y;
+
+	if (!literal(lhs) || !literal(rhs))
+		return 0;
+
+	a = lhs->value.integer;
+	b = rhs->value.integer;
+	x = lhs->value.real;
+	y = rhs->value.real;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Cast:
+		if (type != SYNTREE_TYPE_Float || lhs->type != SYNTREE_TYPE_Integer)
+			return 0;
+
+		res.real = (float) a;
+		break;
+
+	case SYNTREE_TAG_Uminus:
+		if (type == SYNTREE_TYPE_Integer)
+			res.integer = (int) (0u - (unsigned int) a);
+		else
+			res.real = -x;
+		break;
+
+	/* ganzzahlige Operationen laufen wie im Interpreter über */
+	case SYNTREE_TAG_Plus:
+		if (type == SYNTREE_TYPE_Integer)
+			res.integer = (int) ((unsigned int) a + (unsigned int) b);
+		else
+			res.real = x + y;
+		break;
+
+	case SYNTREE_TAG_Minus:
+		if (type == SYNTREE_TYPE_Integer)
+			res.integer = (int) ((unsigned int) a - (unsigned int) b);
+		else
+			res.real = x - y;
+		break;
+
+	case SYNTREE_TAG_Times:
+		if (type == SYNTREE_TYPE_Integer)
+			res.integer = (int) ((unsigned int) a * (unsigned int) b);
+		else
+			res.real = x * y;
+		break;
+
+	case SYNTREE_TAG_Divide:
+		if (type != SYNTREE_TYPE_Integer)
+			res.real = x / y;
+		else if (b == 0 || (a == INT_MIN && b == -1))
+			return 0;
+		else
+			res.integer = a / b;
+		break;
+
+	case SYNTREE_TAG_LogOr:
+		res.boolean = a || b;
+		break;
+
+	case SYNTREE_TAG_LogAnd:
+		res.boolean = a && b;
+		break;
+
+#define COMPARE(NAME, OP) \
+	case SYNTREE_TAG_ ## NAME: \
+		if (lhs->type == SYNTREE_TYPE_Float) \
+			res.boolean = x OP y; \
+		else \
+			res.boolean = a OP b; \
+		break;
+
+	COMPARE(Eqt, ==)
+	COMPARE(Neq, !=)
+	COMPARE(Leq, <=)
+	COMPARE(Geq, >=)
+	COMPARE(Lst, <)
+	COMPARE(Grt, >)
+
+#undef COMPARE
+
+	default:
+		return 0;
+	}
+
+	constant(ctx, id, type, res);
+	++ctx->stats->folded;
+	return 1;
+}
+
+/**@brief Vereinfacht algebraische Identitäten mit einem konstanten Operanden.
+ */
+static void
+simplify(fold_ctx_t* ctx, syntree_nid id)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	syntree_nid first = node->value.container.first;
+	syntree_nid last = node->value.container.last;
+	const syntree_node_t* lhs = ptr(ctx, first);
+	const syntree_node_t* rhs = ptr(ctx, last);
+	union syntree_node_value_u zero;
+	syntree_nid keep = 0;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Plus:
+		/* x + 0.0 ändert das Vorzeichen von -0.0 */
+		if (node->type != SYNTREE_TYPE_Integer)
+			return;
+
+		if (equals(lhs, 0))
+			keep = last;
+		else if (equals(rhs, 0))
+			keep = first;
+		break;
+
+	case SYNTREE_TAG_Minus:
+		if (equals(rhs, 0))
+			keep = first;
+		break;
+
+	case SYNTREE_TAG_Times:
+		if (equals(lhs, 1))
+			keep = last;
+		else if (equals(rhs, 1))
+			keep = first;
+		else if (node->type == SYNTREE_TYPE_Integer
+		      && ((equals(lhs, 0) && pure(ctx, last))
+		       || (equals(rhs, 0) && pure(ctx, first))))
+		{
+			zero.integer = 0;
+			constant(ctx, id, SYNTREE_TYPE_Integer, zero);
+			++ctx->stats->simplified;
+			return;
+		}
+		break;
+
+	case SYNTREE_TAG_Divide:
+		if (equals(rhs, 1))
+			keep = first;
+		break;
+
+	case SYNTREE_TAG_LogAnd:
+		/* true && x, x && true: x; false && x: false */
+		if (equals(lhs, 1))
+			keep = last;
+		else if (equals(rhs, 1))
+			keep = first;
+		else if (equals(lhs, 0) || (equals(rhs, 0) && pure(ctx, first)))
+			keep = equals(lhs, 0) ? first : last;
+		break;
+
+	case SYNTREE_TAG_LogOr:
+		/* false || x, x || false: x; true || x: true */
+		if (equals(lhs, 0))
+			keep = last;
+		else if (equals(rhs, 0))
+			keep = first;
+		else if (equals(lhs, 1) || (equals(rhs, 1) && pure(ctx, first)))
+			keep = equals(lhs, 1) ? first : last;
+		break;
+
+	default:
+		return;
+	}
+
+	if (keep != 0)
+	{
+		replace(ctx, id, keep);
+		++ctx->stats->simplified;
+	}
+}
+
+/**@brief Vergisst alle Variablen, die ein Teilbaum zuweist.
+ */
+static void
+kill(const fold_ctx_t* ctx, syntree_nid id, fold_const_t* env)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	const syntree_node_t* var;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+		return;
+
+	case SYNTREE_TAG_Assign:
+		var = ptr(ctx, node->value.container.first);
+
+		if (var->tag == SYNTREE_TAG_LocVar)
+			env[var->value.variable].type = SYNTREE_TYPE_Void;
+
+		id = var->next;
+		break;
+
+	case SYNTREE_TAG_Call:
+	case SYNTREE_TAG_TailCall:
+		/* nur die Argumente, der letzte Kindknoten ist die Funktion */
+		id = ptr(ctx, node->value.container.first)->value.container.first;
+		break;
+
+	default:
+		id = node->value.container.first;
+		break;
+	}
+
+	for (; id != 0; id = ptr(ctx, id)->next)
+		kill(ctx, id, env);
+}
+
+/**@brief Legt eine Kopie der bekannten Werte an.
+ */
+static fold_const_t*
+fork(const fold_ctx_t* ctx, const fold_const_t* env)
+{
+	fold_const_t* copy = malloc((ctx->locals + 1) * sizeof(*copy));
+
+	if (copy == NULL)
+	{
+		fputs("out-of-memory error\n", stderr);
+		exit(-1);
+	}
+
+	memcpy(copy, env, (ctx->locals + 1) * sizeof(*copy));
+	return copy;
+}
+
+/**@brief Behält nur die Werte, die auf beiden Pfaden bekannt und gleich sind,
+ * und gibt die Kopie frei.
+ */
+static void
+join(const fold_ctx_t* ctx, fold_const_t* env, fold_const_t* other)
+{
+	unsigned int i;
+
+	for (i = 0; i < ctx->locals; ++i)
+		if (env[i].type != other[i].type
+		 || env[i].value.integer != other[i].value.integer)
+			env[i].type = SYNTREE_TYPE_Void;
+
+	free(other);
+}
+
+/**@brief Durchläuft einen Teilbaum in Ausführungsreihenfolge.
+ * @param ctx  der Durchlaufzustand
+ * @param id   Wurzel des Teilbaumes
+ * @param env  Platz -> bekannter Wert vor der Ausführung, danach nach der
+ *             Ausführung des Teilbaumes
+ */
+static void
+visit(fold_ctx_t* ctx, syntree_nid id, fold_const_t* env)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	syntree_nid first = node->value.container.first;
+	syntree_nid child;
+	fold_const_t *copy, *other;
+	const syntree_node_t* var;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_GlobVar:
+	case SYNTREE_TAG_Function:
+		return;
+
+	case SYNTREE_TAG_Program:
+		visit(ctx, node->value.program.body, env);
+		return;
+
+	case SYNTREE_TAG_LocVar:
+		if (env[node->value.variable].type != SYNTREE_TYPE_Void)
+		{
+			constant(ctx, id, env[node->value.variable].type,
+			         env[node->value.variable].value);
+			++ctx->stats->propagated;
+		}
+		return;
+
+	case SYNTREE_TAG_Assign:
+		/* das Ziel ist kein Lesezugriff */
+		child = ptr(ctx, first)->next;
+		visit(ctx, child, env);
+
+		var = ptr(ctx, first);
+		node = ptr(ctx, child);
+
+		if (var->tag == SYNTREE_TAG_LocVar)
+		{
+			env[var->value.variable].type =
+				literal(node) ? node->type : SYNTREE_TYPE_Void;
+			env[var->value.variable].value = node->value;
+		}
+		return;
+
+	case SYNTREE_TAG_Call:
+	case SYNTREE_TAG_TailCall:
+		for (child = ptr(ctx, first)->value.container.first; child != 0;
+		     child = ptr(ctx, child)->next)
+			visit(ctx, child, env);
+		return;
+
+	case SYNTREE_TAG_Sequence:
+	case SYNTREE_TAG_Print:
+	case SYNTREE_TAG_Return:
+		for (child = first; child != 0; child = ptr(ctx, child)->next)
+			visit(ctx, child, env);
+		return;
+
+	case SYNTREE_TAG_If:
+		visit(ctx, first, env);
+		child = ptr(ctx, first)->next;
+
+		copy = fork(ctx, env);
+		visit(ctx, child, copy);
+		child = ptr(ctx, child)->next;
+
+		if (child != 0)
+		{
+			other = fork(ctx, env);
+			visit(ctx, child, other);
+			memcpy(env, other, (ctx->locals + 1) * sizeof(*env));
+			free(other);
+		}
+
+		join(ctx, env, copy);
+		return;
+
+	case SYNTREE_TAG_For:
+		visit(ctx, first, env);
+		first = ptr(ctx, first)->next;
+		/* fall through */
+
+	case SYNTREE_TAG_While:
+	case SYNTREE_TAG_DoWhile:
+		/* die Schleife kann jede zugewiesene Variable schon vor der
+		 * Bedingung verändert haben, und die Kindknoten laufen nicht in der
+		 * Reihenfolge ihrer Verkettung */
+		for (child = first; child != 0; child = ptr(ctx, child)->next)
+			kill(ctx, child, env);
+
+		for (child = first; child != 0; child = ptr(ctx, child)->next)
+		{
+			copy = fork(ctx, env);
+			visit(ctx, child, copy);
+			free(copy);
+		}
+		return;
+
+	case SYNTREE_TAG_LogOr:
+	case SYNTREE_TAG_LogAnd:
+		/* der rechte Operand wird nur bedingt ausgewertet */
+		visit(ctx, first, env);
+		copy = fork(ctx, env);
+		visit(ctx, ptr(ctx, first)->next, copy);
+		join(ctx, env, copy);
+		break;
+
+	default:
+		for (child = first; child != 0; child = ptr(ctx, child)->next)
+			visit(ctx, child, env);
+		break;
+	}
+
+	if (!fold(ctx, id))
+		simplify(ctx, id);
+}
+
+/**@brief Zählt die erreichbaren Knoten eines Teilbaumes.
+ */
+static unsigned int
+count(const syntree_t* tree, syntree_nid id)
+{
+	const syntree_node_t* node = syntreeNodePtr(tree, id);
+	unsigned int res = 1;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+		return 1;
+
+	case SYNTREE_TAG_Function:
+		/* Funktionen werden einzeln gezählt */
+		return 0;
+
+	case SYNTREE_TAG_Call:
+	case SYNTREE_TAG_TailCall:
+		return 1 + count(tree, node->value.container.first);
+
+	default:
+		break;
+	}
+
+	for (id = node->value.container.first; id != 0;
+	     id = syntreeNodePtr(tree, id)->next)
+		res += count(tree, id);
+
+	return res;
+}
+
+/**@brief Zählt die erreichbaren Knoten des Programms.
+ */
+static unsigned int
+total(const syntree_t* tree)
+{
+	const syntree_node_t* node;
+	unsigned int res = count(tree, 0), id;
+
+	for (id = 1; id < tree->len; ++id)
+	{
+		node = syntreeNodePtr(tree, id);
+
+		if (node->tag == SYNTREE_TAG_Function)
+			res += 1 + count(tree, node->value.function.body);
+	}
+
+	return res;
+}
+
+/* ********************************************************* public functions */
+
+int
+foldTree(syntree_t* self, fold_stats_t* stats)
+{
+	const syntree_node_t* node;
+	fold_const_t* env;
+	fold_ctx_t ctx;
+	unsigned int id, len = self->len, i;
+
+	memset(stats, 0, sizeof(*stats));
+	stats->before = total(self);
+
+	ctx.tree = self;
+	ctx.stats = stats;
+
+	/* globale Initialisierungen, dann alle Funktionskörper */
+	for (id = 0; id < len; ++id)
+	{
+		node = syntreeNodePtr(self, id);
+
+		if (id != 0 && node->tag != SYNTREE_TAG_Function)
+			continue;
+
+		ctx.locals = (id != 0) ? node->value.function.locals : 0;
+
+		if ((env = malloc((ctx.locals + 1) * sizeof(*env))) == NULL)
+			return -1;
+
+		for (i = 0; i <= ctx.locals; ++i)
+			env[i].type = SYNTREE_TYPE_Void;
+
+		visit(&ctx, (id != 0) ? node->value.function.body : 0, env);
+		free(env);
+	}
+
+	stats->after = total(self);
+	return 0;
+}
+
+void
+foldReport(const fold_stats_t* stats, FILE* out)
+{
+	fprintf(out, "fold: %u expressions folded, %u reads propagated, "
+	        "%u identities simplified\n",
+	        stats->folded, stats->propagated, stats->simplified);
+	fprintf(out, "fold: %u nodes before, %u after (-%u)\n",
+	        stats->before, stats->after, stats->before - stats->after);
+}
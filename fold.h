@@ -0,0 +1,72 @@
+/***************************************************************************//**
+ * @file fold.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält einen Durchlauf, der konstante Teilausdrücke faltet,
+ * Konstanten lokaler Variablen weitergibt und algebraische Identitäten
+ * vereinfacht.
+ * @details
+ * Hier ist ein Beispiel für die Benutzung:
+ * @code
+ * fold_stats_t stats;
+ *
+ * foldTree(ast, &stats);
+ * foldReport(&stats, stderr);
+ * @endcode
+ *
+ * Der Durchlauf arbeitet auf den generischen Knotenarten direkt nach dem
+ * Parsen und ersetzt Knoten an Ort und Stelle:
+ *  - Operatoren, Vergleiche und Casts mit konstanten Operanden werden zu
+ *    Literalen (<tt>1 + 2</tt> wird zu \c 3, <tt>Cast(Integer 1)</tt> zu
+ *    \c 1.0); ganzzahlige Divisionen, die abbrechen würden, bleiben erhalten,
+ *  - nach <tt>x = Konstante</tt> werden folgende Lesezugriffe auf \c x im
+ *    selben Block durch die Konstante ersetzt, bis \c x wieder zugewiesen
+ *    wird; Verzweigungen und Schleifen verwerfen dabei alle Variablen, die
+ *    sie zuweisen,
+ *  - Identitäten wie <tt>x * 1</tt>, <tt>x + 0</tt>, <tt>x - 0</tt>,
+ *    <tt>x / 1</tt>, <tt>true && x</tt> und <tt>false || x</tt> werden zu
+ *    \c x vereinfacht (<tt>x + 0.0</tt> nicht, da es das Vorzeichen von
+ *    \c -0.0 ändert).
+ *
+ * Der Durchlauf muss vor definiteInit() laufen, da er Lesezugriffe entfernt.
+ ******************************************************************************/
+
+#ifndef FOLD_H_INCLUDED
+#define FOLD_H_INCLUDED
+
+/* *** includes ************************************************************* */
+
+#include "syntree.h"
+#include <stdio.h>
+
+/* *** structures *********************************************************** */
+
+/**@brief Statistik eines Durchlaufs.
+ */
+typedef struct fold_stats_s
+{
+	unsigned int folded;     /**<@brief Gefaltete konstante Ausdrücke. */
+	unsigned int propagated; /**<@brief Durch Konstanten ersetzte Lesezugriffe. */
+	unsigned int simplified; /**<@brief Vereinfachte Identitäten. */
+	unsigned int before;     /**<@brief Erreichbare Knoten vorher. */
+	unsigned int after;      /**<@brief Erreichbare Knoten nachher. */
+} fold_stats_t;
+
+/* *** interface ************************************************************ */
+
+/**@brief Faltet und vereinfacht alle Ausdrücke des Programms.
+ * @param self   der Syntaxbaum
+ * @param stats  Ziel für die Statistik
+ * @return 0, falls keine Fehler aufgetreten sind\n
+ *      != 0 ansonsten
+ */
+extern int
+foldTree(syntree_t* self, fold_stats_t* stats);
+
+/**@brief Gibt die Statistik eines Durchlaufs aus.
+ * @param stats  die Statistik
+ * @param out    der Ausgabestrom
+ */
+extern void
+foldReport(const fold_stats_t* stats, FILE* out);
+
+#endif /* FOLD_H_INCLUDED */
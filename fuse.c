@@ -0,0 +1,109 @@
+/***************************************************************************//**
+ * @file fuse.c
+ * @author Dorian Weber und die Studenten
+ * @brief Implementation des Fusionsdurchlaufs.
+ ******************************************************************************/
+
+#include "fuse.h"
+
+/* ******************************************************** private functions */
+
+/**@brief Ermittelt die fusionierte Knotenart eines Operators mit einer
+ * lokalen Variable als linkem und einer Konstanten als rechtem Operanden.
+ * @return die fusionierte Knotenart oder \p tag, falls es keine gibt
+ */
+static syntree_node_tag
+fuseLocK(syntree_node_tag tag)
+{
+	switch (tag)
+	{
+	case SYNTREE_TAG_PlusInt:     return SYNTREE_TAG_PlusIntLocK;
+	case SYNTREE_TAG_MinusInt:    return SYNTREE_TAG_MinusIntLocK;
+	case SYNTREE_TAG_TimesInt:    return SYNTREE_TAG_TimesIntLocK;
+	case SYNTREE_TAG_DivideInt:   return SYNTREE_TAG_DivideIntLocK;
+	case SYNTREE_TAG_PlusFloat:   return SYNTREE_TAG_PlusFloatLocK;
+	case SYNTREE_TAG_MinusFloat:  return SYNTREE_TAG_MinusFloatLocK;
+	case SYNTREE_TAG_TimesFloat:  return SYNTREE_TAG_TimesFloatLocK;
+	case SYNTREE_TAG_DivideFloat: return SYNTREE_TAG_DivideFloatLocK;
+	case SYNTREE_TAG_EqtInt:      return SYNTREE_TAG_EqtIntLocK;
+	case SYNTREE_TAG_NeqInt:      return SYNTREE_TAG_NeqIntLocK;
+	case SYNTREE_TAG_LeqInt:      return SYNTREE_TAG_LeqIntLocK;
+	case SYNTREE_TAG_GeqInt:      return SYNTREE_TAG_GeqIntLocK;
+	case SYNTREE_TAG_LstInt:      return SYNTREE_TAG_LstIntLocK;
+	case SYNTREE_TAG_GrtInt:      return SYNTREE_TAG_GrtIntLocK;
+	default:                      return tag;
+	}
+}
+
+/**@brief Ermittelt die fusionierte Knotenart eines Vergleichs zweier lokaler
+ * Variablen.
+ * @return die fusionierte Knotenart oder \p tag, falls es keine gibt
+ */
+static syntree_node_tag
+fuseLocLoc(syntree_node_tag tag)
+{
+	switch (tag)
+	{
+	case SYNTREE_TAG_EqtInt: return SYNTREE_TAG_EqtIntLocLoc;
+	case SYNTREE_TAG_NeqInt: return SYNTREE_TAG_NeqIntLocLoc;
+	case SYNTREE_TAG_LeqInt: return SYNTREE_TAG_LeqIntLocLoc;
+	case SYNTREE_TAG_GeqInt: return SYNTREE_TAG_GeqIntLocLoc;
+	case SYNTREE_TAG_LstInt: return SYNTREE_TAG_LstIntLocLoc;
+	case SYNTREE_TAG_GrtInt: return SYNTREE_TAG_GrtIntLocLoc;
+	default:                 return tag;
+	}
+}
+
+/* ********************************************************* public functions */
+
+unsigned int
+fuseTree(syntree_t* self)
+{
+	syntree_node_t *node, *lhs, *rhs;
+	syntree_node_tag tag;
+	unsigned int count = 0, id;
+
+	/* Operatoren: Kinder sind Blätter, die Reihenfolge spielt keine Rolle */
+	for (id = 1; id < self->len; ++id)
+	{
+		node = syntreeNodePtr(self, id);
+		tag = node->tag;
+
+		if (tag < SYNTREE_TAG_PlusInt || tag > SYNTREE_TAG_GrtFloat
+		 || tag == SYNTREE_TAG_UminusInt || tag == SYNTREE_TAG_UminusFloat)
+			continue;
+
+		lhs = syntreeNodePtr(self, node->value.container.first);
+		rhs = syntreeNodePtr(self, node->value.container.last);
+
+		if (lhs->tag != SYNTREE_TAG_LocVar)
+			continue;
+
+		if (rhs->tag == SYNTREE_TAG_Integer || rhs->tag == SYNTREE_TAG_Float)
+			node->tag = fuseLocK(tag);
+		else if (rhs->tag == SYNTREE_TAG_LocVar)
+			node->tag = fuseLocLoc(tag);
+
+		count += (node->tag != tag);
+	}
+
+	/* Zuweisungen: setzt die fusionierten Operatoren voraus */
+	for (id = 1; id < self->len; ++id)
+	{
+		node = syntreeNodePtr(self, id);
+
+		if (node->tag != SYNTREE_TAG_Assign)
+			continue;
+
+		lhs = syntreeNodePtr(self, node->value.container.first);
+		rhs = syntreeNodePtr(self, node->value.container.last);
+
+		if (lhs->tag == SYNTREE_TAG_LocVar && rhs->tag == SYNTREE_TAG_PlusIntLocK)
+		{
+			node->tag = SYNTREE_TAG_AssignLocPlusK;
+			++count;
+		}
+	}
+
+	return count;
+}
@@ -0,0 +1,38 @@
+/***************************************************************************//**
+ * @file fuse.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält einen Durchlauf, der häufige kleine Teilbäume durch
+ * fusionierte Knotenarten (Superinstruktionen) ersetzt.
+ * @details
+ * Die Muster wurden nach der Anzahl der Dispatches auf den Beispielprogrammen
+ * ausgewählt:
+ *  - \c LocVar \c op \c Konstante (z.B. <tt>n - 1</tt>, <tt>n <= 1</tt>)
+ *    wird zu \c PlusIntLocK, \c LeqIntLocK usw.,
+ *  - \c LocVar \c op \c LocVar bei Ganzzahlvergleichen (<tt>i < n</tt>)
+ *    wird zu \c LstIntLocLoc usw.,
+ *  - <tt>Assign(LocVar, PlusInt(LocVar, Integer))</tt> (<tt>i = i + 1</tt>)
+ *    wird zu \c AssignLocPlusK.
+ *
+ * Die Kindknoten bleiben unverändert erhalten; die zugehörigen
+ * Interpreterfunktionen lesen Variablenindex und Konstante direkt aus ihnen,
+ * ohne sie zu dispatchen. Der Durchlauf setzt die Knotenarten von
+ * quickenTree() voraus und ist wie dieser nur für den Bauminterpreter gedacht.
+ ******************************************************************************/
+
+#ifndef FUSE_H_INCLUDED
+#define FUSE_H_INCLUDED
+
+/* *** includes ************************************************************* */
+
+#include "syntree.h"
+
+/* *** interface ************************************************************ */
+
+/**@brief Ersetzt alle passenden Teilbäume durch fusionierte Knotenarten.
+ * @param self  der (bereits spezialisierte) Syntaxbaum
+ * @return Anzahl der ersetzten Knoten
+ */
+extern unsigned int
+fuseTree(syntree_t* self);
+
+#endif /* FUSE_H_INCLUDED */
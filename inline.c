@@ -0,0 +1,863 @@
+/***************************************************************************//**
+ * @file inline.c
+ * @author Dorian Weber und die Studenten
+ * @brief Implementation des Einsetzens kleiner Funktionen.
+ ******************************************************************************/
+
+#include "inline.h"
+#include "definite.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ******************************************************* private structures */
+
+/**@brief Bearbeitungsstand und Urteil über eine Funktion.
+ */
+typedef enum inline_state_e
+{
+	INLINE_STATE_Pending,   /**<@brief Noch nicht bearbeitet. */
+	INLINE_STATE_Active,    /**<@brief Wird gerade bearbeitet. */
+	INLINE_STATE_Eligible,  /**<@brief Kann eingesetzt werden. */
+	INLINE_STATE_Recursive, /**<@brief Ruft sich selbst auf. */
+	INLINE_STATE_Size,      /**<@brief Überschreitet das Budget. */
+	INLINE_STATE_Loop,      /**<@brief Springt aus einer Schleife zurück. */
+	INLINE_STATE_Path,      /**<@brief Liefert nicht auf jedem Pfad einen Wert. */
+	INLINE_STATE_Uninit,    /**<@brief Kann Variablen vor der Zuweisung lesen. */
+} inline_state;
+
+/**@brief Begründungen der Urteile für den Bericht.
+ */
+static const char* const stateName[] = {
+	"not processed",
+	"recursive",
+	"inlined",
+	"recursive",
+	"body exceeds budget",
+	"returns from inside a loop",
+	"does not return a value on every path",
+	"may read a variable before assigning it",
+};
+
+/**@brief Zustand des Durchlaufs.
+ */
+typedef struct inline_ctx_s
+{
+	syntree_t* tree;         /**<@brief Der Syntaxbaum. */
+	unsigned int len;        /**<@brief Knotenanzahl vor dem Durchlauf. */
+	unsigned int budget;     /**<@brief Maximale Knotenanzahl eines Körpers. */
+	FILE* report;            /**<@brief Ausgabestrom des Berichts oder NULL. */
+	const symtab_t* tab;     /**<@brief Symboltabelle für den Bericht. */
+	unsigned char* state;    /**<@brief Funktion -> inline_state. */
+	unsigned int* size;      /**<@brief Funktion -> Knotenanzahl des Körpers. */
+	definite_t defs;         /**<@brief Vor der Zuweisung lesbare Plätze. */
+	syntree_nid func;        /**<@brief Der gerade bearbeitete Aufrufer. */
+	unsigned int count;      /**<@brief Anzahl der eingesetzten Aufrufe. */
+} inline_ctx_t;
+
+/* ******************************************************** private functions */
+
+/**@brief Gibt einen Zeiger auf einen Knoten zurück.
+ * @note Der Zeiger ist nach dem Anlegen neuer Knoten ungültig.
+ */
+static inline syntree_node_t*
+ptr(const inline_ctx_t* ctx, syntree_nid id)
+{
+	return syntreeNodePtr(ctx->tree, id);
+}
+
+/**@brief Legt eine Kopie eines einzelnen Knotens ohne Nachfolger an.
+ */
+static syntree_nid
+clone(inline_ctx_t* ctx, syntree_nid id)
+{
+	syntree_nid res = syntreeNodeVariable(ctx->tree, NULL);
+
+	*ptr(ctx, res) = *ptr(ctx, id);
+	ptr(ctx, res)->next = 0;
+	return res;
+}
+
+/**@brief Legt eine lokale Variable an.
+ */
+static syntree_nid
+variable(inline_ctx_t* ctx, unsigned int slot, syntree_node_type type)
+{
+	syntree_nid id = syntreeNodeVariable(ctx->tree, NULL);
+	syntree_node_t* node = ptr(ctx, id);
+
+	node->tag = SYNTREE_TAG_LocVar;
+	node->type = type;
+	node->value.variable = slot;
+	return id;
+}
+
+/**@brief Legt eine Zuweisung an eine lokale Variable an.
+ */
+static syntree_nid
+assign(inline_ctx_t* ctx, unsigned int slot, syntree_nid expr)
+{
+	syntree_nid var = variable(ctx, slot, ptr(ctx, expr)->type);
+	return syntreeNodePair(ctx->tree, SYNTREE_TAG_Assign, var, expr);
+}
+
+/**@brief Zählt die Knoten eines Teilbaumes.
+ */
+static unsigned int
+count(const inline_ctx_t* ctx, syntree_nid id)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	unsigned int res = 1;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+		return 1;
+
+	case SYNTREE_TAG_Call:
+	case SYNTREE_TAG_TailCall:
+		return 1 + count(ctx, node->value.container.first);
+
+	default:
+		break;
+	}
+
+	for (id = node->value.container.first; id != 0; id = ptr(ctx, id)->next)
+		res += count(ctx, id);
+
+	return res;
+}
+
+/**@brief Prüft, ob ein Ausdruck eine Zuweisung enthält.
+ */
+static int
+assigns(const inline_ctx_t* ctx, syntree_nid id)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Assign:
+		return 1;
+
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+		return 0;
+
+	case SYNTREE_TAG_Call:
+	case SYNTREE_TAG_TailCall:
+		id = ptr(ctx, node->value.container.first)->value.container.first;
+		break;
+
+	default:
+		id = node->value.container.first;
+		break;
+	}
+
+	for (; id != 0; id = ptr(ctx, id)->next)
+		if (assigns(ctx, id))
+			return 1;
+
+	return 0;
+}
+
+/**@brief Prüft, ob ein Teilbaum eine Funktion (indirekt) aufruft.
+ * @param seen  Funktion -> bereits durchsucht
+ */
+static int
+reaches(const inline_ctx_t* ctx, syntree_nid id, syntree_nid func,
+        unsigned char* seen)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	syntree_nid callee;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+		return 0;
+
+	case SYNTREE_TAG_Call:
+	case SYNTREE_TAG_TailCall:
+		callee = node->value.container.last;
+
+		if (callee == func)
+			return 1;
+
+		if (!seen[callee])
+		{
+			seen[callee] = 1;
+
+			if (reaches(ctx, ptr(ctx, callee)->value.function.body, func, seen))
+				return 1;
+		}
+
+		id = ptr(ctx, node->value.container.first)->value.container.first;
+		break;
+
+	default:
+		id = node->value.container.first;
+		break;
+	}
+
+	for (; id != 0; id = ptr(ctx, id)->next)
+		if (reaches(ctx, id, func, seen))
+			return 1;
+
+	return 0;
+}
+
+/**@brief Prüft, ob jeder Pfad durch eine Anweisung mit einem Rücksprung
+ * endet.
+ */
+static int
+returns(const inline_ctx_t* ctx, syntree_nid id)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	syntree_nid cons;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Return:
+		return 1;
+
+	case SYNTREE_TAG_Sequence:
+		for (id = node->value.container.first; id != 0; id = ptr(ctx, id)->next)
+			if (returns(ctx, id))
+				return 1;
+
+		return 0;
+
+	case SYNTREE_TAG_If:
+		cons = ptr(ctx, node->value.container.first)->next;
+		id = ptr(ctx, cons)->next;
+		return id != 0 && returns(ctx, cons) && returns(ctx, id);
+
+	default:
+		return 0;
+	}
+}
+
+/**@brief Bringt Rücksprünge aus Verzweigungen ans Ende des Körpers.
+ * @details
+ * Folgen einer Verzweigung, deren einer Zweig immer zurückspringt, noch
+ * Anweisungen, werden diese in den anderen Zweig verschoben:
+ * <tt>if (c) return a; Rest</tt> wird zu <tt>if (c) return a; else { Rest }</tt>.
+ */
+static void
+normalize(inline_ctx_t* ctx, syntree_nid id)
+{
+	syntree_nid child, cons, alt, rest, seq, last;
+
+	switch (ptr(ctx, id)->tag)
+	{
+	case SYNTREE_TAG_Sequence:
+		for (child = ptr(ctx, id)->value.container.first; child != 0;
+		     child = ptr(ctx, child)->next)
+		{
+			normalize(ctx, child);
+			rest = ptr(ctx, child)->next;
+
+			if (rest == 0 || ptr(ctx, child)->tag != SYNTREE_TAG_If)
+				continue;
+
+			cons = ptr(ctx, ptr(ctx, child)->value.container.first)->next;
+			alt = ptr(ctx, cons)->next;
+
+			if (alt != 0 && returns(ctx, alt) && !returns(ctx, cons))
+			{
+				/* der Rest gehört in den Zweig, der nicht zurückspringt */
+				seq = syntreeNodeTag(ctx->tree, SYNTREE_TAG_Sequence, cons);
+				ptr(ctx, cons)->next = 0;
+				ptr(ctx, ptr(ctx, child)->value.container.first)->next = seq;
+				ptr(ctx, seq)->next = alt;
+			}
+			else if (returns(ctx, cons) && (alt == 0 || !returns(ctx, alt)))
+			{
+				seq = (alt != 0) ? syntreeNodeTag(ctx->tree, SYNTREE_TAG_Sequence, alt)
+				                 : syntreeNodeEmpty(ctx->tree, SYNTREE_TAG_Sequence);
+				ptr(ctx, cons)->next = seq;
+				ptr(ctx, child)->value.container.last = seq;
+			}
+			else
+				continue;
+
+			/* Verkettung des Rests übernehmen */
+			last = ptr(ctx, id)->value.container.last;
+			syntreeNodeAppend(ctx->tree, seq, rest);
+			ptr(ctx, seq)->value.container.last = last;
+			ptr(ctx, child)->next = 0;
+			ptr(ctx, id)->value.container.last = child;
+
+			normalize(ctx, seq);
+			break;
+		}
+		break;
+
+	case SYNTREE_TAG_If:
+		cons = ptr(ctx, ptr(ctx, id)->value.container.first)->next;
+		normalize(ctx, cons);
+
+		if ((alt = ptr(ctx, cons)->next) != 0)
+			normalize(ctx, alt);
+		break;
+
+	default:
+		break;
+	}
+}
+
+/**@brief Prüft, ob alle Rücksprünge einer Anweisung den Körper verlassen.
+ * @param tail  != 0, falls nach der Anweisung der Funktionskörper endet
+ */
+static int
+tails(const inline_ctx_t* ctx, syntree_nid id, int tail)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	syntree_nid cons;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Return:
+		return tail;
+
+	case SYNTREE_TAG_Sequence:
+		for (id = node->value.container.first; id != 0; id = ptr(ctx, id)->next)
+			if (!tails(ctx, id, tail && ptr(ctx, id)->next == 0))
+				return 0;
+
+		return 1;
+
+	case SYNTREE_TAG_If:
+		cons = ptr(ctx, node->value.container.first)->next;
+		id = ptr(ctx, cons)->next;
+		return tails(ctx, cons, tail) && (id == 0 || tails(ctx, id, tail));
+
+	case SYNTREE_TAG_For:
+	case SYNTREE_TAG_While:
+	case SYNTREE_TAG_DoWhile:
+		return tails(ctx, node->value.container.last, 0);
+
+	default:
+		return 1;
+	}
+}
+
+/**@brief Beurteilt eine bearbeitete Funktion.
+ */
+static inline_state
+judge(inline_ctx_t* ctx, syntree_nid func, syntree_node_type type)
+{
+	syntree_nid body = ptr(ctx, func)->value.function.body;
+	unsigned char* seen;
+	int recursive;
+
+	if ((seen = calloc(ctx->len, 1)) == NULL)
+	{
+		fputs("out-of-memory error\n", stderr);
+		exit(-1);
+	}
+
+	recursive = reaches(ctx, body, func, seen);
+	free(seen);
+
+	if (recursive)
+		return INLINE_STATE_Recursive;
+
+	if (ctx->defs.start[func] != ctx->defs.start[func + 1])
+		return INLINE_STATE_Uninit;
+
+	if ((ctx->size[func] = count(ctx, body)) > ctx->budget)
+		return INLINE_STATE_Size;
+
+	normalize(ctx, body);
+
+	if (!tails(ctx, body, 1))
+		return INLINE_STATE_Loop;
+
+	if (type != SYNTREE_TYPE_Void && !returns(ctx, body))
+		return INLINE_STATE_Path;
+
+	return INLINE_STATE_Eligible;
+}
+
+/**@brief Kopiert einen Teilbaum.
+ * @param ctx     der Durchlaufzustand
+ * @param id      Wurzel des Teilbaumes
+ * @param base    Verschiebung der lokalen Plätze
+ * @param result  Ergebnisplatz, an den Rücksprünge zuweisen
+ * @return Knoten-ID der Kopie
+ */
+static syntree_nid
+copy(inline_ctx_t* ctx, syntree_nid id, unsigned int base, unsigned int result)
+{
+	syntree_node_t node = *ptr(ctx, id);
+	syntree_nid res, child;
+	char* text;
+
+	switch (node.tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_GlobVar:
+		return clone(ctx, id);
+
+	case SYNTREE_TAG_LocVar:
+		return variable(ctx, node.value.variable + base, node.type);
+
+	case SYNTREE_TAG_String:
+		/* Zeichenketten gehören ihrem Knoten */
+		if ((text = malloc(strlen(node.value.string) + 1)) == NULL)
+		{
+			fputs("out-of-memory error\n", stderr);
+			exit(-1);
+		}
+
+		strcpy(text, node.value.string);
+		return syntreeNodeString(ctx->tree, text);
+
+	case SYNTREE_TAG_Return:
+		/* der Rücksprung verlässt den Körper ohnehin (siehe tails()) */
+		if (node.value.container.first == 0)
+			return syntreeNodeEmpty(ctx->tree, SYNTREE_TAG_Sequence);
+
+		return assign(ctx, result, copy(ctx, node.value.container.first, base, result));
+
+	case SYNTREE_TAG_Call:
+	case SYNTREE_TAG_TailCall:
+		child = copy(ctx, node.value.container.first, base, result);
+		res = syntreeNodeTag(ctx->tree, node.tag, child);
+		ptr(ctx, res)->type = node.type;
+		ptr(ctx, res)->value.container.last = node.value.container.last;
+		return res;
+
+	default:
+		res = syntreeNodeEmpty(ctx->tree, node.tag);
+		ptr(ctx, res)->type = node.type;
+
+		for (id = node.value.container.first; id != 0; id = ptr(ctx, id)->next)
+			syntreeNodeAppend(ctx->tree, res, copy(ctx, id, base, result));
+
+		return res;
+	}
+}
+
+/**@brief Sucht den ersten Aufruf in Auswertungsreihenfolge, der aus einem
+ * Ausdruck herausgezogen werden kann.
+ * @param ctx    der Durchlaufzustand
+ * @param id     der Ausdruck
+ * @param clean  != 0, solange alles bisher Ausgewertete vor dem Aufruf
+ *               ausgewertet werden darf
+ * @return Knoten-ID des Aufrufs oder 0
+ */
+static syntree_nid
+candidate(const inline_ctx_t* ctx, syntree_nid id, int* clean)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	syntree_nid child, res;
+	int before = *clean;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_LocVar:
+		return 0;
+
+	case SYNTREE_TAG_GlobVar:
+		/* der Aufruf könnte die Variable verändern */
+		*clean = 0;
+		return 0;
+
+	case SYNTREE_TAG_Call:
+		for (child = ptr(ctx, node->value.container.first)->value.container.first;
+		     child != 0; child = ptr(ctx, child)->next)
+			if ((res = candidate(ctx, child, clean)) != 0)
+				return res;
+
+		/* die Argumente werden vor dem Körper in Reihenfolge ausgewertet */
+		if (before && ctx->state[node->value.container.last] == INLINE_STATE_Eligible
+		 && !assigns(ctx, node->value.container.first))
+			return id;
+
+		*clean = 0;
+		return 0;
+
+	case SYNTREE_TAG_Assign:
+		if ((res = candidate(ctx, ptr(ctx, node->value.container.first)->next, clean)) != 0)
+			return res;
+
+		*clean = 0;
+		return 0;
+
+	case SYNTREE_TAG_LogOr:
+	case SYNTREE_TAG_LogAnd:
+		/* der rechte Operand wird nur bedingt ausgewertet */
+		if ((res = candidate(ctx, node->value.container.first, clean)) != 0)
+			return res;
+
+		*clean = 0;
+		return 0;
+
+	default:
+		for (child = node->value.container.first; child != 0;
+		     child = ptr(ctx, child)->next)
+			if ((res = candidate(ctx, child, clean)) != 0)
+				return res;
+
+		/* eine Division kann abbrechen */
+		if (node->tag == SYNTREE_TAG_Divide)
+			*clean = 0;
+
+		return 0;
+	}
+}
+
+/**@brief Sucht den nächsten einsetzbaren Aufruf im Ausdruck einer Anweisung.
+ */
+static syntree_nid
+site(const inline_ctx_t* ctx, syntree_nid id)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	syntree_nid first = node->value.container.first;
+	int clean = 1;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Assign:
+		return candidate(ctx, ptr(ctx, first)->next, &clean);
+
+	case SYNTREE_TAG_Print:
+	case SYNTREE_TAG_Return:
+		return (first != 0) ? candidate(ctx, first, &clean) : 0;
+
+	case SYNTREE_TAG_Call:
+		return candidate(ctx, id, &clean);
+
+	case SYNTREE_TAG_If:
+	case SYNTREE_TAG_While:
+	case SYNTREE_TAG_DoWhile:
+		return candidate(ctx, first, &clean);
+
+	case SYNTREE_TAG_For:
+		return candidate(ctx, ptr(ctx, first)->next, &clean);
+
+	default:
+		return 0;
+	}
+}
+
+/**@brief Macht aus einer Anweisung den Block <tt>{ pre; Anweisung }</tt>.
+ * @return neue Knoten-ID der Anweisung
+ */
+static syntree_nid
+wrap(inline_ctx_t* ctx, syntree_nid id, syntree_nid pre)
+{
+	syntree_nid stmt = clone(ctx, id);
+	syntree_node_t* node = ptr(ctx, id);
+
+	node->tag = SYNTREE_TAG_Sequence;
+	node->type = SYNTREE_TYPE_Void;
+	node->value.container.first = node->value.container.last = 0;
+	syntreeNodeAppend(ctx->tree, id, pre);
+	syntreeNodeAppend(ctx->tree, id, stmt);
+	return stmt;
+}
+
+static void
+statement(inline_ctx_t* ctx, syntree_nid id);
+
+/**@brief Setzt einen Aufruf ein.
+ * @param ctx   der Durchlaufzustand
+ * @param id    die Anweisung, die den Aufruf enthält
+ * @param call  der Aufruf
+ * @return neue Knoten-ID der Anweisung oder 0, falls sie nur aus dem Aufruf
+ *         bestand
+ */
+static syntree_nid
+hoist(inline_ctx_t* ctx, syntree_nid id, syntree_nid call)
+{
+	syntree_nid func = ptr(ctx, call)->value.container.last;
+	syntree_node_type type = ptr(ctx, call)->type;
+	unsigned int base = ptr(ctx, ctx->func)->value.function.locals;
+	unsigned int result = base + ptr(ctx, func)->value.function.locals;
+	syntree_nid pre, arg, next, init, cond, step, body, again;
+	unsigned int i = 0;
+
+	ptr(ctx, ctx->func)->value.function.locals = result + (type != SYNTREE_TYPE_Void);
+
+	if (ctx->report != NULL)
+		fprintf(ctx->report, "inline: function %s (%u nodes) into function %s\n",
+		        symtabFunctionName(ctx->tab, func), ctx->size[func],
+		        symtabFunctionName(ctx->tab, ctx->func));
+
+	++ctx->count;
+
+	/* Parameter = Argumente; Körper */
+	pre = syntreeNodeEmpty(ctx->tree, SYNTREE_TAG_Sequence);
+
+	for (arg = ptr(ctx, ptr(ctx, call)->value.container.first)->value.container.first;
+	     arg != 0; arg = next, ++i)
+	{
+		next = ptr(ctx, arg)->next;
+		ptr(ctx, arg)->next = 0;
+		syntreeNodeAppend(ctx->tree, pre, assign(ctx, base + i, arg));
+	}
+
+	body = copy(ctx, ptr(ctx, func)->value.function.body, base, result);
+	syntreeNodeAppend(ctx->tree, pre, body);
+
+	/* Aufrufe in den Argumenten */
+	statement(ctx, pre);
+
+	if (call == id)
+	{
+		next = ptr(ctx, id)->next;
+		*ptr(ctx, id) = *ptr(ctx, pre);
+		ptr(ctx, id)->next = next;
+		return 0;
+	}
+
+	ptr(ctx, call)->tag = SYNTREE_TAG_LocVar;
+	ptr(ctx, call)->value.variable = result;
+
+	switch (ptr(ctx, id)->tag)
+	{
+	case SYNTREE_TAG_DoWhile:
+		/* do { Körper; pre } while (Bedingung) */
+		body = syntreeNodeTag(ctx->tree, SYNTREE_TAG_Sequence,
+		                      ptr(ctx, id)->value.container.last);
+		syntreeNodeAppend(ctx->tree, body, pre);
+		ptr(ctx, ptr(ctx, id)->value.container.first)->next = body;
+		ptr(ctx, id)->value.container.last = body;
+		return id;
+
+	case SYNTREE_TAG_While:
+		/* pre; while (Bedingung) { Körper; pre } */
+		again = copy(ctx, pre, 0, 0);
+		body = syntreeNodeTag(ctx->tree, SYNTREE_TAG_Sequence,
+		                      ptr(ctx, id)->value.container.last);
+		syntreeNodeAppend(ctx->tree, body, again);
+		ptr(ctx, ptr(ctx, id)->value.container.first)->next = body;
+		ptr(ctx, id)->value.container.last = body;
+		return wrap(ctx, id, pre);
+
+	case SYNTREE_TAG_For:
+		/* Init; pre; while (Bedingung) { Körper; Schritt; pre } */
+		init = ptr(ctx, id)->value.container.first;
+		cond = ptr(ctx, init)->next;
+		step = ptr(ctx, cond)->next;
+		body = ptr(ctx, step)->next;
+		ptr(ctx, init)->next = ptr(ctx, step)->next = 0;
+
+		again = copy(ctx, pre, 0, 0);
+		body = syntreeNodeTag(ctx->tree, SYNTREE_TAG_Sequence, body);
+		syntreeNodeAppend(ctx->tree, body, step);
+		syntreeNodeAppend(ctx->tree, body, again);
+		body = syntreeNodePair(ctx->tree, SYNTREE_TAG_While, cond, body);
+
+		ptr(ctx, id)->tag = SYNTREE_TAG_Sequence;
+		ptr(ctx, id)->value.container.first = ptr(ctx, id)->value.container.last = 0;
+		syntreeNodeAppend(ctx->tree, id, init);
+		syntreeNodeAppend(ctx->tree, id, pre);
+		syntreeNodeAppend(ctx->tree, id, body);
+		return body;
+
+	default:
+		return wrap(ctx, id, pre);
+	}
+}
+
+/**@brief Setzt alle einsetzbaren Aufrufe einer Anweisung ein.
+ */
+static void
+statement(inline_ctx_t* ctx, syntree_nid id)
+{
+	syntree_nid call, child;
+
+	while ((call = site(ctx, id)) != 0)
+		if ((id = hoist(ctx, id, call)) == 0)
+			return;
+
+	switch (ptr(ctx, id)->tag)
+	{
+	case SYNTREE_TAG_Sequence:
+		for (child = ptr(ctx, id)->value.container.first; child != 0;
+		     child = ptr(ctx, child)->next)
+			statement(ctx, child);
+		break;
+
+	case SYNTREE_TAG_If:
+		for (child = ptr(ctx, ptr(ctx, id)->value.container.first)->next;
+		     child != 0; child = ptr(ctx, child)->next)
+			statement(ctx, child);
+		break;
+
+	case SYNTREE_TAG_For:
+	case SYNTREE_TAG_While:
+	case SYNTREE_TAG_DoWhile:
+		statement(ctx, ptr(ctx, id)->value.container.last);
+		break;
+
+	default:
+		break;
+	}
+}
+
+/**@brief Sammelt die Rückgabetypen aller aufgerufenen Funktionen.
+ */
+static void
+types(const inline_ctx_t* ctx, syntree_node_type* type)
+{
+	const syntree_node_t* node;
+	unsigned int id;
+
+	for (id = 1; id < ctx->len; ++id)
+	{
+		node = ptr(ctx, id);
+
+		if (node->tag == SYNTREE_TAG_Call || node->tag == SYNTREE_TAG_TailCall)
+			type[node->value.container.last] = node->type;
+	}
+}
+
+/**@brief Bearbeitet alle von einem Teilbaum aufgerufenen Funktionen.
+ */
+static void process(inline_ctx_t* ctx, syntree_nid func,
+                    const syntree_node_type* type);
+
+static void
+callees(inline_ctx_t* ctx, syntree_nid id, const syntree_node_type* type)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+		return;
+
+	case SYNTREE_TAG_Call:
+	case SYNTREE_TAG_TailCall:
+		process(ctx, node->value.container.last, type);
+		id = ptr(ctx, ptr(ctx, id)->value.container.first)->value.container.first;
+		break;
+
+	default:
+		id = node->value.container.first;
+		break;
+	}
+
+	for (; id != 0; id = ptr(ctx, id)->next)
+		callees(ctx, id, type);
+}
+
+/**@brief Bearbeitet eine Funktion nach allen Funktionen, die sie aufruft.
+ */
+static void
+process(inline_ctx_t* ctx, syntree_nid func, const syntree_node_type* type)
+{
+	if (ctx->state[func] != INLINE_STATE_Pending)
+		return;
+
+	ctx->state[func] = INLINE_STATE_Active;
+	callees(ctx, ptr(ctx, func)->value.function.body, type);
+
+	ctx->func = func;
+	statement(ctx, ptr(ctx, func)->value.function.body);
+	ctx->state[func] = judge(ctx, func, type[func]);
+}
+
+/* ********************************************************* public functions */
+
+unsigned int
+inlineTree(syntree_t* self, unsigned int budget, FILE* report,
+           const symtab_t* tab)
+{
+	inline_ctx_t ctx;
+	syntree_node_type* type;
+	unsigned int* kept;
+	unsigned int id;
+	const syntree_node_t* node;
+
+	ctx.tree = self;
+	ctx.len = self->len;
+	ctx.budget = budget;
+	ctx.report = report;
+	ctx.tab = tab;
+	ctx.count = 0;
+	ctx.state = calloc(ctx.len, 1);
+	ctx.size = calloc(ctx.len, sizeof(*ctx.size));
+	type = calloc(ctx.len, sizeof(*type));
+	kept = calloc(ctx.len, sizeof(*kept));
+
+	if (ctx.state == NULL || ctx.size == NULL || type == NULL || kept == NULL
+	 || definiteInit(&ctx.defs, self))
+	{
+		fputs("out-of-memory error\n", stderr);
+		exit(-1);
+	}
+
+	types(&ctx, type);
+
+	for (id = 1; id < ctx.len; ++id)
+		if (ptr(&ctx, id)->tag == SYNTREE_TAG_Function)
+			process(&ctx, id, type);
+
+	/* verbliebene Aufrufe und ihre Gründe */
+	if (report != NULL)
+	{
+		for (id = 1; id < self->len; ++id)
+		{
+			node = ptr(&ctx, id);
+
+			if (node->tag == SYNTREE_TAG_Call || node->tag == SYNTREE_TAG_TailCall)
+				++kept[node->value.container.last];
+		}
+
+		for (id = 1; id < ctx.len; ++id)
+		{
+			if (kept[id] == 0)
+				continue;
+
+			if (ctx.state[id] == INLINE_STATE_Eligible)
+				fprintf(report, "inline: function %s kept at %u call(s): "
+				        "call cannot be moved out of its expression\n",
+				        symtabFunctionName(tab, id), kept[id]);
+			else if (ctx.state[id] == INLINE_STATE_Size)
+				fprintf(report, "inline: function %s kept at %u call(s): %s "
+				        "(%u > %u nodes)\n", symtabFunctionName(tab, id), kept[id],
+				        stateName[ctx.state[id]], ctx.size[id], budget);
+			else
+				fprintf(report, "inline: function %s kept at %u call(s): %s\n",
+				        symtabFunctionName(tab, id), kept[id],
+				        stateName[ctx.state[id]]);
+		}
+	}
+
+	definiteRelease(&ctx.defs);
+	free(ctx.state);
+	free(ctx.size);
+	free(type);
+	free(kept);
+	return ctx.count;
+}
@@ -0,0 +1,74 @@
+/***************************************************************************//**
+ * @file inline.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält einen Durchlauf, der kleine, nicht rekursive Funktionen an
+ * ihren Aufrufstellen einsetzt.
+ * @details
+ * Hier ist ein Beispiel für die Benutzung:
+ * @code
+ * inlineTree(ast, 40, stderr, tab);
+ * @endcode
+ *
+ * Da C1 keine bedingten Ausdrücke kennt, wird ein Aufruf aus seinem Ausdruck
+ * herausgezogen: vor der Anweisung, die ihn enthält, werden die Argumente
+ * neuen Plätzen im Rahmen des Aufrufers zugewiesen, danach folgt eine Kopie
+ * des Funktionskörpers, deren lokale Variablen auf diese Plätze verschoben
+ * sind, und der Aufruf selbst wird zum Lesen eines Ergebnisplatzes. Aus
+ * @code
+ * float abs(float val) {
+ *     if (val > 0) return val;
+ *     return -val;
+ * }
+ * ...
+ * while (abs(x - y) > 1e-5) { ... }
+ * @endcode
+ * wird dann sinngemäß
+ * @code
+ * v = x - y; if (v > 0) r = v; else r = -v;
+ * while (r > 1e-5) { ...; v = x - y; if (v > 0) r = v; else r = -v; }
+ * @endcode
+ * Die Bedingung einer Schleife wird dazu am Ende des Körpers erneut
+ * berechnet, \c for-Schleifen werden zu \c while-Schleifen.
+ *
+ * Eingesetzt werden nur Funktionen,
+ *  - die sich weder direkt noch indirekt selbst aufrufen,
+ *  - deren Körper höchstens \c budget Knoten umfasst,
+ *  - deren Rücksprünge nicht in Schleifen stehen; ein Rücksprung in einer
+ *    Verzweigung, hinter der noch Anweisungen folgen, wird vorher in die
+ *    Form <tt>if (c) return a; else { Rest }</tt> gebracht, so dass jeder
+ *    Rücksprung den Körper verlässt und zur Zuweisung an den Ergebnisplatz
+ *    werden kann,
+ *  - die auf jedem Pfad einen Wert zurückgeben, falls sie nicht \c void sind,
+ *  - die keine Variable vor ihrer Zuweisung lesen können (siehe definite.h).
+ *
+ * Ein Aufruf wird nur herausgezogen, wenn im Ausdruck vor ihm nur Konstanten,
+ * lokale Variablen und Operatoren ohne Division ausgewertet werden, seine
+ * Argumente nichts zuweisen und er nicht rechts von \c && oder \c || steht.
+ * Funktionen werden vor ihren Aufrufern bearbeitet, eingesetzte Körper
+ * enthalten also bereits die Körper ihrer eigenen kleinen Hilfsfunktionen.
+ * Der Durchlauf muss vor definiteInit() laufen, da er neue Plätze einführt.
+ ******************************************************************************/
+
+#ifndef INLINE_H_INCLUDED
+#define INLINE_H_INCLUDED
+
+/* *** includes ************************************************************* */
+
+#include "syntree.h"
+#include "symtab.h"
+#include <stdio.h>
+
+/* *** interface ************************************************************ */
+
+/**@brief Setzt kleine, nicht rekursive Funktionen an ihren Aufrufstellen ein.
+ * @param self    der Syntaxbaum
+ * @param budget  maximale Knotenanzahl eines eingesetzten Funktionskörpers
+ * @param report  Ausgabestrom für die Entscheidungen oder \c NULL
+ * @param tab     Symboltabelle für die Funktionsnamen im Bericht
+ * @return Anzahl der eingesetzten Aufrufe
+ */
+extern unsigned int
+inlineTree(syntree_t* self, unsigned int budget, FILE* report,
+           const symtab_t* tab);
+
+#endif /* INLINE_H_INCLUDED */
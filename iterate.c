@@ -0,0 +1,508 @@
+/***************************************************************************//**
+ * @file iterate.c
+ * @author Dorian Weber und die Studenten
+ * @brief Implementation der Umformung linearer Rekursion in Schleifen.
+ ******************************************************************************/
+
+#include "iterate.h"
+#include "definite.h"
+#include "minako.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* ******************************************************* private structures */
+
+/**@brief Zustand während der Umformung einer Funktion.
+ */
+typedef struct iterate_ctx_s
+{
+	syntree_t* tree;       /**<@brief Der Syntaxbaum. */
+	syntree_nid func;      /**<@brief Knoten-ID der Funktion. */
+	syntree_node_tag op;   /**<@brief Operation der rekursiven Rücksprünge. */
+	unsigned int calls;    /**<@brief Anzahl der rekursiven Rücksprünge. */
+	unsigned int params;   /**<@brief Parameteranzahl der Funktion. */
+	unsigned int acc;      /**<@brief Platz des Akkumulators. */
+} iterate_ctx_t;
+
+/* ******************************************************** private functions */
+
+/**@brief Gibt einen Zeiger auf einen Knoten zurück.
+ * @note Der Zeiger ist nach dem Anlegen neuer Knoten ungültig.
+ */
+static inline syntree_node_t*
+ptr(const iterate_ctx_t* ctx, syntree_nid id)
+{
+	return syntreeNodePtr(ctx->tree, id);
+}
+
+/**@brief Prüft, ob ein Teilbaum die Funktion selbst aufruft.
+ */
+static int
+recurses(const iterate_ctx_t* ctx, syntree_nid id)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+		return 0;
+
+	case SYNTREE_TAG_Call:
+	case SYNTREE_TAG_TailCall:
+		if (node->value.container.last == ctx->func)
+			return 1;
+
+		/* nur die Argumente, der letzte Kindknoten ist die Funktion */
+		id = ptr(ctx, node->value.container.first)->value.container.first;
+		break;
+
+	default:
+		id = node->value.container.first;
+		break;
+	}
+
+	for (; id != 0; id = ptr(ctx, id)->next)
+		if (recurses(ctx, id))
+			return 1;
+
+	return 0;
+}
+
+/**@brief Prüft, ob ein Ausdruck ohne Nebeneffekte nur aus Konstanten, lokalen
+ * Variablen und Operatoren besteht.
+ * @note Solche Ausdrücke können vor statt nach dem rekursiven Aufruf
+ * ausgewertet werden. Divisionen sind ausgenommen, da sie abbrechen können.
+ */
+static int
+simple(const iterate_ctx_t* ctx, syntree_nid id)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_LocVar:
+		return 1;
+
+	case SYNTREE_TAG_Cast:
+	case SYNTREE_TAG_Plus:
+	case SYNTREE_TAG_Minus:
+	case SYNTREE_TAG_Times:
+	case SYNTREE_TAG_Uminus:
+	case SYNTREE_TAG_LogOr:
+	case SYNTREE_TAG_LogAnd:
+	case SYNTREE_TAG_Eqt:
+	case SYNTREE_TAG_Neq:
+	case SYNTREE_TAG_Leq:
+	case SYNTREE_TAG_Geq:
+	case SYNTREE_TAG_Lst:
+	case SYNTREE_TAG_Grt:
+		for (id = node->value.container.first; id != 0; id = ptr(ctx, id)->next)
+			if (!simple(ctx, id))
+				return 0;
+
+		return 1;
+
+	default:
+		return 0;
+	}
+}
+
+/**@brief Prüft, ob ein Ausdruck eine Zuweisung enthält.
+ */
+static int
+assigns(const iterate_ctx_t* ctx, syntree_nid id)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Assign:
+		return 1;
+
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+		return 0;
+
+	case SYNTREE_TAG_Call:
+	case SYNTREE_TAG_TailCall:
+		id = ptr(ctx, node->value.container.first)->value.container.first;
+		break;
+
+	default:
+		id = node->value.container.first;
+		break;
+	}
+
+	for (; id != 0; id = ptr(ctx, id)->next)
+		if (assigns(ctx, id))
+			return 1;
+
+	return 0;
+}
+
+/**@brief Zerlegt den Ausdruck eines rekursiven Rücksprungs.
+ * @param ctx   der Umformungszustand
+ * @param id    der Ausdruck
+ * @param call  Ziel für den rekursiven Aufruf
+ * @param x     Ziel für den anderen Operanden
+ * @return != 0, falls der Ausdruck die Form <tt>x op f(...)</tt> oder
+ *         <tt>f(...) op x</tt> hat
+ */
+static int
+split(const iterate_ctx_t* ctx, syntree_nid id, syntree_nid* call,
+      syntree_nid* x)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	syntree_nid arg;
+
+	if ((node->tag != SYNTREE_TAG_Plus && node->tag != SYNTREE_TAG_Times)
+	 || node->type != SYNTREE_TYPE_Integer
+	 || (ctx->calls > 0 && node->tag != ctx->op))
+		return 0;
+
+	*call = node->value.container.first;
+	*x = node->value.container.last;
+
+	if (ptr(ctx, *call)->tag != SYNTREE_TAG_Call
+	 || ptr(ctx, *call)->value.container.last != ctx->func)
+	{
+		*call = node->value.container.last;
+		*x = node->value.container.first;
+	}
+
+	if (ptr(ctx, *call)->tag != SYNTREE_TAG_Call
+	 || ptr(ctx, *call)->value.container.last != ctx->func
+	 || !simple(ctx, *x))
+		return 0;
+
+	/* die Argumente werden vor dem Operanden ausgewertet */
+	for (arg = ptr(ctx, ptr(ctx, *call)->value.container.first)->value.container.first;
+	     arg != 0; arg = ptr(ctx, arg)->next)
+		if (recurses(ctx, arg) || assigns(ctx, arg))
+			return 0;
+
+	return 1;
+}
+
+/**@brief Prüft, ob eine Anweisung umgeformt werden kann.
+ * @param ctx   der Umformungszustand
+ * @param id    die Anweisung
+ * @param tail  != 0, falls nach der Anweisung der Funktionskörper endet
+ * @return != 0, falls alle rekursiven Aufrufe in umformbaren Rücksprüngen
+ *         stehen
+ */
+static int
+check(iterate_ctx_t* ctx, syntree_nid id, int tail)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	syntree_nid first = node->value.container.first, call, x;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Return:
+		if (first == 0 || !recurses(ctx, first))
+			return 1;
+
+		if (!tail || !split(ctx, first, &call, &x))
+			return 0;
+
+		ctx->op = ptr(ctx, first)->tag;
+		++ctx->calls;
+		return 1;
+
+	case SYNTREE_TAG_Sequence:
+		for (id = first; id != 0; id = ptr(ctx, id)->next)
+			if (!check(ctx, id, tail && ptr(ctx, id)->next == 0))
+				return 0;
+
+		return 1;
+
+	case SYNTREE_TAG_If:
+		id = ptr(ctx, first)->next;
+		return !recurses(ctx, first) && check(ctx, id, tail)
+		    && (ptr(ctx, id)->next == 0 || check(ctx, ptr(ctx, id)->next, tail));
+
+	case SYNTREE_TAG_For:
+	case SYNTREE_TAG_While:
+	case SYNTREE_TAG_DoWhile:
+		for (id = first; id != 0; id = ptr(ctx, id)->next)
+			if (!check(ctx, id, 0))
+				return 0;
+
+		return 1;
+
+	default:
+		return !recurses(ctx, id);
+	}
+}
+
+/**@brief Prüft, ob jeder Pfad durch eine Anweisung mit einem Rücksprung
+ * endet.
+ * @note Sonst würde die Schleife am Ende des Körpers nicht verlassen.
+ */
+static int
+returns(const iterate_ctx_t* ctx, syntree_nid id)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	syntree_nid cons;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Return:
+		return 1;
+
+	case SYNTREE_TAG_Sequence:
+		for (id = node->value.container.first; id != 0; id = ptr(ctx, id)->next)
+			if (returns(ctx, id))
+				return 1;
+
+		return 0;
+
+	case SYNTREE_TAG_If:
+		cons = ptr(ctx, node->value.container.first)->next;
+		id = ptr(ctx, cons)->next;
+		return id != 0 && returns(ctx, cons) && returns(ctx, id);
+
+	default:
+		return 0;
+	}
+}
+
+/**@brief Legt eine lokale Variable an.
+ */
+static syntree_nid
+variable(iterate_ctx_t* ctx, unsigned int slot, syntree_node_type type)
+{
+	syntree_nid id = syntreeNodeVariable(ctx->tree, NULL);
+	syntree_node_t* node = ptr(ctx, id);
+
+	node->tag = SYNTREE_TAG_LocVar;
+	node->type = type;
+	node->value.variable = slot;
+	return id;
+}
+
+/**@brief Legt eine Zuweisung an eine lokale Variable an.
+ */
+static syntree_nid
+assign(iterate_ctx_t* ctx, unsigned int slot, syntree_nid expr)
+{
+	syntree_nid var = variable(ctx, slot, ptr(ctx, expr)->type);
+	return syntreeNodePair(ctx->tree, SYNTREE_TAG_Assign, var, expr);
+}
+
+/**@brief Verknüpft den Akkumulator mit einem Ausdruck.
+ */
+static syntree_nid
+combine(iterate_ctx_t* ctx, syntree_nid expr)
+{
+	syntree_nid acc = variable(ctx, ctx->acc, SYNTREE_TYPE_Integer);
+	syntree_nid res = syntreeNodePair(ctx->tree, ctx->op, acc, expr);
+
+	ptr(ctx, res)->type = SYNTREE_TYPE_Integer;
+	return res;
+}
+
+/**@brief Macht einen nicht mehr erreichbaren Knoten unschädlich.
+ * @note Durchläufe über alle Knoten sollen keine verwaisten Aufrufe sehen.
+ */
+static void
+discard(iterate_ctx_t* ctx, syntree_nid id)
+{
+	syntree_node_t* node = ptr(ctx, id);
+
+	node->tag = SYNTREE_TAG_Sequence;
+	node->type = SYNTREE_TYPE_Void;
+	node->value.container.first = node->value.container.last = 0;
+}
+
+/**@brief Formt einen Rücksprung um.
+ * @details
+ * Basisfälle liefern den mit dem Akkumulator verknüpften Wert, rekursive
+ * Rücksprünge werden an Ort und Stelle zu einer Sequenz, die den Akkumulator
+ * fortschreibt und die Parameter neu belegt.
+ */
+static void
+rewriteReturn(iterate_ctx_t* ctx, syntree_nid id)
+{
+	syntree_nid expr = ptr(ctx, id)->value.container.first;
+	syntree_nid call, x, args, arg, next, temp;
+	unsigned int i;
+
+	if (!recurses(ctx, expr))
+	{
+		expr = combine(ctx, expr);
+		ptr(ctx, id)->value.container.first = expr;
+		ptr(ctx, id)->value.container.last = expr;
+		return;
+	}
+
+	split(ctx, expr, &call, &x);
+	args = ptr(ctx, call)->value.container.first;
+	arg = ptr(ctx, args)->value.container.first;
+
+	ptr(ctx, x)->next = 0;
+	x = assign(ctx, ctx->acc, combine(ctx, x));
+
+	ptr(ctx, id)->tag = SYNTREE_TAG_Sequence;
+	ptr(ctx, id)->value.container.first = 0;
+	syntreeNodeAppend(ctx->tree, id, x);
+
+	if (ctx->params == 1)
+	{
+		ptr(ctx, arg)->next = 0;
+		syntreeNodeAppend(ctx->tree, id, assign(ctx, 0, arg));
+	}
+	else if (ctx->params > 1)
+	{
+		/* gleichzeitige Zuweisung über Hilfsplätze hinter dem Akkumulator */
+		for (i = 0; arg != 0; arg = next, ++i)
+		{
+			next = ptr(ctx, arg)->next;
+			ptr(ctx, arg)->next = 0;
+			syntreeNodeAppend(ctx->tree, id, assign(ctx, ctx->acc + 1 + i, arg));
+		}
+
+		for (i = 0, temp = ptr(ctx, x)->next; i < ctx->params; ++i)
+		{
+			arg = variable(ctx, ctx->acc + 1 + i,
+			               ptr(ctx, ptr(ctx, temp)->value.container.first)->type);
+			syntreeNodeAppend(ctx->tree, id, assign(ctx, i, arg));
+			temp = ptr(ctx, temp)->next;
+		}
+	}
+
+	discard(ctx, expr);
+	discard(ctx, call);
+	discard(ctx, args);
+}
+
+/**@brief Formt alle Rücksprünge innerhalb einer Anweisung um.
+ */
+static void
+rewrite(iterate_ctx_t* ctx, syntree_nid id)
+{
+	switch (ptr(ctx, id)->tag)
+	{
+	case SYNTREE_TAG_Return:
+		if (ptr(ctx, id)->value.container.first != 0)
+			rewriteReturn(ctx, id);
+		break;
+
+	case SYNTREE_TAG_Sequence:
+	case SYNTREE_TAG_If:
+	case SYNTREE_TAG_For:
+	case SYNTREE_TAG_While:
+	case SYNTREE_TAG_DoWhile:
+		/* Bedingungen enthalten keine Rücksprünge */
+		for (id = ptr(ctx, id)->value.container.first; id != 0;
+		     id = ptr(ctx, id)->next)
+			rewrite(ctx, id);
+		break;
+
+	default:
+		break;
+	}
+}
+
+/* ********************************************************* public functions */
+
+unsigned int
+iterateTree(syntree_t* self)
+{
+	const syntree_node_t* node;
+	iterate_ctx_t ctx;
+	definite_t defs;
+	unsigned int* params;
+	unsigned int count = 0, id, len = self->len, i;
+	syntree_nid arg, body, init;
+
+	/* Plätze, die vor der Zuweisung gelesen werden können, auf dem
+	 * ursprünglichen Baum */
+	if ((params = calloc(len, sizeof(*params))) == NULL
+	 || definiteInit(&defs, self))
+	{
+		fputs("out-of-memory error\n", stderr);
+		exit(-1);
+	}
+
+	/* die Parameteranzahl ergibt sich aus den Aufrufen */
+	for (id = 1; id < len; ++id)
+	{
+		node = syntreeNodePtr(self, id);
+
+		if (node->tag != SYNTREE_TAG_Call && node->tag != SYNTREE_TAG_TailCall)
+			continue;
+
+		i = 0;
+
+		for (arg = syntreeNodePtr(self, node->value.container.first)->value.container.first;
+		     arg != 0; arg = syntreeNodePtr(self, arg)->next)
+			++i;
+
+		params[node->value.container.last] = i;
+	}
+
+	ctx.tree = self;
+
+	/* neue Knoten sind keine Funktionen und werden nicht mehr besucht */
+	for (id = 1; id < len; ++id)
+	{
+		node = syntreeNodePtr(self, id);
+
+		if (node->tag != SYNTREE_TAG_Function)
+			continue;
+
+		ctx.func = id;
+		ctx.calls = 0;
+		ctx.params = params[id];
+		ctx.acc = node->value.function.locals;
+		body = node->value.function.body;
+
+		if (!check(&ctx, body, 1) || ctx.calls == 0 || !returns(&ctx, body))
+			continue;
+
+		rewrite(&ctx, body);
+
+		/* jeder Durchlauf entspricht einem neuen Aufruf und muss solche Plätze
+		 * wie der Interpreter beim Funktionseintritt mit DUMMY vorbelegen */
+		if (defs.start[id] != defs.start[id + 1])
+		{
+			init = body;
+			body = syntreeNodeEmpty(self, SYNTREE_TAG_Sequence);
+
+			for (i = defs.start[id]; i < defs.start[id + 1]; ++i)
+				syntreeNodeAppend(self, body, assign(&ctx, defs.slots[i],
+					syntreeNodeInteger(self, DUMMY)));
+
+			syntreeNodeAppend(self, body, init);
+		}
+
+		/* acc = neutrales Element; while (true) Körper */
+		init = syntreeNodeInteger(self, ctx.op == SYNTREE_TAG_Plus ? 0 : 1);
+		init = syntreeNodeTag(self, SYNTREE_TAG_Sequence, assign(&ctx, ctx.acc, init));
+		syntreeNodeAppend(self, init, syntreeNodePair(self, SYNTREE_TAG_While,
+			syntreeNodeBoolean(self, 1), body));
+
+		syntreeNodePtr(self, id)->value.function.body = init;
+		syntreeNodePtr(self, id)->value.function.locals =
+			ctx.acc + 1 + (ctx.params > 1 ? ctx.params : 0);
+		++count;
+	}
+
+	definiteRelease(&defs);
+	free(params);
+	return count;
+}
@@ -0,0 +1,58 @@
+/***************************************************************************//**
+ * @file iterate.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält einen Durchlauf, der linear rekursive Funktionen in Schleifen
+ * umformt.
+ * @details
+ * Eine Funktion mit ganzzahligem Rückgabewert wird umgeformt, wenn jeder
+ * Rücksprung entweder keinen Aufruf der Funktion selbst enthält oder die Form
+ * <tt>return x op f(...);</tt> bzw. <tt>return f(...) op x;</tt> hat, wobei
+ * \c op für alle rekursiven Rücksprünge dieselbe assoziative und kommutative
+ * Operation (\c + oder \c *) ist. Aus
+ * @code
+ * int factorial(int n) {
+ *     if (n <= 1) return 1;
+ *     return n * factorial(n - 1);
+ * }
+ * @endcode
+ * wird dann sinngemäß
+ * @code
+ * int factorial(int n) {
+ *     acc = 1;
+ *     while (true) {
+ *         if (n <= 1) return acc * 1;
+ *         { acc = acc * n; n = n - 1; }
+ *     }
+ * }
+ * @endcode
+ * mit einem zusätzlichen lokalen Platz für den Akkumulator (und bei mehreren
+ * Parametern je einem Platz pro Argument für die gleichzeitige Zuweisung).
+ * Plätze, die laut definiteInit() vor ihrer Zuweisung gelesen werden können,
+ * werden zu Beginn jedes Durchlaufs mit \c DUMMY belegt, damit kein Wert aus
+ * dem vorigen Durchlauf sichtbar bleibt.
+ *
+ * Damit die Ausführungsreihenfolge erhalten bleibt, darf der Operand \c x nur
+ * aus Konstanten, lokalen Variablen und Operatoren bestehen, die Argumente
+ * dürfen nichts zuweisen, und rekursive Rücksprünge müssen am Ende des
+ * Funktionskörpers stehen, damit die Ausführung danach zum Schleifenkopf
+ * zurückkehrt. Der Durchlauf muss vor definiteInit() laufen, da er neue
+ * Plätze einführt.
+ ******************************************************************************/
+
+#ifndef ITERATE_H_INCLUDED
+#define ITERATE_H_INCLUDED
+
+/* *** includes ************************************************************* */
+
+#include "syntree.h"
+
+/* *** interface ************************************************************ */
+
+/**@brief Formt alle linear rekursiven Funktionen in Schleifen um.
+ * @param self  der Syntaxbaum
+ * @return Anzahl der umgeformten Funktionen
+ */
+extern unsigned int
+iterateTree(syntree_t* self);
+
+#endif /* ITERATE_H_INCLUDED */
@@ -0,0 +1,857 @@
+/***************************************************************************//**
+ * @file jit.c
+ * @author Dorian Weber und die Studenten
+ * @brief Implementation des x86-64 JIT-Übersetzers.
+ * @details
+ * Der Codegenerator arbeitet mit einem Akkumulator: jeder Ausdruck hinterlässt
+ * sein Ergebnis in \c eax (Ganzzahlen, Wahrheitswerte) bzw. \c xmm0
+ * (Fließkommazahlen). Zwischenergebnisse werden auf dem Maschinenstack
+ * gesichert. Während der Ausführung einer übersetzten Funktion gilt:
+ *  - \c rbx zeigt auf den Rahmen der Funktion im Variablenstack,
+ *  - \c r12 zeigt auf den Beginn des Variablenstacks (globale Variablen),
+ *  - \c r13 zeigt auf das Ende des Variablenstacks.
+ ******************************************************************************/
+
+#define _DEFAULT_SOURCE
+
+#include "jit.h"
+#include "stack.h"
+#include "definite.h"
+#include "quota.h"
+#include "vmstack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+#if defined(__x86_64__) && defined(__linux__)
+	#include <sys/mman.h>
+	#define JIT_SUPPORTED 1
+#else
+	#define JIT_SUPPORTED 0
+#endif
+
+/* ******************************************************* private structures */
+
+/**@brief Noch aufzulösender Funktionsaufruf.
+ */
+typedef struct jit_fixup_s
+{
+	unsigned int pos;  /**<@brief Position der relativen Adresse im Code. */
+	syntree_nid func;  /**<@brief Knoten-ID der aufgerufenen Funktion. */
+} jit_fixup_t;
+
+/**@brief Zustand des Codegenerators.
+ */
+typedef struct jit_compiler_s
+{
+	const syntree_t* tree;     /**<@brief Der übersetzte Syntaxbaum. */
+	unsigned char* buf;        /**<@brief Stack des erzeugten Codes. */
+	unsigned int* start;       /**<@brief Knoten-ID -> Codeposition + 1. */
+	jit_fixup_t* calls;        /**<@brief Stack offener Funktionsaufrufe. */
+	unsigned int* returns;     /**<@brief Stack der Sprünge zum Epilog. */
+	unsigned int* overflows;   /**<@brief Stack der Sprünge zum Überlauf. */
+	unsigned int* exhausted;   /**<@brief Stack der Sprünge bei leerem Tank. */
+	definite_t defs;           /**<@brief Uninitialisiert lesbare Plätze. */
+	unsigned int locals;       /**<@brief Variablenanzahl der Funktion. */
+	unsigned int depth;        /**<@brief Anzahl gesicherter Werte. */
+} jit_compiler_t;
+
+/* ******************************************************** private functions */
+
+/* Laufzeitunterstützung (wird aus dem erzeugten Code aufgerufen) */
+
+static void
+jitPrintInt(int value)
+{
+	printf("%i\n", value);
+}
+
+static void
+jitPrintFloat(float value)
+{
+	printf("%g\n", value);
+}
+
+static void
+jitPrintBool(int value)
+{
+	puts(value ? "true" : "false");
+}
+
+static void
+jitPrintString(const char* value)
+{
+	puts(value);
+}
+
+static void
+jitPrintVoid(void)
+{
+	putc('\n', stdout);
+}
+
+static void
+jitOverflow(void)
+{
+	/* wie bei den Interpretern meldet quota.c den Überlauf */
+	quotaOverflow();
+	quotaExhausted();
+}
+
+/* Hilfsfunktionen */
+
+/**@brief Gibt den Zeiger auf einen Knoten der entsprechenden ID zurück.
+ */
+static inline const syntree_node_t*
+nodePtr(const jit_compiler_t* c, syntree_nid id)
+{
+	return syntreeNodePtr(c->tree, id);
+}
+
+/**@brief Gibt die ID des Folgeknotens eines Knotens zurück.
+ */
+static inline syntree_nid
+nodeNext(const jit_compiler_t* c, syntree_nid id)
+{
+	return nodePtr(c, id)->next;
+}
+
+/**@brief Gibt den Abstand einer Variablen zu ihrer Basis zurück.
+ */
+static inline int
+slotValue(int slot)
+{
+	return slot * (int) sizeof(minako_data_t);
+}
+
+/* Codeerzeugung */
+
+/**@brief Gibt die aktuelle Codeposition zurück.
+ */
+static inline unsigned int
+here(const jit_compiler_t* c)
+{
+	return stackCount(c->buf);
+}
+
+/**@brief Hängt eine Bytefolge an den Code an.
+ */
+static void
+emitBytes(jit_compiler_t* c, const char* bytes, unsigned int len)
+{
+	while (len-- > 0)
+		stackPush(c->buf) = (unsigned char) *bytes++;
+}
+
+/**@brief Hängt ein Stringliteral mit Maschinencode an den Code an.
+ */
+#define EMIT(C, BYTES) emitBytes(C, BYTES, sizeof(BYTES) - 1)
+
+/**@brief Hängt einen 32-Bit-Wert (little endian) an den Code an.
+ */
+static void
+emit32(jit_compiler_t* c, uint32_t value)
+{
+	int i;
+
+	for (i = 0; i < 4; ++i, value >>= 8)
+		stackPush(c->buf) = value & 0xFF;
+}
+
+/**@brief Hängt einen 64-Bit-Wert (little endian) an den Code an.
+ */
+static void
+emit64(jit_compiler_t* c, uint64_t value)
+{
+	emit32(c, (uint32_t) value);
+	emit32(c, (uint32_t) (value >> 32));
+}
+
+/**@brief Überschreibt einen 32-Bit-Wert im Code.
+ */
+static void
+patch32(jit_compiler_t* c, unsigned int pos, uint32_t value)
+{
+	int i;
+
+	for (i = 0; i < 4; ++i, value >>= 8)
+		c->buf[pos + i] = value & 0xFF;
+}
+
+/**@brief Erzeugt einen Vorwärtssprung mit dem gegebenen Opcode.
+ * @return Position der noch aufzulösenden relativen Adresse
+ */
+static unsigned int
+jumpForward(jit_compiler_t* c, const char* op, unsigned int len)
+{
+	emitBytes(c, op, len);
+	emit32(c, 0);
+	return here(c) - 4;
+}
+
+/**@brief Setzt das Ziel eines Vorwärtssprungs auf die aktuelle Position.
+ */
+static inline void
+land(jit_compiler_t* c, unsigned int pos)
+{
+	patch32(c, pos, here(c) - (pos + 4));
+}
+
+/**@brief Erzeugt einen Rückwärtssprung mit dem gegebenen Opcode.
+ */
+static void
+jumpBack(jit_compiler_t* c, const char* op, unsigned int len,
+         unsigned int target)
+{
+	emitBytes(c, op, len);
+	emit32(c, target - (here(c) + 4));
+}
+
+/**@brief Sichert den Akkumulator auf dem Maschinenstack.
+ */
+static void
+pushAcc(jit_compiler_t* c, syntree_node_type type)
+{
+	if (type == SYNTREE_TYPE_Float)
+		EMIT(c, "\x66\x0F\x7E\xC0"); /* movd eax, xmm0 */
+
+	EMIT(c, "\x50");                     /* push rax */
+	++c->depth;
+}
+
+/**@brief Ruft eine C-Funktion der Laufzeitunterstützung auf.
+ * @note Der Maschinenstack wird dabei auf 16 Byte ausgerichtet.
+ */
+static void
+callHelper(jit_compiler_t* c, void (*helper)(void))
+{
+	EMIT(c, "\x48\xB8");                 /* mov rax, imm64 */
+	emit64(c, (uint64_t) (uintptr_t) helper);
+
+	if (c->depth % 2)
+		EMIT(c, "\x48\x83\xEC\x08"); /* sub rsp, 8 */
+
+	EMIT(c, "\xFF\xD0");                 /* call rax */
+
+	if (c->depth % 2)
+		EMIT(c, "\x48\x83\xC4\x08"); /* add rsp, 8 */
+}
+
+/**@brief Verbraucht eine Einheit Treibstoff wie QUOTA_BURN().
+ * @note Überschreibt rax und darf daher nur dort stehen, wo der Akkumulator
+ * nicht belegt ist.
+ */
+static void
+genBurn(jit_compiler_t* c)
+{
+	EMIT(c, "\x48\xB8");                 /* mov rax, imm64 */
+	emit64(c, (uint64_t) (uintptr_t) &quotaFuel);
+	EMIT(c, "\x48\xFF\x08");             /* dec qword [rax] */
+	stackPush(c->exhausted) = jumpForward(c, "\x0F\x8E", 2); /* jle */
+}
+
+static void
+genExpr(jit_compiler_t* c, syntree_nid id);
+
+static void
+genStmt(jit_compiler_t* c, syntree_nid id);
+
+/**@brief Lädt einen einfachen rechten Operanden direkt nach \c ecx bzw.
+ * \c xmm1, ohne den Akkumulator zu verändern.
+ * @return 1, falls der Operand einfach war,\n
+ *         0, ansonsten
+ */
+static int
+genSimpleOperand(jit_compiler_t* c, const syntree_node_t* node)
+{
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_Float:
+		EMIT(c, "\xB9");                     /* mov ecx, imm32 */
+		emit32(c, (uint32_t) node->value.integer);
+
+		if (node->type == SYNTREE_TYPE_Float)
+			EMIT(c, "\x66\x0F\x6E\xC9"); /* movd xmm1, ecx */
+
+		return 1;
+
+	case SYNTREE_TAG_LocVar:
+		if (node->type == SYNTREE_TYPE_Float)
+			EMIT(c, "\xF3\x0F\x10\x8B"); /* movss xmm1, [rbx+disp32] */
+		else
+			EMIT(c, "\x8B\x8B");         /* mov ecx, [rbx+disp32] */
+
+		emit32(c, slotValue(node->value.variable));
+		return 1;
+
+	default:
+		return 0;
+	}
+}
+
+/**@brief Erzeugt Code für eine binäre arithmetische Operation oder einen
+ * Vergleich.
+ */
+static void
+genBinary(jit_compiler_t* c, const syntree_node_t* node)
+{
+	const syntree_node_t* lhs = nodePtr(c, node->value.container.first);
+	const syntree_node_t* rhs = nodePtr(c, node->value.container.last);
+	int isFloat = (lhs->type == SYNTREE_TYPE_Float);
+
+	/* linker Operand in eax/xmm0, rechter Operand in ecx/xmm1 */
+	genExpr(c, node->value.container.first);
+
+	if (!genSimpleOperand(c, rhs))
+	{
+		pushAcc(c, lhs->type);
+		genExpr(c, node->value.container.last);
+
+		if (isFloat)
+		{
+			EMIT(c, "\x0F\x28\xC8");     /* movaps xmm1, xmm0 */
+			EMIT(c, "\x58");             /* pop rax */
+			EMIT(c, "\x66\x0F\x6E\xC0"); /* movd xmm0, eax */
+		}
+		else
+		{
+			EMIT(c, "\x89\xC1");         /* mov ecx, eax */
+			EMIT(c, "\x58");             /* pop rax */
+		}
+
+		--c->depth;
+	}
+
+	if (isFloat) switch (node->tag)
+	{
+	case SYNTREE_TAG_Plus:   EMIT(c, "\xF3\x0F\x58\xC1"); return; /* addss */
+	case SYNTREE_TAG_Minus:  EMIT(c, "\xF3\x0F\x5C\xC1"); return; /* subss */
+	case SYNTREE_TAG_Times:  EMIT(c, "\xF3\x0F\x59\xC1"); return; /* mulss */
+	case SYNTREE_TAG_Divide: EMIT(c, "\xF3\x0F\x5E\xC1"); return; /* divss */
+
+	/* ucomiss setzt bei NaN alle Flags; die Operanden werden deshalb so
+	 * gewählt, dass nur "oberhalb"-Bedingungen vorkommen */
+	case SYNTREE_TAG_Eqt:
+		EMIT(c, "\x0F\x2E\xC1"                 /* ucomiss xmm0, xmm1 */
+		        "\x0F\x94\xC0"                 /* sete al */
+		        "\x0F\x9B\xC1"                 /* setnp cl */
+		        "\x20\xC8");                   /* and al, cl */
+		break;
+	case SYNTREE_TAG_Neq:
+		EMIT(c, "\x0F\x2E\xC1"                 /* ucomiss xmm0, xmm1 */
+		        "\x0F\x95\xC0"                 /* setne al */
+		        "\x0F\x9A\xC1"                 /* setp cl */
+		        "\x08\xC8");                   /* or al, cl */
+		break;
+	case SYNTREE_TAG_Lst:
+		EMIT(c, "\x0F\x2E\xC8\x0F\x97\xC0"); break; /* ucomiss xmm1, xmm0; seta */
+	case SYNTREE_TAG_Leq:
+		EMIT(c, "\x0F\x2E\xC8\x0F\x93\xC0"); break; /* ucomiss xmm1, xmm0; setae */
+	case SYNTREE_TAG_Grt:
+		EMIT(c, "\x0F\x2E\xC1\x0F\x97\xC0"); break; /* ucomiss xmm0, xmm1; seta */
+	case SYNTREE_TAG_Geq:
+		EMIT(c, "\x0F\x2E\xC1\x0F\x93\xC0"); break; /* ucomiss xmm0, xmm1; setae */
+	default:
+		assert(!"unexpected binary operator");
+	}
+	else switch (node->tag)
+	{
+	case SYNTREE_TAG_Plus:   EMIT(c, "\x01\xC8"); return;          /* add eax, ecx */
+	case SYNTREE_TAG_Minus:  EMIT(c, "\x29\xC8"); return;          /* sub eax, ecx */
+	case SYNTREE_TAG_Times:  EMIT(c, "\x0F\xAF\xC1"); return;      /* imul eax, ecx */
+	case SYNTREE_TAG_Divide: EMIT(c, "\x99\xF7\xF9"); return;      /* cdq; idiv ecx */
+	case SYNTREE_TAG_Eqt: EMIT(c, "\x39\xC8\x0F\x94\xC0"); break; /* cmp; sete */
+	case SYNTREE_TAG_Neq: EMIT(c, "\x39\xC8\x0F\x95\xC0"); break; /* cmp; setne */
+	case SYNTREE_TAG_Lst: EMIT(c, "\x39\xC8\x0F\x9C\xC0"); break; /* cmp; setl */
+	case SYNTREE_TAG_Leq: EMIT(c, "\x39\xC8\x0F\x9E\xC0"); break; /* cmp; setle */
+	case SYNTREE_TAG_Grt: EMIT(c, "\x39\xC8\x0F\x9F\xC0"); break; /* cmp; setg */
+	case SYNTREE_TAG_Geq: EMIT(c, "\x39\xC8\x0F\x9D\xC0"); break; /* cmp; setge */
+	default:
+		assert(!"unexpected binary operator");
+	}
+
+	/* Vergleiche: Wahrheitswert auf 32 Bit erweitern */
+	EMIT(c, "\x0F\xB6\xC0");                       /* movzx eax, al */
+}
+
+/**@brief Erzeugt Code für einen Funktionsaufruf.
+ */
+static void
+genCall(jit_compiler_t* c, const syntree_node_t* node)
+{
+	syntree_nid func = node->value.container.last;
+	unsigned int locals = nodePtr(c, func)->value.function.locals;
+	unsigned int count = 0, i;
+	jit_fixup_t* fixup;
+	syntree_nid arg;
+
+	/* werte alle Argumente aus, bevor der neue Rahmen beschrieben wird */
+	for (arg = nodePtr(c, node->value.container.first)->value.container.first;
+	     arg != 0; arg = nodeNext(c, arg), ++count)
+	{
+		genExpr(c, arg);
+		pushAcc(c, nodePtr(c, arg)->type);
+	}
+
+	for (i = count; i-- > 0; --c->depth)
+	{
+		EMIT(c, "\x58\x89\x83");             /* pop rax; mov [rbx+disp32], eax */
+		emit32(c, slotValue(c->locals + i));
+	}
+
+	/* nur Plätze, die vor ihrer Zuweisung gelesen werden können, sind wie im
+	 * Interpreter vorbelegt */
+	for (i = c->defs.start[func]; i < c->defs.start[func + 1]; ++i)
+	{
+		EMIT(c, "\xC7\x83");                 /* mov dword [rbx+disp32], imm32 */
+		emit32(c, slotValue(c->locals + c->defs.slots[i]));
+		emit32(c, (uint32_t) DUMMY);
+	}
+
+	EMIT(c, "\x48\x8D\xBB");                     /* lea rdi, [rbx+disp32] */
+	emit32(c, c->locals * sizeof(minako_data_t));
+	EMIT(c, "\x48\x8D\x87");                     /* lea rax, [rdi+disp32] */
+	emit32(c, locals * sizeof(minako_data_t));
+	EMIT(c, "\x4C\x39\xE8");                     /* cmp rax, r13 */
+	stackPush(c->overflows) = jumpForward(c, "\x0F\x83", 2); /* jae */
+	EMIT(c, "\x4C\x89\xE6");                     /* mov rsi, r12 */
+	EMIT(c, "\x4C\x89\xEA");                     /* mov rdx, r13 */
+
+	/* jeder Aufruf verbraucht Treibstoff; Aufrufe aus dem Interpreter hat
+	 * bereits execCall() gezählt */
+	genBurn(c);
+
+	if (c->depth % 2)
+		EMIT(c, "\x48\x83\xEC\x08");         /* sub rsp, 8 */
+
+	fixup = &stackPush(c->calls);
+	fixup->pos = jumpForward(c, "\xE8", 1);      /* call rel32 */
+	fixup->func = func;
+
+	if (c->depth % 2)
+		EMIT(c, "\x48\x83\xC4\x08");         /* add rsp, 8 */
+
+	if (node->type == SYNTREE_TYPE_Float)
+		EMIT(c, "\x66\x0F\x6E\xC0");         /* movd xmm0, eax */
+}
+
+/**@brief Erzeugt Code für eine Zuweisung.
+ */
+static void
+genAssign(jit_compiler_t* c, const syntree_node_t* node)
+{
+	const syntree_node_t* var = nodePtr(c, node->value.container.first);
+	int isFloat = (var->type == SYNTREE_TYPE_Float);
+
+	genExpr(c, node->value.container.last);
+
+	if (var->tag == SYNTREE_TAG_LocVar)
+	{
+		if (isFloat)
+			EMIT(c, "\xF3\x0F\x11\x83"); /* movss [rbx+disp32], xmm0 */
+		else
+			EMIT(c, "\x89\x83");         /* mov [rbx+disp32], eax */
+
+		emit32(c, slotValue(var->value.variable));
+		return;
+	}
+
+	if (isFloat)
+		EMIT(c, "\xF3\x41\x0F\x11\x84\x24"); /* movss [r12+disp32], xmm0 */
+	else
+		EMIT(c, "\x41\x89\x84\x24");         /* mov [r12+disp32], eax */
+
+	emit32(c, slotValue(var->value.variable));
+}
+
+/**@brief Erzeugt Code für einen Ausdruck.
+ */
+static void
+genExpr(jit_compiler_t* c, syntree_nid id)
+{
+	const syntree_node_t* node = nodePtr(c, id);
+	unsigned int jump;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_Float:
+		EMIT(c, "\xB8");                             /* mov eax, imm32 */
+		emit32(c, (uint32_t) node->value.integer);
+
+		if (node->type == SYNTREE_TYPE_Float)
+			EMIT(c, "\x66\x0F\x6E\xC0");         /* movd xmm0, eax */
+
+		break;
+
+	case SYNTREE_TAG_LocVar:
+		if (node->type == SYNTREE_TYPE_Float)
+			EMIT(c, "\xF3\x0F\x10\x83");         /* movss xmm0, [rbx+disp32] */
+		else
+			EMIT(c, "\x8B\x83");                 /* mov eax, [rbx+disp32] */
+
+		emit32(c, slotValue(node->value.variable));
+		break;
+
+	case SYNTREE_TAG_GlobVar:
+		if (node->type == SYNTREE_TYPE_Float)
+			EMIT(c, "\xF3\x41\x0F\x10\x84\x24"); /* movss xmm0, [r12+disp32] */
+		else
+			EMIT(c, "\x41\x8B\x84\x24");         /* mov eax, [r12+disp32] */
+
+		emit32(c, slotValue(node->value.variable));
+		break;
+
+	case SYNTREE_TAG_Call:
+		genCall(c, node);
+		break;
+
+	case SYNTREE_TAG_Assign:
+		genAssign(c, node);
+		break;
+
+	case SYNTREE_TAG_Cast:
+		genExpr(c, node->value.container.first);
+		EMIT(c, "\xF3\x0F\x2A\xC0");                 /* cvtsi2ss xmm0, eax */
+		break;
+
+	case SYNTREE_TAG_Uminus:
+		genExpr(c, node->value.container.first);
+
+		if (node->type == SYNTREE_TYPE_Float)
+			EMIT(c, "\x66\x0F\x7E\xC0"           /* movd eax, xmm0 */
+			        "\x35\x00\x00\x00\x80"       /* xor eax, 0x80000000 */
+			        "\x66\x0F\x6E\xC0");         /* movd xmm0, eax */
+		else
+			EMIT(c, "\xF7\xD8");                 /* neg eax */
+
+		break;
+
+	case SYNTREE_TAG_LogOr:
+	case SYNTREE_TAG_LogAnd:
+		genExpr(c, node->value.container.first);
+		EMIT(c, "\x85\xC0");                         /* test eax, eax */
+		jump = (node->tag == SYNTREE_TAG_LogOr)
+		     ? jumpForward(c, "\x0F\x85", 2)         /* jnz */
+		     : jumpForward(c, "\x0F\x84", 2);        /* jz */
+		genExpr(c, node->value.container.last);
+		land(c, jump);
+		break;
+
+	default:
+		genBinary(c, node);
+	}
+}
+
+/**@brief Erzeugt Code für eine Bedingung und springt, falls sie falsch ist.
+ * @return Position der noch aufzulösenden relativen Adresse
+ */
+static unsigned int
+genCondFalse(jit_compiler_t* c, syntree_nid cond)
+{
+	genExpr(c, cond);
+	EMIT(c, "\x85\xC0");                                 /* test eax, eax */
+	return jumpForward(c, "\x0F\x84", 2);                /* jz */
+}
+
+/**@brief Erzeugt Code für eine Bedingung und springt zurück, falls sie wahr
+ * ist.
+ */
+static void
+genCondTrue(jit_compiler_t* c, syntree_nid cond, unsigned int target)
+{
+	genExpr(c, cond);
+	EMIT(c, "\x85\xC0");                                 /* test eax, eax */
+	jumpBack(c, "\x0F\x85", 2, target);                  /* jnz */
+}
+
+/**@brief Erzeugt Code für eine Ausgabeanweisung.
+ */
+static void
+genPrint(jit_compiler_t* c, const syntree_node_t* node)
+{
+	const syntree_node_t* arg = nodePtr(c, node->value.container.first);
+
+	if (arg->tag == SYNTREE_TAG_String)
+	{
+		EMIT(c, "\x48\xBF");                         /* mov rdi, imm64 */
+		emit64(c, (uint64_t) (uintptr_t) arg->value.string);
+		callHelper(c, (void (*)(void)) jitPrintString);
+		return;
+	}
+
+	genExpr(c, node->value.container.first);
+
+	switch (arg->type)
+	{
+	case SYNTREE_TYPE_Boolean:
+		EMIT(c, "\x89\xC7");                         /* mov edi, eax */
+		callHelper(c, (void (*)(void)) jitPrintBool);
+		break;
+
+	case SYNTREE_TYPE_Integer:
+		EMIT(c, "\x89\xC7");                         /* mov edi, eax */
+		callHelper(c, (void (*)(void)) jitPrintInt);
+		break;
+
+	case SYNTREE_TYPE_Float:
+		callHelper(c, (void (*)(void)) jitPrintFloat);
+		break;
+
+	default:
+		callHelper(c, jitPrintVoid);
+	}
+}
+
+/**@brief Erzeugt Code für eine Anweisung.
+ */
+static void
+genStmt(jit_compiler_t* c, syntree_nid id)
+{
+	const syntree_node_t* node = nodePtr(c, id);
+	syntree_nid init, cond, step, body;
+	unsigned int jump, loop;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Sequence:
+		for (id = node->value.container.first; id != 0; id = nodeNext(c, id))
+			genStmt(c, id);
+
+		break;
+
+	case SYNTREE_TAG_If:
+		cond = node->value.container.first;
+		body = nodeNext(c, cond);
+
+		jump = genCondFalse(c, cond);
+		genStmt(c, body);
+
+		if (nodeNext(c, body) != 0)
+		{
+			loop = jump;
+			jump = jumpForward(c, "\xE9", 1);    /* jmp */
+			land(c, loop);
+			genStmt(c, nodeNext(c, body));
+		}
+
+		land(c, jump);
+		break;
+
+	case SYNTREE_TAG_For:
+		init = node->value.container.first;
+		cond = nodeNext(c, init);
+		step = nodeNext(c, cond);
+		body = nodeNext(c, step);
+
+		genStmt(c, init);
+		jump = jumpForward(c, "\xE9", 1);            /* jmp */
+		loop = here(c);
+		genBurn(c);
+		genStmt(c, body);
+		genStmt(c, step);
+		land(c, jump);
+		genCondTrue(c, cond, loop);
+		break;
+
+	case SYNTREE_TAG_While:
+		jump = jumpForward(c, "\xE9", 1);            /* jmp */
+		loop = here(c);
+		genBurn(c);
+		genStmt(c, node->value.container.last);
+		land(c, jump);
+		genCondTrue(c, node->value.container.first, loop);
+		break;
+
+	case SYNTREE_TAG_DoWhile:
+		/* nur Rücksprünge verbrauchen Treibstoff, nicht der erste Durchlauf */
+		jump = jumpForward(c, "\xE9", 1);            /* jmp */
+		loop = here(c);
+		genBurn(c);
+		land(c, jump);
+		genStmt(c, node->value.container.last);
+		genCondTrue(c, node->value.container.first, loop);
+		break;
+
+	case SYNTREE_TAG_Print:
+		genPrint(c, node);
+		break;
+
+	case SYNTREE_TAG_Return:
+		if (node->value.container.first != 0)
+		{
+			genExpr(c, node->value.container.first);
+
+			if (nodePtr(c, node->value.container.first)->type
+			    == SYNTREE_TYPE_Float)
+				EMIT(c, "\x66\x0F\x7E\xC0"); /* movd eax, xmm0 */
+		}
+
+		stackPush(c->returns) = jumpForward(c, "\xE9", 1);
+		break;
+
+	default:
+		/* Ausdrucksanweisungen (Zuweisungen und Aufrufe) */
+		genExpr(c, id);
+	}
+}
+
+/**@brief Übersetzt eine Funktion.
+ */
+static void
+genFunction(jit_compiler_t* c, syntree_nid id)
+{
+	const syntree_node_t* node = nodePtr(c, id);
+
+	c->start[id] = here(c) + 1;
+	c->locals = node->value.function.locals;
+	c->depth = 0;
+
+	EMIT(c, "\x53"                       /* push rbx */
+	        "\x41\x54"                   /* push r12 */
+	        "\x41\x55"                   /* push r13 */
+	        "\x48\x89\xFB"               /* mov rbx, rdi */
+	        "\x49\x89\xF4"               /* mov r12, rsi */
+	        "\x49\x89\xD5");             /* mov r13, rdx */
+
+	/* übersetzte Aufrufe liegen auf dem C-Stack und prüfen ihn daher wie
+	 * VMSTACK_PROBE() in den Interpretern; ohne Grenze ist vmstackFloor NULL */
+	EMIT(c, "\x48\xB8");                 /* mov rax, imm64 */
+	emit64(c, (uint64_t) (uintptr_t) &vmstackFloor);
+	EMIT(c, "\x48\x3B\x20");             /* cmp rsp, [rax] */
+	stackPush(c->overflows) = jumpForward(c, "\x0F\x82", 2); /* jb */
+
+	genStmt(c, node->value.function.body);
+
+	/* Epilog */
+	while (!stackIsEmpty(c->returns))
+		land(c, stackPop(c->returns));
+
+	EMIT(c, "\x41\x5D"                   /* pop r13 */
+	        "\x41\x5C"                   /* pop r12 */
+	        "\x5B"                       /* pop rbx */
+	        "\xC3");                     /* ret */
+
+	/* Stapelüberlauf */
+	if (!stackIsEmpty(c->overflows))
+	{
+		while (!stackIsEmpty(c->overflows))
+			land(c, stackPop(c->overflows));
+
+		EMIT(c, "\x48\x83\xE4\xF0"); /* and rsp, -16 */
+		callHelper(c, jitOverflow);
+	}
+
+	/* Treibstoff aufgebraucht, Zeitgrenze erreicht oder Stack überschritten */
+	if (!stackIsEmpty(c->exhausted))
+	{
+		while (!stackIsEmpty(c->exhausted))
+			land(c, stackPop(c->exhausted));
+
+		EMIT(c, "\x48\x83\xE4\xF0"); /* and rsp, -16 */
+		callHelper(c, quotaExhausted);
+	}
+}
+
+/* ********************************************************* public functions */
+
+int
+jitCompile(jit_t* self, const syntree_t* tree)
+{
+	jit_compiler_t c;
+	unsigned int id, i;
+	size_t page;
+	int rc = -1;
+
+	self->code = NULL;
+	self->size = 0;
+	self->entry = NULL;
+
+	if (!JIT_SUPPORTED)
+		return -1;
+
+	c.tree = tree;
+	c.start = calloc(tree->len, sizeof(*c.start));
+	self->entry = calloc(tree->len, sizeof(*self->entry));
+
+	if (c.start == NULL || self->entry == NULL
+	 || stackInit(c.buf) || stackInit(c.calls)
+	 || stackInit(c.returns) || stackInit(c.overflows)
+	 || stackInit(c.exhausted)
+	 || definiteInit(&c.defs, tree))
+	{
+		fputs("out-of-memory error\n", stderr);
+		exit(-1);
+	}
+
+	/* übersetze alle Funktionen in einen gemeinsamen Puffer */
+	for (id = 1; id < tree->len; ++id)
+		if (tree->nodes[id].tag == SYNTREE_TAG_Function)
+			genFunction(&c, id);
+
+	/* löse die relativen Aufrufadressen auf */
+	for (i = 0; i < stackCount(c.calls); ++i)
+		patch32(&c, c.calls[i].pos,
+		        (c.start[c.calls[i].func] - 1) - (c.calls[i].pos + 4));
+
+#if JIT_SUPPORTED
+	/* kopiere den Code in ausführbaren Speicher (niemals zugleich
+	 * beschreibbar und ausführbar) */
+	page = 4096;
+	self->size = (stackCount(c.buf) + page - 1) / page * page;
+	self->code = mmap(NULL, self->size, PROT_READ | PROT_WRITE,
+	                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	if (self->code != MAP_FAILED)
+	{
+		memcpy(self->code, c.buf, stackCount(c.buf));
+
+		if (mprotect(self->code, self->size, PROT_READ | PROT_EXEC) == 0)
+		{
+			for (id = 1; id < tree->len; ++id)
+			{
+				/* Umwandlung wie bei dlsym() beschrieben */
+				if (c.start[id] != 0)
+					*(void**) &self->entry[id] =
+						self->code + c.start[id] - 1;
+			}
+
+			rc = 0;
+		}
+		else
+			munmap(self->code, self->size);
+	}
+
+	if (rc != 0)
+		self->code = NULL;
+#else
+	(void) page;
+#endif
+
+	stackRelease(c.buf);
+	stackRelease(c.calls);
+	stackRelease(c.returns);
+	stackRelease(c.overflows);
+	stackRelease(c.exhausted);
+	definiteRelease(&c.defs);
+	free(c.start);
+	return rc;
+}
+
+void
+jitRelease(jit_t* self)
+{
+#if JIT_SUPPORTED
+	if (self->code != NULL)
+		munmap(self->code, self->size);
+#endif
+
+	free(self->entry);
+	self->code = NULL;
+	self->entry = NULL;
+}
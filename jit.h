@@ -0,0 +1,81 @@
+/***************************************************************************//**
+ * @file jit.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält einen JIT-Übersetzer, der C1-Funktionen in x86-64
+ * Maschinencode übersetzt.
+ * @details
+ * Hier ist ein Beispiel für die Benutzung des JIT-Übersetzers:
+ * @code
+ * jit_t jit;
+ *
+ * if (jitCompile(&jit, ast) == 0)
+ * {
+ *     jit_fn* fn = jit.entry[funcId];
+ *     minako_data_t res;
+ *
+ *     res.integer = fn(params, vm->stack, vm->limit);
+ *     jitRelease(&jit);
+ * }
+ * @endcode
+ *
+ * Alle Funktionen des Syntaxbaumes werden in einen gemeinsamen, per mmap()
+ * angelegten und danach ausführbaren Speicherbereich übersetzt. Die statischen
+ * Typen der Knoten bestimmen, ob Ganzzahl- oder SSE-Instruktionen erzeugt
+ * werden. Übersetzte Funktionen verwenden das gleiche Rahmenlayout auf dem
+ * Variablenstack wie der Bauminterpreter und rufen sich gegenseitig direkt
+ * auf; der Interpreter springt in execCall() in den übersetzten Code. Wie im
+ * Interpreter verbraucht jeder Aufruf und jeder Rücksprung einer Schleife
+ * eine Einheit Treibstoff (siehe quota.h), und jeder Funktionseintritt prüft
+ * den C-Stack gegen \c vmstackFloor (siehe vmstack.h).
+ *
+ * Der Übersetzer steht nur unter Linux auf x86-64 zur Verfügung.
+ ******************************************************************************/
+
+#ifndef JIT_H_INCLUDED
+#define JIT_H_INCLUDED
+
+/* *** includes ************************************************************* */
+
+#include <stddef.h>
+#include "syntree.h"
+#include "minako.h"
+
+/* *** structures *********************************************************** */
+
+/**@brief Signatur einer übersetzten Funktion.
+ * @param frame    Rahmen der Funktion mit bereits belegten Parametern
+ * @param globals  Beginn des Variablenstacks (globale Variablen)
+ * @param limit    Ende des Variablenstacks
+ * @return das Bitmuster des Rückgabewertes (siehe minako_data_t)
+ */
+typedef int jit_fn(minako_data_t* frame, minako_data_t* globals,
+                   minako_data_t* limit);
+
+/**@brief Übersetzter Maschinencode.
+ */
+typedef struct jit_s
+{
+	unsigned char* code; /**<@brief Ausführbarer Speicherbereich. */
+	size_t size;         /**<@brief Größe des Speicherbereichs. */
+	jit_fn** entry;      /**<@brief Abbildung Knoten-ID -> Einsprungadresse. */
+} jit_t;
+
+/* *** interface ************************************************************ */
+
+/**@brief Übersetzt alle Funktionen eines Syntaxbaumes in Maschinencode.
+ * @param self  der JIT-Übersetzer
+ * @param tree  der Syntaxbaum (mit den ursprünglichen Knotenarten)
+ * @return 0, falls die Übersetzung erfolgreich war\n
+ *      != 0, falls die Plattform nicht unterstützt wird oder kein
+ *            ausführbarer Speicher angelegt werden konnte
+ */
+extern int
+jitCompile(jit_t* self, const syntree_t* tree);
+
+/**@brief Gibt den übersetzten Maschinencode frei.
+ * @param self  der JIT-Übersetzer
+ */
+extern void
+jitRelease(jit_t* self);
+
+#endif /* JIT_H_INCLUDED */
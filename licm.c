@@ -0,0 +1,345 @@
+/***************************************************************************//**
+ * @file licm.c
+ * @author Dorian Weber und die Studenten
+ * @brief Implementation des Ziehens schleifeninvarianter Ausdrücke.
+ ******************************************************************************/
+
+#include "licm.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* ******************************************************* private structures */
+
+/**@brief Zustand während der Bearbeitung einer Funktion.
+ */
+typedef struct licm_ctx_s
+{
+	syntree_t* tree;         /**<@brief Der Syntaxbaum. */
+	syntree_nid func;        /**<@brief Knoten-ID der Funktion. */
+	unsigned char* written;  /**<@brief Platz -> in der Schleife zugewiesen. */
+	unsigned int cap;        /**<@brief Kapazität von written. */
+	int globals;             /**<@brief Globale Variablen sind veränderlich. */
+	syntree_nid pre;         /**<@brief Block der gezogenen Zuweisungen. */
+	unsigned int count;      /**<@brief Anzahl der gezogenen Ausdrücke. */
+} licm_ctx_t;
+
+/* ******************************************************** private functions */
+
+/**@brief Gibt einen Zeiger auf einen Knoten zurück.
+ * @note Der Zeiger ist nach dem Anlegen neuer Knoten ungültig.
+ */
+static inline syntree_node_t*
+ptr(const licm_ctx_t* ctx, syntree_nid id)
+{
+	return syntreeNodePtr(ctx->tree, id);
+}
+
+/**@brief Prüft, ob ein Knoten ein Blatt ist.
+ */
+static inline int
+leaf(const syntree_node_t* node)
+{
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+		return 1;
+
+	default:
+		return 0;
+	}
+}
+
+/**@brief Legt eine Kopie eines einzelnen Knotens ohne Nachfolger an.
+ */
+static syntree_nid
+clone(licm_ctx_t* ctx, syntree_nid id)
+{
+	syntree_nid res = syntreeNodeVariable(ctx->tree, NULL);
+
+	*ptr(ctx, res) = *ptr(ctx, id);
+	ptr(ctx, res)->next = 0;
+	return res;
+}
+
+/**@brief Sammelt die in einem Teilbaum zugewiesenen Variablen.
+ */
+static void
+writes(licm_ctx_t* ctx, syntree_nid id)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	const syntree_node_t* var;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+		return;
+
+	case SYNTREE_TAG_Assign:
+		var = ptr(ctx, node->value.container.first);
+
+		if (var->tag == SYNTREE_TAG_LocVar)
+			ctx->written[var->value.variable] = 1;
+		else
+			ctx->globals = 1;
+
+		id = var->next;
+		break;
+
+	case SYNTREE_TAG_Call:
+	case SYNTREE_TAG_TailCall:
+		/* Aufrufe können globale Variablen verändern */
+		ctx->globals = 1;
+		id = ptr(ctx, node->value.container.first)->value.container.first;
+		break;
+
+	default:
+		id = node->value.container.first;
+		break;
+	}
+
+	for (; id != 0; id = ptr(ctx, id)->next)
+		writes(ctx, id);
+}
+
+/**@brief Zieht einen Ausdruck in einen neuen Platz vor die Schleife.
+ */
+static void
+hoist(licm_ctx_t* ctx, syntree_nid id)
+{
+	syntree_node_type type = ptr(ctx, id)->type;
+	unsigned int slot = ptr(ctx, ctx->func)->value.function.locals++;
+	syntree_nid expr = clone(ctx, id), var = syntreeNodeVariable(ctx->tree, NULL);
+	syntree_node_t* node;
+
+	node = ptr(ctx, var);
+	node->tag = SYNTREE_TAG_LocVar;
+	node->type = type;
+	node->value.variable = slot;
+
+	syntreeNodeAppend(ctx->tree, ctx->pre,
+		syntreeNodePair(ctx->tree, SYNTREE_TAG_Assign, var, expr));
+
+	/* der Ausdruck wird zum Lesen des Platzes */
+	node = ptr(ctx, id);
+	node->tag = SYNTREE_TAG_LocVar;
+	node->value.variable = slot;
+	++ctx->count;
+}
+
+/**@brief Zieht die größten invarianten Teilausdrücke eines Ausdrucks.
+ * @return != 0, falls der ganze Ausdruck invariant ist; gezogen wird er dann
+ *         erst vom Aufrufer, damit er möglichst groß ist
+ */
+static int
+invariant(licm_ctx_t* ctx, syntree_nid id)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	syntree_nid child, divisor;
+	int inv[2], res = 1;
+	unsigned int i;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+		return 1;
+
+	case SYNTREE_TAG_String:
+		return 0;
+
+	case SYNTREE_TAG_LocVar:
+		return !ctx->written[node->value.variable];
+
+	case SYNTREE_TAG_GlobVar:
+		return !ctx->globals;
+
+	case SYNTREE_TAG_Assign:
+		/* das Ziel ist kein Ausdruck */
+		child = ptr(ctx, node->value.container.first)->next;
+
+		if (invariant(ctx, child) && !leaf(ptr(ctx, child)))
+			hoist(ctx, child);
+
+		return 0;
+
+	case SYNTREE_TAG_Divide:
+		/* eine ganzzahlige Division durch 0 darf nicht vorgezogen werden */
+		divisor = node->value.container.last;
+		res = node->type != SYNTREE_TYPE_Integer
+		   || (ptr(ctx, divisor)->tag == SYNTREE_TAG_Integer
+		    && ptr(ctx, divisor)->value.integer != 0);
+		break;
+
+	case SYNTREE_TAG_Cast:
+	case SYNTREE_TAG_Plus:
+	case SYNTREE_TAG_Minus:
+	case SYNTREE_TAG_Times:
+	case SYNTREE_TAG_LogOr:
+	case SYNTREE_TAG_LogAnd:
+	case SYNTREE_TAG_Uminus:
+	case SYNTREE_TAG_Eqt:
+	case SYNTREE_TAG_Neq:
+	case SYNTREE_TAG_Leq:
+	case SYNTREE_TAG_Geq:
+	case SYNTREE_TAG_Lst:
+	case SYNTREE_TAG_Grt:
+		break;
+
+	default:
+		/* Anweisungen und Aufrufe bleiben, invariante Kinder werden gezogen */
+		child = node->value.container.first;
+
+		if (node->tag == SYNTREE_TAG_Call || node->tag == SYNTREE_TAG_TailCall)
+			child = ptr(ctx, child)->value.container.first;
+
+		for (; child != 0; child = ptr(ctx, child)->next)
+			if (invariant(ctx, child) && !leaf(ptr(ctx, child)))
+				hoist(ctx, child);
+
+		return 0;
+	}
+
+	/* Operatoren haben höchstens zwei Operanden */
+	for (i = 0, child = ptr(ctx, id)->value.container.first; child != 0;
+	     child = ptr(ctx, child)->next, ++i)
+		if (!(inv[i] = invariant(ctx, child)))
+			res = 0;
+
+	if (res)
+		return 1;
+
+	for (i = 0, child = ptr(ctx, id)->value.container.first; child != 0;
+	     child = ptr(ctx, child)->next, ++i)
+		if (inv[i] && !leaf(ptr(ctx, child)))
+			hoist(ctx, child);
+
+	return 0;
+}
+
+/**@brief Zieht die invarianten Ausdrücke einer Schleife vor diese.
+ */
+static void
+loop(licm_ctx_t* ctx, syntree_nid id)
+{
+	unsigned int locals = ptr(ctx, ctx->func)->value.function.locals, i;
+	syntree_nid child, stmt;
+	syntree_node_t* node;
+
+	if (locals > ctx->cap)
+	{
+		/* vorgezogene Ausdrücke innerer Schleifen belegen neue Plätze */
+		ctx->cap = 2 * locals;
+		ctx->written = realloc(ctx->written, ctx->cap);
+
+		if (ctx->written == NULL)
+		{
+			fputs("out-of-memory error\n", stderr);
+			exit(-1);
+		}
+	}
+
+	for (i = 0; i < locals; ++i)
+		ctx->written[i] = 0;
+
+	ctx->globals = 0;
+
+	/* auch die Initialisierung, da die Zuweisungen vor ihr stehen */
+	for (child = ptr(ctx, id)->value.container.first; child != 0;
+	     child = ptr(ctx, child)->next)
+		writes(ctx, child);
+
+	ctx->pre = syntreeNodeEmpty(ctx->tree, SYNTREE_TAG_Sequence);
+	child = ptr(ctx, id)->value.container.first;
+
+	if (ptr(ctx, id)->tag == SYNTREE_TAG_For)
+		child = ptr(ctx, child)->next;
+
+	for (; child != 0; child = ptr(ctx, child)->next)
+		if (invariant(ctx, child) && !leaf(ptr(ctx, child)))
+			hoist(ctx, child);
+
+	if (ptr(ctx, ctx->pre)->value.container.first == 0)
+		return;
+
+	/* aus der Schleife wird { pre; Schleife } */
+	stmt = clone(ctx, id);
+	node = ptr(ctx, id);
+	node->tag = SYNTREE_TAG_Sequence;
+	node->type = SYNTREE_TYPE_Void;
+	node->value.container.first = node->value.container.last = 0;
+	syntreeNodeAppend(ctx->tree, id, ctx->pre);
+	syntreeNodeAppend(ctx->tree, id, stmt);
+}
+
+/**@brief Bearbeitet alle Schleifen einer Anweisung, innere zuerst.
+ */
+static void
+statement(licm_ctx_t* ctx, syntree_nid id)
+{
+	syntree_nid child;
+
+	switch (ptr(ctx, id)->tag)
+	{
+	case SYNTREE_TAG_Sequence:
+		for (child = ptr(ctx, id)->value.container.first; child != 0;
+		     child = ptr(ctx, child)->next)
+			statement(ctx, child);
+		break;
+
+	case SYNTREE_TAG_If:
+		for (child = ptr(ctx, ptr(ctx, id)->value.container.first)->next;
+		     child != 0; child = ptr(ctx, child)->next)
+			statement(ctx, child);
+		break;
+
+	case SYNTREE_TAG_For:
+	case SYNTREE_TAG_While:
+	case SYNTREE_TAG_DoWhile:
+		statement(ctx, ptr(ctx, id)->value.container.last);
+		loop(ctx, id);
+		break;
+
+	default:
+		break;
+	}
+}
+
+/* ********************************************************* public functions */
+
+unsigned int
+licmTree(syntree_t* self)
+{
+	licm_ctx_t ctx;
+	unsigned int id, len = self->len;
+	syntree_node_t* node;
+
+	ctx.tree = self;
+	ctx.written = NULL;
+	ctx.cap = 0;
+	ctx.count = 0;
+
+	for (id = 1; id < len; ++id)
+	{
+		node = syntreeNodePtr(self, id);
+
+		if (node->tag != SYNTREE_TAG_Function)
+			continue;
+
+		ctx.func = id;
+		statement(&ctx, node->value.function.body);
+	}
+
+	free(ctx.written);
+	return ctx.count;
+}
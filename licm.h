@@ -0,0 +1,50 @@
+/***************************************************************************//**
+ * @file licm.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält einen Durchlauf, der schleifeninvariante Ausdrücke vor die
+ * Schleife zieht.
+ * @details
+ * Ein Ausdruck innerhalb einer \c for-, \c while- oder \c do-while-Schleife
+ * ist invariant, wenn er weder aufruft noch zuweist und keine seiner lokalen
+ * Variablen in der Schleife (einschließlich Bedingung, Schritt und
+ * Initialisierung) zugewiesen wird; globale Variablen gelten nur als
+ * invariant, wenn die Schleife weder sie zuweist noch irgendeine Funktion
+ * aufruft. Aus
+ * @code
+ * while (n < 100) { s = s + (x - 1.0) / x * n; n = n + 1; }
+ * @endcode
+ * wird dann sinngemäß
+ * @code
+ * t = (x - 1.0) / x;
+ * while (n < 100) { s = s + t * n; n = n + 1; }
+ * @endcode
+ * mit einem neuen lokalen Platz pro gezogenem Ausdruck. Gezogen werden nur
+ * größte invariante Teilausdrücke, die nicht nur aus einer Variable oder
+ * Konstante bestehen.
+ *
+ * Da der gezogene Ausdruck auch dann ausgewertet wird, wenn die Schleife nie
+ * läuft oder er nur in einem Zweig steht, bleiben ganzzahlige Divisionen
+ * durch einen nicht konstanten Divisor in der Schleife. Innere Schleifen
+ * werden zuerst bearbeitet; was auch in der äußeren Schleife invariant ist,
+ * wandert von dort weiter nach außen. Der Durchlauf muss vor definiteInit()
+ * laufen, da er neue Plätze einführt.
+ ******************************************************************************/
+
+#ifndef LICM_H_INCLUDED
+#define LICM_H_INCLUDED
+
+/* *** includes ************************************************************* */
+
+#include "syntree.h"
+
+/* *** interface ************************************************************ */
+
+/**@brief Zieht schleifeninvariante Ausdrücke aller Funktionen vor ihre
+ * Schleifen.
+ * @param self  der Syntaxbaum
+ * @return Anzahl der gezogenen Ausdrücke
+ */
+extern unsigned int
+licmTree(syntree_t* self);
+
+#endif /* LICM_H_INCLUDED */
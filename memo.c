@@ -0,0 +1,226 @@
+/***************************************************************************//**
+ * @file memo.c
+ * @author Dorian Weber und die Studenten
+ * @brief Implementation der Effektanalyse und des Ergebniscaches.
+ ******************************************************************************/
+
+#include "memo.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ******************************************************** private functions */
+
+/**@brief Prüft, ob ein Teilbaum Nebeneffekte hat.
+ * @param tree    der Syntaxbaum
+ * @param id      Wurzel des Teilbaumes
+ * @param impure  Knoten-ID -> Funktion hat Nebeneffekte
+ * @return != 0, falls der Teilbaum globale Variablen verwendet, ausgibt oder
+ *         eine Funktion mit Nebeneffekten aufruft
+ */
+static int
+effects(const syntree_t* tree, syntree_nid id, const unsigned char* impure)
+{
+	const syntree_node_t* node = syntreeNodePtr(tree, id);
+	int res = 0;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_GlobVar:
+	case SYNTREE_TAG_Print:
+		return 1;
+
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_LocVar:
+		return 0;
+
+	case SYNTREE_TAG_Call:
+	case SYNTREE_TAG_TailCall:
+		if (impure[node->value.container.last])
+			return 1;
+
+		/* nur die Argumente, der letzte Kindknoten ist die Funktion */
+		id = syntreeNodePtr(tree, node->value.container.first)->value.container.first;
+		break;
+
+	default:
+		id = node->value.container.first;
+		break;
+	}
+
+	for (; id != 0 && !res; id = syntreeNodePtr(tree, id)->next)
+		res = effects(tree, id, impure);
+
+	return res;
+}
+
+/**@brief Prüft, ob jeder Pfad durch eine Anweisung mit einem Rücksprung
+ * endet.
+ * @note Eine Funktion, die ohne Rücksprung endet, liefert den zufälligen Inhalt
+ * des Ausgaberegisters und darf deshalb nicht gecacht werden.
+ */
+static int
+returns(const syntree_t* tree, syntree_nid id)
+{
+	const syntree_node_t* node = syntreeNodePtr(tree, id);
+	syntree_nid cons;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Return:
+		return 1;
+
+	case SYNTREE_TAG_Sequence:
+		for (id = node->value.container.first; id != 0;
+		     id = syntreeNodePtr(tree, id)->next)
+			if (returns(tree, id))
+				return 1;
+
+		return 0;
+
+	case SYNTREE_TAG_If:
+		cons = syntreeNodePtr(tree, node->value.container.first)->next;
+		id = syntreeNodePtr(tree, cons)->next;
+		return id != 0 && returns(tree, cons) && returns(tree, id);
+
+	default:
+		return 0;
+	}
+}
+
+/**@brief Berechnet den Platz eines Schlüssels in der Tabelle.
+ */
+static inline unsigned int
+slot(const memo_t* self, syntree_nid func, const minako_data_t* args)
+{
+	unsigned int h = func * 0x9E3779B9u, i;
+
+	for (i = 0; i < self->params[func]; ++i)
+		h = (h ^ (unsigned int) args[i].integer) * 0x85EBCA6Bu;
+
+	return (h ^ (h >> 16)) & self->mask;
+}
+
+/* ********************************************************* public functions */
+
+int
+memoInit(memo_t* self, const syntree_t* tree, size_t size)
+{
+	const syntree_node_t* node;
+	unsigned char* impure;
+	unsigned int id, count, len;
+	syntree_nid arg;
+	int changed;
+
+	self->pure = calloc(tree->len, 1);
+	self->params = calloc(tree->len, 1);
+	impure = calloc(tree->len, 1);
+
+	/* größte Zweierpotenz an Einträgen, die in den Speicher passt */
+	size = (size << 10) / sizeof(*self->table);
+
+	for (len = 1; len <= size / 2; len *= 2)
+		;
+
+	self->mask = len - 1;
+	self->table = (size > 0) ? calloc(len, sizeof(*self->table)) : NULL;
+
+	if (self->pure == NULL || self->params == NULL || impure == NULL
+	 || self->table == NULL)
+	{
+		free(impure);
+		memoRelease(self);
+		return -1;
+	}
+
+	/* die Parameteranzahl ergibt sich aus den Aufrufen, nie aufgerufene
+	 * Funktionen müssen nicht gecacht werden */
+	for (id = 1; id < tree->len; ++id)
+	{
+		node = syntreeNodePtr(tree, id);
+
+		if (node->tag != SYNTREE_TAG_Call && node->tag != SYNTREE_TAG_TailCall)
+			continue;
+
+		count = 0;
+
+		for (arg = syntreeNodePtr(tree, node->value.container.first)->value.container.first;
+		     arg != 0; arg = syntreeNodePtr(tree, arg)->next)
+			++count;
+
+		self->params[node->value.container.last] =
+			(count > MEMO_MAX_ARGS) ? MEMO_MAX_ARGS + 1 : count;
+
+		/* der Rückgabetyp steht nur an den Aufrufen */
+		self->pure[node->value.container.last] =
+			(node->type != SYNTREE_TYPE_Void);
+	}
+
+	/* Effekte übertragen sich vom Aufgerufenen auf den Aufrufer */
+	do
+	{
+		changed = 0;
+
+		for (id = 1; id < tree->len; ++id)
+		{
+			node = syntreeNodePtr(tree, id);
+
+			if (node->tag == SYNTREE_TAG_Function && !impure[id]
+			 && effects(tree, node->value.function.body, impure))
+				impure[id] = changed = 1;
+		}
+	}
+	while (changed);
+
+	for (id = 1; id < tree->len; ++id)
+	{
+		node = syntreeNodePtr(tree, id);
+		self->pure[id] = self->pure[id] && !impure[id]
+		              && returns(tree, node->value.function.body)
+		              && self->params[id] <= MEMO_MAX_ARGS;
+	}
+
+	free(impure);
+	return 0;
+}
+
+void
+memoRelease(memo_t* self)
+{
+	free(self->pure);
+	free(self->params);
+	free(self->table);
+	self->pure = self->params = NULL;
+	self->table = NULL;
+}
+
+int
+memoLookup(const memo_t* self, syntree_nid func, const minako_data_t* args,
+           minako_data_t* result)
+{
+	const memo_entry_t* entry = &self->table[slot(self, func, args)];
+	unsigned int i;
+
+	if (entry->func != func)
+		return 0;
+
+	for (i = 0; i < self->params[func]; ++i)
+		if (entry->args[i].integer != args[i].integer)
+			return 0;
+
+	*result = entry->result;
+	return 1;
+}
+
+void
+memoStore(memo_t* self, syntree_nid func, const minako_data_t* args,
+          minako_data_t result)
+{
+	memo_entry_t* entry = &self->table[slot(self, func, args)];
+
+	entry->func = func;
+	memcpy(entry->args, args, self->params[func] * sizeof(*args));
+	entry->result = result;
+}
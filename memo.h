@@ -0,0 +1,113 @@
+/***************************************************************************//**
+ * @file memo.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält eine Effektanalyse und einen Ergebniscache für reine
+ * Funktionen.
+ * @details
+ * Hier ist ein Beispiel für die Benutzung:
+ * @code
+ * memo_t memo;
+ * minako_data_t res;
+ *
+ * memoInit(&memo, ast, 1024);
+ *
+ * if (memo.pure[func] && memoLookup(&memo, func, args, &res))
+ *     return res;
+ *
+ * res = call(func, args);
+ *
+ * if (memo.pure[func])
+ *     memoStore(&memo, func, args, res);
+ *
+ * memoRelease(&memo);
+ * @endcode
+ *
+ * Eine Funktion ist rein, wenn sie keine globalen Variablen liest oder
+ * schreibt, nichts ausgibt und nur reine Funktionen aufruft. Ihr Ergebnis
+ * hängt dann nur von den Argumenten ab; uninitialisiert gelesene Plätze
+ * werden beim Eintritt immer gleich vorbelegt (siehe definite.h). Gecacht
+ * werden nur reine Funktionen mit Rückgabewert, die auf jedem Pfad mit einem
+ * Rücksprung enden und höchstens \c MEMO_MAX_ARGS Parameter haben.
+ *
+ * Der Cache ist eine direkt abgebildete Hashtabelle fester Größe: jeder
+ * Schlüssel aus Funktion und Argumentbits hat genau einen Platz, ein neues
+ * Ergebnis verdrängt das alte. Der Speicherbedarf ist dadurch durch die
+ * angegebene Größe beschränkt.
+ ******************************************************************************/
+
+#ifndef MEMO_H_INCLUDED
+#define MEMO_H_INCLUDED
+
+/* *** includes ************************************************************* */
+
+#include <stddef.h>
+#include "syntree.h"
+#include "minako.h"
+
+/**@brief Maximale Parameteranzahl gecachter Funktionen.
+ */
+#define MEMO_MAX_ARGS 4
+
+/* *** structures *********************************************************** */
+
+/**@brief Ein Eintrag im Ergebniscache.
+ */
+typedef struct memo_entry_s
+{
+	syntree_nid func;                   /**<@brief Funktion oder 0 (leer). */
+	minako_data_t args[MEMO_MAX_ARGS];  /**<@brief Argumente. */
+	minako_data_t result;               /**<@brief Rückgabewert. */
+} memo_entry_t;
+
+/**@brief Ergebnis der Effektanalyse und zugehöriger Cache.
+ */
+typedef struct memo_s
+{
+	unsigned char* pure;   /**<@brief Knoten-ID -> Funktion wird gecacht. */
+	unsigned char* params; /**<@brief Knoten-ID -> Parameteranzahl. */
+	memo_entry_t* table;   /**<@brief Die Hashtabelle. */
+	unsigned int mask;     /**<@brief Tabellengröße - 1 (Zweierpotenz). */
+} memo_t;
+
+/* *** interface ************************************************************ */
+
+/**@brief Analysiert alle Funktionen und legt den Cache an.
+ * @param self  der zu initialisierende Cache
+ * @param tree  der Syntaxbaum
+ * @param size  maximale Größe der Tabelle in KiB
+ * @return 0, falls keine Fehler aufgetreten sind\n
+ *      != 0 ansonsten
+ */
+extern int
+memoInit(memo_t* self, const syntree_t* tree, size_t size);
+
+/**@brief Gibt den Cache frei.
+ * @param self  der Cache
+ */
+extern void
+memoRelease(memo_t* self);
+
+/**@brief Sucht das Ergebnis eines Aufrufs.
+ * @param self    der Cache
+ * @param func    Knoten-ID einer reinen Funktion
+ * @param args    die Argumente
+ * @param result  Ziel für das Ergebnis
+ * @return != 0, falls das Ergebnis bekannt ist\n
+ *         0 ansonsten
+ */
+extern int
+memoLookup(const memo_t* self, syntree_nid func, const minako_data_t* args,
+           minako_data_t* result);
+
+/**@brief Legt das Ergebnis eines Aufrufs ab und verdrängt dabei einen
+ * eventuell vorhandenen Eintrag.
+ * @param self    der Cache
+ * @param func    Knoten-ID einer reinen Funktion
+ * @param args    die Argumente
+ * @param result  das Ergebnis
+ */
+extern void
+memoStore(memo_t* self, syntree_nid func, const minako_data_t* args,
+          minako_data_t result);
+
+#endif /* MEMO_H_INCLUDED */
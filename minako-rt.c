@@ -0,0 +1,39 @@
+/***************************************************************************//**
+ * @file minako-rt.c
+ * @author Dorian Weber und die Studenten
+ * @brief Laufzeitunterstützung für vorab übersetzte C1-Programme.
+ * @details
+ * Die Ausgaben entsprechen exakt denen von execPrint() im Interpreter.
+ ******************************************************************************/
+
+#include <stdio.h>
+
+void
+minakoPrintInt(int value)
+{
+	printf("%i\n", value);
+}
+
+void
+minakoPrintFloat(float value)
+{
+	printf("%g\n", value);
+}
+
+void
+minakoPrintBool(int value)
+{
+	puts(value ? "true" : "false");
+}
+
+void
+minakoPrintString(const char* value)
+{
+	puts(value);
+}
+
+void
+minakoPrintVoid(void)
+{
+	putc('\n', stdout);
+}
@@ -12,50 +12,101 @@
 #include "minako-syntax.tab.h"
 #include "symtab.h"
 #include "syntree.h"
-
-/**@brief Maximale Anzahl gleichzeitig verwendeter Variablen im Interpreter.
- */
-#define MINAKO_STACK_SIZE 1024
-#define DUMMY -1 // leerer Platz
+#include "bytecode.h"
+#include "closure.h"
+#include "jit.h"
+#include "native.h"
+#include "cgen.h"
+#include "minako.h"
+#include "quicken.h"
+#include "fuse.h"
+#include "stackless.h"
+#include "vmstack.h"
+#include "definite.h"
+#include "tailcall.h"
+#include "memo.h"
+#include "iterate.h"
+#include "inline.h"
+#include "fold.h"
+#include "licm.h"
+#include "strength.h"
+#include "scev.h"
+#include "dce.h"
+#include "quota.h"
 
 /* ******************************************************* private structures */
 
-/**@brief Ein Variablenwert im Interpreter.
+/**@brief Verfügbare Ausführungsmodi.
  */
-typedef struct minako_value_s
+typedef enum minako_engine_e
 {
-	/**@brief Typ des Variablenwertes.
-	 */
-	syntree_node_type type;
-
-	/**@brief Variablenwert.
-	 */
-	union
-	{
-		int boolean;  /**<@brief Boolescher Wert. */
-		int integer;  /**<@brief Ganzzahliger Wert. */
-		float real;   /**<@brief Fließkommawert. */
-		char* string; /**<@brief Zeiger auf Zeichenkette. */
-	} value;
-} minako_value_t;
+	MINAKO_ENGINE_Bytecode, /**<@brief Registerbasierte virtuelle Maschine. */
+	MINAKO_ENGINE_Closure,  /**<@brief Vorgebundene Closures. */
+	MINAKO_ENGINE_Tree,     /**<@brief Rekursiver Bauminterpreter. */
+	MINAKO_ENGINE_Stackless /**<@brief Bauminterpreter mit Heap-Rahmen. */
+} minako_engine;
 
-/**@brief Struktur des Laufzeitzustands des Interpreters.
+/**@brief Kommandozeilenoptionen.
+ */
+typedef struct minako_options_s
+{
+	minako_engine engine; /**<@brief Gewählter Ausführungsmodus. */
+	int printBytecode;    /**<@brief Bytecode ausgeben statt ausführen. */
+	int jit;              /**<@brief Funktionen in Maschinencode übersetzen. */
+	int emitAsm;          /**<@brief Assembler ausgeben statt ausführen. */
+	int emitC;            /**<@brief C-Quelltext ausgeben statt ausführen. */
+	unsigned long tierThreshold; /**<@brief Schwelle zum Befördern oder 0. */
+	int tierStats;        /**<@brief Statistik der Stufen ausgeben. */
+	int fuse;             /**<@brief Superinstruktionen bilden. */
+	int warnUninit;       /**<@brief Uninitialisiertes Lesen melden. */
+	int iterate;          /**<@brief Lineare Rekursion in Schleifen umformen. */
+	unsigned long inlineBudget; /**<@brief Knotenbudget beim Einsetzen oder 0. */
+	int inlineReport;     /**<@brief Entscheidungen beim Einsetzen ausgeben. */
+	int fold;             /**<@brief Konstanten falten und weitergeben. */
+	int foldReport;       /**<@brief Statistik der Faltung ausgeben. */
+	int licm;             /**<@brief Schleifeninvariante Ausdrücke vorziehen. */
+	int strength;         /**<@brief Induktionsvariablen fortschreiben. */
+	int scev;             /**<@brief Summationsschleifen geschlossen auswerten. */
+	int dce;              /**<@brief Toten Code entfernen. */
+	int trace;            /**<@brief Ablauf des Bauminterpreters verfolgen. */
+	unsigned long memoSize; /**<@brief Größe des Ergebniscaches in KiB oder 0. */
+	unsigned long maxStack; /**<@brief Größe des Variablenstacks in MiB. */
+	unsigned long maxFuel;  /**<@brief Treibstoff oder 0 für unbegrenzt. */
+	unsigned long timeout;  /**<@brief Zeitgrenze in Sekunden oder 0. */
+	const char* output;   /**<@brief Ausgabedatei oder \c NULL. */
+	const char* file;     /**<@brief Quelldatei oder \c NULL für stdin. */
+} minako_options_t;
+
+/**@brief Zustand der gestuften Ausführung im Bauminterpreter.
+ * @details
+ * Gezählt werden die Aufrufe jeder Funktion und die Rücksprünge jeder
+ * Schleife, letztere auch summiert für die gerade interpretierte Funktion.
+ * Überschreitet die Summe beider Zähler einer Funktion die Schwelle, wird sie
+ * beim nächsten Aufruf in Closures übersetzt und fortan dort ausgeführt.
+ * Überschreitet der Zähler einer Schleife die Schwelle, wird sie beim
+ * nächsten Rücksprung übersetzt und in den Closures fortgesetzt.
  */
-typedef struct minako_vm_s
+typedef struct minako_tier_s
 {
-	minako_value_t stack[MINAKO_STACK_SIZE]; /**<@brief Variablenstack. */
-	minako_value_t eax;  /**<@brief Ausgaberegister. */
-	minako_value_t* ebp; /**<@brief Base pointer. */
-	minako_value_t* esp; /**<@brief Stack pointer. */
-	int returnFlag; /**<@brief Signalisiert das Verlassen einer Funktion. */
-} minako_vm_t;
+	closure_program_t prog;  /**<@brief Closures der beförderten Funktionen. */
+	unsigned long* count;    /**<@brief Knoten-ID -> Aufrufe bzw. Rücksprünge. */
+	unsigned long* edges;    /**<@brief Knoten-ID -> Rücksprünge in Funktion. */
+	syntree_nid* owner;      /**<@brief Knoten-ID -> umgebende Funktion. */
+	const closure_t** loops; /**<@brief Knoten-ID -> beförderte Schleife. */
+	syntree_nid func;        /**<@brief Aktuell interpretierte Funktion. */
+	unsigned long threshold; /**<@brief Schwelle zum Befördern. */
+} minako_tier_t;
 
 /**@brief Prototyp von Funktionen, die einen Knoten interpretieren.
  * @note Der Zustand der virtuellen Maschine und der ausgeführte Syntaxbaum
  * werden der Einfachheit halber implizit als globale Variablen bereitgestellt.
+ * Der Typ des Ergebnisses steht statisch im Syntaxbaum, der Wert wird deshalb
+ * ohne Typ im Register zurückgegeben. Anweisungen liefern den Inhalt von
+ * \c vm->eax, in dem Rücksprunganweisungen den Rückgabewert ablegen.
  * @param node  der zu interpretierende Knoten
+ * @return der Wert des Knotens
  */
-typedef void minako_exec_p(const syntree_node_t* node);
+typedef minako_data_t minako_exec_p(const syntree_node_t* node);
 
 /**@brief Funktionszeigertyp der Interpreter-Funktionen.
  */
@@ -73,73 +124,100 @@ typedef minako_exec_p* minako_exec_f;
  */
 static minako_vm_t* vm;
 
+/**@brief Globaler Zeiger auf den übersetzten Maschinencode oder \c NULL.
+ */
+static const jit_t* jit;
+
+/**@brief Globaler Zeiger auf den Zustand der gestuften Ausführung oder
+ * \c NULL.
+ */
+static minako_tier_t* tier;
+
+/**@brief Globaler Zeiger auf die vor dem Lesen zu belegenden Plätze.
+ */
+static const definite_t* defs;
+
+/**@brief Ziel eines ausstehenden Endaufrufs oder \c NULL.
+ */
+static const syntree_node_t* pending;
+
+/**@brief Globaler Zeiger auf den Ergebniscache reiner Funktionen oder
+ * \c NULL.
+ */
+static memo_t* memo;
+
+/**@brief Interpretiert einen Knoten und schreibt dabei eine Ablaufverfolgung
+ * in die Standardausgabe.
+ */
+static minako_exec_p execTraced;
+
 #define CALLBACK(NODE) \
 	&exec ## NODE,
 
+#define TRACED(NODE) \
+	&execTraced,
+
 /**@brief Statische Dispatchtabelle zur Lokalisierung der richtigen
  * Interpreterfunktion für einen gegebenen Knotentyp im Syntaxbaum.
  */
 static const minako_exec_f
-dispatchTable[] = {
+plainTable[] = {
 	SYNTREE_NODE_LIST(CALLBACK)
 };
 
+/**@brief Dispatchtabelle mit Ablaufverfolgung, die jeden Knoten über
+ * execTraced() an die Funktion aus \c plainTable weiterreicht.
+ */
+static const minako_exec_f
+traceTable[] = {
+	SYNTREE_NODE_LIST(TRACED)
+};
+
 #undef CALLBACK
+#undef TRACED
+
+/**@brief Die beim Start gewählte Dispatchtabelle.
+ * @note Die Entscheidung für oder gegen die Ablaufverfolgung fällt einmalig
+ * beim Start (\c --trace), der Dispatcher selbst prüft nichts.
+ */
+static const minako_exec_f* dispatchTable = plainTable;
 
 /* ******************************************************** private functions */
 
 /* Trace-Unterstützung zum Debuggen des Interpreters */
 
-#ifndef NDEBUG
-	static unsigned int indent;
+/**@brief Aktuelle Einrückung der Ablaufverfolgung.
+ */
+static unsigned int indent;
 
-	/**@brief Schreibt den Namen eines Knotentags eingerückt in die
-	 * Standardausgabe und erhöht die Einrückung.
-	 */
-	#define TRACE_ENTER(TAG) \
-		if (yydebug) { \
-			printf("%*s<%s>\n", indent*4, "", nodeTagName[TAG]); \
-			++indent; \
-		}
+/**@brief Schreibt einen Wert eingerückt in die Ausgabe.
+ */
+static void
+traceValue(syntree_node_type type, minako_data_t val)
+{
+	printf("%*s", indent*4, "");
 
-     	/**@brief Verringert die Einrückung und schreibt den Namen eines
-	 * Knotentags eingerückt in die Standardausgabe.
-     	 */
-	#define TRACE_LEAVE(TAG) \
-		if (yydebug) { \
-			--indent; \
-			printf("%*s</%s>\n", indent*4, "", nodeTagName[TAG]); \
-		}
+	switch (type)
+	{
+	case SYNTREE_TYPE_Boolean:
+		printf("%s", val.boolean ? "true" : "false");
+		break;
+	case SYNTREE_TYPE_Integer:
+		printf("%i", val.integer);
+		break;
+	case SYNTREE_TYPE_Float:
+		printf("%g", val.real);
+		break;
+	case SYNTREE_TYPE_String:
+		printf("\"%s\"", syntreeNodePtr(ast, val.string)->value.string);
+		break;
+	case SYNTREE_TYPE_Void:
+		printf("(void)");
+		break;
+	}
 
-     	/**@brief Schreibt den Wert einer Stackvariablen eingerückt in die Ausgabe.
-     	 */
-	#define TRACE_VALUE(VAL) \
-		if (yydebug) { \
-			printf("%*s", indent*4, ""); \
-			switch (VAL.type) { \
-			case SYNTREE_TYPE_Boolean: \
-				printf("%s", VAL.value.boolean ? "true" : "false"); \
-				break; \
-			case SYNTREE_TYPE_Integer: \
-				printf("%i", VAL.value.integer); \
-				break; \
-			case SYNTREE_TYPE_Float: \
-				printf("%g", VAL.value.real); \
-				break; \
-			case SYNTREE_TYPE_String: \
-				printf("\"%s\"", VAL.value.string); \
-				break; \
-			case SYNTREE_TYPE_Void: \
-				printf("(void)"); \
-				break; \
-			} \
-			putc('\n', stdout); \
-		}
-#else
-	#define TRACE_ENTER(TAG)
-	#define TRACE_LEAVE(TAG)
-	#define TRACE_VALUE(VAL)
-#endif
+	putc('\n', stdout);
+}
 
 /* Hilfsfunktionen */
 
@@ -177,128 +255,250 @@ nodeSentinel(const syntree_node_t* node)
 	return syntreeNodeId(ast, node) == 0;
 }
 
+/**@brief Belegt die Plätze eines neuen Rahmens mit \c DUMMY, die vor ihrer
+ * Zuweisung gelesen werden können (siehe definite.h).
+ */
+static inline void
+frameInit(minako_data_t* frame, syntree_nid func)
+{
+	unsigned int i;
+
+	for (i = defs->start[func]; i < defs->start[func + 1]; ++i)
+		frame[defs->slots[i]].integer = DUMMY;
+}
+
 /* Dispatcher */
 
 /**@brief Ruft für einen gegebenen Knoten die entsprechende Ausführungsfunktion.
  */
-static inline minako_value_t
+static inline minako_data_t
 dispatch(const syntree_node_t* node)
 {
 	/* rufe die dem Knotentyp entsprechende Funktion */
-	TRACE_ENTER(node->tag);
 	//printf("dispatching Tag: %s, Type: %s\n", nodeTagName[node->tag], nodeTypeName[node->type]);
-	dispatchTable[node->tag](node);
-	TRACE_LEAVE(node->tag);
+	return dispatchTable[node->tag](node);
+}
+
+/**@brief Schreibt den Namen eines Knotentags eingerückt in die
+ * Standardausgabe, interpretiert den Knoten und schreibt danach den Namen
+ * erneut; Literale geben zusätzlich ihren Wert aus.
+ */
+static minako_data_t
+execTraced(const syntree_node_t* node)
+{
+	syntree_node_tag tag = node->tag;
+	minako_data_t val;
+
+	printf("%*s<%s>\n", indent*4, "", nodeTagName[tag]);
+	++indent;
+
+	val = plainTable[tag](node);
+
+	switch (tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+		traceValue(node->type, val);
+		break;
+
+	default:
+		break;
+	}
+
+	--indent;
+	printf("%*s</%s>\n", indent*4, "", nodeTagName[tag]);
+	return val;
+}
+
+/* Gestufte Ausführung */
+
+/**@brief Zählt einen Rücksprung einer Schleife und befördert sie, sobald
+ * sie heiß genug ist.
+ * @return die Closure der Schleife oder \c NULL, falls sie noch kalt ist
+ */
+static inline const closure_t*
+tierBackEdge(const syntree_node_t* loop)
+{
+	syntree_nid id;
+
+	/* jeder Rücksprung verbraucht Treibstoff (siehe quota.h) */
+	QUOTA_BURN();
 
-	return vm->eax;
+	if (tier == NULL)
+		return NULL;
+
+	id = syntreeNodeId(ast, loop);
+	++tier->count[id];
+	++tier->edges[tier->func];
+	tier->owner[id] = tier->func;
+
+	if (tier->loops[id] == NULL && tier->count[id] >= tier->threshold)
+		tier->loops[id] = closureCompileLoop(&tier->prog, ast, id);
+
+	return tier->loops[id];
+}
+
+/**@brief Zählt den Aufruf einer Funktion und befördert sie, sobald sie heiß
+ * genug ist.
+ * @return die Closure der Funktion oder \c NULL, falls sie noch kalt ist
+ */
+static const closure_t*
+tierPromote(const syntree_node_t* func)
+{
+	syntree_nid id = syntreeNodeId(ast, func);
+
+	++tier->count[id];
+
+	/* auch transitiv übersetzte Funktionen gelten als befördert */
+	if (tier->prog.funcs != NULL && tier->prog.funcs[id] != NULL)
+		return tier->prog.funcs[id];
+
+	if (tier->count[id] + tier->edges[id] < tier->threshold)
+		return NULL;
+
+	return closureCompileFunction(&tier->prog, ast, id);
 }
 
 /* ********************************* */
 /* Literale */
 /* ********************************* */
 
-static void
+static minako_data_t
 execInteger(const syntree_node_t* node)
 {
-	vm->eax.type = node->type;
-	vm->eax.value.integer = node->value.integer;
-	TRACE_VALUE(vm->eax);
+	minako_data_t res;
+
+	res.integer = node->value.integer;
+	return res;
 }
 
-static void
+static minako_data_t
 execFloat(const syntree_node_t* node)
 {
-	vm->eax.type = node->type;
-	vm->eax.value.real = node->value.real;
-	TRACE_VALUE(vm->eax);
+	minako_data_t res;
+
+	res.real = node->value.real;
+	return res;
 }
 
-static void
+static minako_data_t
 execBoolean(const syntree_node_t* node)
 {
-	vm->eax.type = node->type;
-	vm->eax.value.boolean = node->value.boolean;
-	TRACE_VALUE(vm->eax);
+	minako_data_t res;
+
+	res.boolean = node->value.boolean;
+	return res;
 }
 
-static void
+static minako_data_t
 execString(const syntree_node_t* node)
 {
-	vm->eax.type = node->type;
-	vm->eax.value.string = node->value.string;
-	TRACE_VALUE(vm->eax);
+	minako_data_t res;
+
+	res.string = syntreeNodeId(ast, node);
+	return res;
 }
 
-static void
+static minako_data_t
 execLocVar(const syntree_node_t* node)
 {
-	vm->eax = vm->ebp[node->value.variable];
+	return vm->ebp[node->value.variable];
 }
 
-static void
+static minako_data_t
 execGlobVar(const syntree_node_t* node)
 {
-	vm->eax = vm->stack[node->value.variable];
+	return vm->stack[node->value.variable];
 }
 
 /* ********************************* */
 /* Anweisungen */
 /* ********************************* */
 
-static void
+static minako_data_t
 execProgram(const syntree_node_t* node)
 {
 	/* prepare the VM for execution */
 	vm->returnFlag = 0;
 	vm->ebp = vm->esp = vm->stack;
 
-	for(unsigned int i = 0; i < MINAKO_STACK_SIZE; i++)
-	{
-        vm->stack[i].type = SYNTREE_TYPE_Void;
-        vm->stack[i].value.integer = DUMMY; // -1
-	}
-
-	/* allocate space for global variables */
+	/* allocate space for global variables (pages start out as DUMMY) */
 	vm->esp += node->value.program.globals;
 
-	/* protect from stack overflow */
-	if (vm->esp >= vm->stack + MINAKO_STACK_SIZE)
-	{
-		fprintf(stderr, "stack overflow\n");
-		exit(-1);
-	}
-
-	execSequence(node);
+	return execSequence(node);
 }
 
-static void
+static minako_data_t
 execFunction(const syntree_node_t* node)
 {
+	syntree_nid id = syntreeNodeId(ast, node);
+	syntree_nid caller = (tier != NULL) ? tier->func : 0;
+	const closure_t* code;
 
-    unsigned int locals = node->value.function.locals;
 	vm->ebp = vm->esp;
-	vm->esp += locals;
 
-	execSequence(nodeFirst(node));
+	for (;;)
+	{
+		vm->esp = vm->ebp + node->value.function.locals;
+		frameInit(vm->ebp, id);
 
-	vm->returnFlag = 0;
+		/* Rücksprünge zählen für die gerade interpretierte Funktion */
+		if (tier != NULL)
+			tier->func = id;
+
+		execSequence(nodeFirst(node));
+		vm->returnFlag = 0;
+
+		if (pending == NULL)
+			break;
+
+		/* Endaufruf: der Rahmen enthält bereits die Argumente */
+		node = pending;
+		id = syntreeNodeId(ast, node);
+		pending = NULL;
+
+		if (jit != NULL && jit->entry[id] != NULL)
+		{
+			frameInit(vm->ebp, id);
+			vm->eax.value.integer = jit->entry[id](vm->ebp, vm->stack, vm->limit);
+			break;
+		}
+
+		if (tier != NULL && (code = tierPromote(node)) != NULL)
+		{
+			vm->esp = vm->ebp;
+			vm->eax.value = closureInvoke(code, vm);
+			break;
+		}
+	}
+
+	if (tier != NULL)
+		tier->func = caller;
+
+	/* der Rückgabewert überdauert das Verlassen der Anweisungen in eax */
+	return vm->eax.value;
 }
 
-static void
+static minako_data_t
 execCall(const syntree_node_t* node)
 {
 	syntree_node_t *func = nodeLast(node);
-	if(vm->esp + func->value.function.locals - vm->stack >= MINAKO_STACK_SIZE)
-    {
-        fputs("stack overflow\n", stderr);
-        exit(-1);
-    }
+	const closure_t* code;
+	minako_data_t key[MEMO_MAX_ARGS];
+	minako_data_t res;
+	int cached = 0;
+
+	VMSTACK_PROBE();
+	QUOTA_BURN();
 
+	/* Überläufe meldet der Schutzbereich des Stacks (siehe vmstack.h) */
     unsigned int locals = func->value.function.locals;
 
-    minako_value_t *params = vm->esp;
+    minako_data_t *params = vm->esp;
     vm->esp += locals;
-    minako_value_t *old_ebp = vm->ebp;
+    minako_data_t *old_ebp = vm->ebp;
 
 	unsigned int i = 0;
 	syntree_node_t *sequence = nodeFirst(node); // Sequence von Argumenten
@@ -314,18 +514,67 @@ execCall(const syntree_node_t* node)
 
     vm->esp = params;
 
-	dispatch(func);
+	/* reine Funktionen: Ergebnis aus dem Cache, die Argumente werden vor dem
+	 * Aufruf gesichert, da die Funktion ihre Parameter überschreiben kann */
+	if (memo != NULL && memo->pure[node->value.container.last])
+	{
+		if (memoLookup(memo, node->value.container.last, params, &res))
+			return res;
+
+		memcpy(key, params, memo->params[node->value.container.last] * sizeof(*key));
+		cached = 1;
+	}
+
+	/* springe in den übersetzten Code, falls vorhanden */
+	if (jit != NULL && jit->entry[node->value.container.last] != NULL)
+	{
+		/* übersetzte Funktionen erwarten einen vorbereiteten Rahmen */
+		frameInit(params, node->value.container.last);
+		res.integer = jit->entry[node->value.container.last](
+			params, vm->stack, vm->limit);
+		vm->ebp = params;
+	}
+	else if (tier != NULL && (code = tierPromote(func)) != NULL)
+		res = closureInvoke(code, vm);
+	else
+		res = dispatch(func);
+
+	if (cached)
+		memoStore(memo, node->value.container.last, key, res);
 
-	for(unsigned int i = 0; i < locals; i++)
-    {
-        params[i].type = SYNTREE_TYPE_Void;
-        params[i].value.integer = DUMMY;    // -1
-    }
 	vm->esp = vm->ebp;
 	vm->ebp = old_ebp;
+	return res;
 }
 
-static void
+/**@brief Endaufruf: überträgt die Argumente in den Rahmen der laufenden
+ * Funktion, die umgebende Rücksprunganweisung verlässt deren Körper und
+ * execFunction() setzt die Ausführung in der gerufenen Funktion fort.
+ */
+static minako_data_t
+execTailCall(const syntree_node_t* node)
+{
+	const syntree_node_t* argument = nodeFirst(nodeFirst(node));
+	minako_data_t* args = vm->esp;
+	unsigned int count = 0;
+
+	QUOTA_BURN();
+
+	/* die Argumente können noch den alten Rahmen lesen */
+	while (!nodeSentinel(argument))
+	{
+		args[count] = dispatch(argument);
+		vm->esp = args + ++count;
+		argument = nodeNext(argument);
+	}
+
+	vm->esp = args;
+	memmove(vm->ebp, args, count * sizeof(*args));
+	pending = nodeLast(node);
+	return vm->eax.value;
+}
+
+static minako_data_t
 execSequence(const syntree_node_t* node)
 {
 
@@ -338,9 +587,11 @@ execSequence(const syntree_node_t* node)
 		dispatch(ptr);
 		ptr = nodeNext(ptr);
 	}
+
+	return vm->eax.value;
 }
 
-static void
+static minako_data_t
 execIf(const syntree_node_t* node)
 {
 	const syntree_node_t* test = nodeFirst(node);
@@ -348,8 +599,7 @@ execIf(const syntree_node_t* node)
 	const syntree_node_t* opt_else = nodeNext(cons);
 
 	/* test if we need to select the else block */
-	dispatch(test);
-	if (vm->eax.value.boolean)
+	if (dispatch(test).boolean)
     {
 		dispatch(cons);
     }
@@ -358,13 +608,16 @@ execIf(const syntree_node_t* node)
         if(!nodeSentinel(opt_else))
             dispatch(opt_else);
     }
+
+	return vm->eax.value;
 }
 
-static void
+static minako_data_t
 execDoWhile(const syntree_node_t* node)
 {
 	const syntree_node_t* cond = nodeFirst(node);
 	const syntree_node_t* exec = nodeLast(node);
+	const closure_t* code;
 
 	do
 	{
@@ -372,115 +625,152 @@ execDoWhile(const syntree_node_t* node)
 
 		if (vm->returnFlag)
 			break;
+
+		/* setze die Schleife in den Closures fort */
+		if ((code = tierBackEdge(node)) != NULL)
+		{
+			closureResume(code, vm);
+			break;
+		}
 	}
-	while (dispatch(cond).value.boolean);
+	while (dispatch(cond).boolean);
+
+	return vm->eax.value;
 }
 
-static void
+static minako_data_t
 execWhile(const syntree_node_t* node)
 {
 	const syntree_node_t* cond = nodeFirst(node);
 	const syntree_node_t* body = nodeLast(node);
+	const closure_t* code;
 
-	do
+	while (dispatch(cond).boolean)
 	{
 		dispatch(body);
 
-		if (vm->returnFlag){
+		if (vm->returnFlag)
+			break;
+
+		/* setze die Schleife in den Closures fort */
+		if ((code = tierBackEdge(node)) != NULL)
+		{
+			closureResume(code, vm);
 			break;
 		}
 	}
-	while (dispatch(cond).value.boolean);
+
+	return vm->eax.value;
 }
 
-static void
+static minako_data_t
 execFor(const syntree_node_t* node)
 {
     syntree_node_t *init = nodeFirst(node);
     syntree_node_t *cond = nodeNext(init);
     syntree_node_t *step = nodeNext(cond);
     syntree_node_t *body = nodeNext(step);
+    const closure_t *code;
 
     dispatch(init);
-    minako_value_t v_cond, v_step, v_body;
     while(1)
     {
-        v_cond = dispatch(cond);
-        if(v_cond.value.boolean == 0)
+        if(dispatch(cond).boolean == 0)
+        {
+            break;
+        }
+        dispatch(body);
+        if(vm->returnFlag)
         {
             break;
         }
-        v_body = dispatch(body);
-        v_step = dispatch(step);
+        if((code = tierBackEdge(node)) != NULL)
+        {
+            closureResume(code, vm);
+            break;
+        }
+        dispatch(step);
     }
+
+    return vm->eax.value;
 }
 
-static void
+static minako_data_t
 execPrint(const syntree_node_t* node)
 {
-	switch (dispatch(nodeFirst(node)).type)
+	const syntree_node_t* arg = nodeFirst(node);
+	minako_data_t val = dispatch(arg);
+
+	switch (arg->type)
 	{
 	case SYNTREE_TYPE_Boolean:
-		fputs(vm->eax.value.boolean ? "true" : "false", stdout);
+		fputs(val.boolean ? "true" : "false", stdout);
 		break;
 
 	case SYNTREE_TYPE_Integer:
-		printf("%i", vm->eax.value.integer);
+		printf("%i", val.integer);
 		break;
 
 	case SYNTREE_TYPE_Float:
-		printf("%g", vm->eax.value.real);
+		printf("%g", val.real);
 		break;
 
 	case SYNTREE_TYPE_String:
-		fputs(vm->eax.value.string, stdout);
+		fputs(syntreeNodePtr(ast, val.string)->value.string, stdout);
+		break;
+
+	default:
 		break;
 	}
 
 	putc('\n', stdout);
+	return val;
 }
 
-static void
+static minako_data_t
 execAssign(const syntree_node_t* node)
 {
     syntree_node_t *var = nodeFirst(node);
     syntree_node_t *expr = nodeNext(var);
-    dispatch(expr);
+    minako_data_t val = dispatch(expr);
     unsigned int offset = var->value.variable;
     if(var->tag == SYNTREE_TAG_GlobVar)
-        vm->stack[offset] = vm->eax;
+        vm->stack[offset] = val;
     if(var->tag == SYNTREE_TAG_LocVar)
-        vm->ebp[offset] = vm->eax;
+        vm->ebp[offset] = val;
+    return val;
 }
 
-static void
+static minako_data_t
 execReturn(const syntree_node_t* node)
 {
 	node = nodeFirst(node);
 
+	/* der Rückgabewert muss das Verlassen der Anweisungen überdauern */
 	if (!nodeSentinel(node))
-		dispatch(node);
+		vm->eax.value = dispatch(node);
 
 	vm->returnFlag = 1;
+	return vm->eax.value;
 }
 
 /* ********************************* */
 /* Ausdrücke */
 /* ********************************* */
 
-static void
+static minako_data_t
 execCast(const syntree_node_t* node)
 {
-	dispatch(nodeFirst(node));
+	const syntree_node_t* arg = nodeFirst(node);
+	minako_data_t val = dispatch(arg);
 
 	switch (node->type)
 	{
 	case SYNTREE_TYPE_Float:
-		switch (vm->eax.type)
+		switch (arg->type)
 		{
 		case SYNTREE_TYPE_Integer:
-			vm->eax.type = node->type;
-			vm->eax.value.real = vm->eax.value.integer;
+			val.real = (float) val.integer;
 			break;
 
 		default:
@@ -492,318 +782,690 @@ execCast(const syntree_node_t* node)
 	default:
 		assert(!"unexpected target type");
 	}
+
+	return val;
 }
 
-static void
+static minako_data_t
 execPlus(const syntree_node_t* node)
 {
 
-	minako_value_t lhs = dispatch(nodeFirst(node));
-	minako_value_t rhs = dispatch(nodeLast(node));
+	minako_data_t lhs = dispatch(nodeFirst(node));
+	minako_data_t rhs = dispatch(nodeLast(node));
+	minako_data_t res;
 
 	switch (node->type)
 	{
 	case SYNTREE_TYPE_Integer:
-		vm->eax.value.integer = lhs.value.integer + rhs.value.integer;
+		res.integer = lhs.integer + rhs.integer;
 		break;
 
 	case SYNTREE_TYPE_Float:
-		vm->eax.value.real = lhs.value.real + rhs.value.real;
+		res.real = lhs.real + rhs.real;
 		break;
 
 	default:
 		assert(!"unexpected type in operation");
 	}
+
+	return res;
 }
 
-static void
+static minako_data_t
 execMinus(const syntree_node_t* node)
 {
-	minako_value_t lhs = dispatch(nodeFirst(node));
-	minako_value_t rhs = dispatch(nodeLast(node));
+	minako_data_t lhs = dispatch(nodeFirst(node));
+	minako_data_t rhs = dispatch(nodeLast(node));
+	minako_data_t res;
 
 	switch (node->type)
 	{
 	case SYNTREE_TYPE_Integer:
-		vm->eax.value.integer = lhs.value.integer - rhs.value.integer;
+		res.integer = lhs.integer - rhs.integer;
 		break;
 
 	case SYNTREE_TYPE_Float:
-		vm->eax.value.real = lhs.value.real - rhs.value.real;
+		res.real = lhs.real - rhs.real;
 		break;
 
 	default:
 		assert(!"unexpected type in operation");
 	}
+
+	return res;
 }
 
-static void
+static minako_data_t
 execTimes(const syntree_node_t* node)
 {
-	minako_value_t lhs = dispatch(nodeFirst(node));
-	minako_value_t rhs = dispatch(nodeLast(node));
+	minako_data_t lhs = dispatch(nodeFirst(node));
+	minako_data_t rhs = dispatch(nodeLast(node));
+	minako_data_t res;
 
 	switch (node->type)
 	{
 	case SYNTREE_TYPE_Integer:
-		vm->eax.value.integer = lhs.value.integer * rhs.value.integer;
+		res.integer = lhs.integer * rhs.integer;
 		break;
 
 	case SYNTREE_TYPE_Float:
-		vm->eax.value.real = lhs.value.real * rhs.value.real;
+		res.real = lhs.real * rhs.real;
 		break;
 
 	default:
 		assert(!"unexpected type in operation");
 	}
+
+	return res;
 }
 
-static void
+static minako_data_t
 execDivide(const syntree_node_t* node)
 {
-	minako_value_t lhs = dispatch(nodeFirst(node));
-	minako_value_t rhs = dispatch(nodeLast(node));
+	minako_data_t lhs = dispatch(nodeFirst(node));
+	minako_data_t rhs = dispatch(nodeLast(node));
+	minako_data_t res;
 
 	switch (node->type)
 	{
 	case SYNTREE_TYPE_Integer:
-		vm->eax.value.integer = lhs.value.integer / rhs.value.integer;
+		res.integer = lhs.integer / rhs.integer;
 		break;
 
 	case SYNTREE_TYPE_Float:
-		vm->eax.value.real = lhs.value.real / rhs.value.real;
+		res.real = lhs.real / rhs.real;
 		break;
 
 	default:
 		assert(!"unexpected type in operation");
 	}
+
+	return res;
 }
 
-static void
+static minako_data_t
 execLogOr(const syntree_node_t* node)
 {
-	(void) (dispatch(nodeFirst(node)).value.boolean
-	|| dispatch(nodeLast(node)).value.boolean);
+	minako_data_t res;
+
+	res.boolean = dispatch(nodeFirst(node)).boolean
+	           || dispatch(nodeLast(node)).boolean;
+	return res;
 }
 
-static void
+static minako_data_t
 execLogAnd(const syntree_node_t* node)
 {
-	(void) (dispatch(nodeFirst(node)).value.boolean
-	&& dispatch(nodeLast(node)).value.boolean);
+	minako_data_t res;
+
+	res.boolean = dispatch(nodeFirst(node)).boolean
+	           && dispatch(nodeLast(node)).boolean;
+	return res;
 }
 
-static void
+static minako_data_t
 execUminus(const syntree_node_t* node)
 {
-    dispatch(nodeFirst(node));
-    if(vm->eax.type == SYNTREE_TYPE_Integer)
-        vm->eax.value.integer = -vm->eax.value.integer;
-    if(vm->eax.type == SYNTREE_TYPE_Float)
-        vm->eax.value.real = -vm->eax.value.real;
+    minako_data_t val = dispatch(nodeFirst(node));
+    if(node->type == SYNTREE_TYPE_Integer)
+        val.integer = -val.integer;
+    if(node->type == SYNTREE_TYPE_Float)
+        val.real = -val.real;
+    return val;
 }
 
-static void
-execEqt(const syntree_node_t* node)
-{
-    syntree_node_t *lhs = nodeFirst(node), *rhs = nodeLast(node);
+/**@brief Definiert die Interpreterfunktion eines Vergleichs, der nach dem
+ * statischen Typ des linken Operanden unterscheidet.
+ * @param NAME  Knotenart
+ * @param OP    C-Operator
+ * @param BOOL  Wahrheitswerte ebenfalls vergleichen
+ */
+#define COMPARE(NAME, OP, BOOL) \
+	static minako_data_t \
+	exec ## NAME(const syntree_node_t* node) \
+	{ \
+		const syntree_node_t *lhs = nodeFirst(node), *rhs = nodeLast(node); \
+		minako_data_t vlhs = dispatch(lhs); \
+		minako_data_t vrhs = dispatch(rhs); \
+		minako_data_t res; \
+		\
+		switch (lhs->type) \
+		{ \
+		case SYNTREE_TYPE_Boolean: \
+			assert(BOOL && "unexpected type in operation"); \
+			res.boolean = vlhs.boolean OP vrhs.boolean; \
+			break; \
+		\
+		case SYNTREE_TYPE_Integer: \
+			res.boolean = vlhs.integer OP vrhs.integer; \
+			break; \
+		\
+		case SYNTREE_TYPE_Float: \
+			res.boolean = vlhs.real OP vrhs.real; \
+			break; \
+		\
+		default: \
+			assert(!"unexpected type in operation"); \
+		} \
+		\
+		return res; \
+	}
 
-    minako_value_t vlhs = dispatch(lhs);
-    minako_value_t vrhs = dispatch(rhs);
+COMPARE(Eqt, ==, 1)
+COMPARE(Neq, !=, 1)
+COMPARE(Leq, <=, 0)
+COMPARE(Geq, >=, 0)
+COMPARE(Lst, <,  0)
+COMPARE(Grt, >,  0)
 
-	switch (vlhs.type)
-	{
-	case SYNTREE_TYPE_Boolean:
-		if(vlhs.value.boolean == vrhs.value.boolean)
-            vm->eax.value.boolean = 1;
-        else
-            vm->eax.value.boolean = 0;
-		break;
+#undef COMPARE
 
-	case SYNTREE_TYPE_Integer:
-		if(vlhs.value.integer == vrhs.value.integer)
-            vm->eax.value.boolean = 1;
-        else
-            vm->eax.value.boolean = 0;
-		break;
+/* ********************************* */
+/* Typspezialisierte Ausdrücke */
+/* ********************************* */
 
-	case SYNTREE_TYPE_Float:
-		if(vlhs.value.real == vrhs.value.real)
-            vm->eax.value.boolean = 1;
-        else
-            vm->eax.value.boolean = 0;
-		break;
+/**@brief Definiert die Interpreterfunktion einer typspezialisierten binären
+ * Operation (siehe quicken.h).
+ * @param NAME   Knotenart
+ * @param FIELD  Feld der Operanden
+ * @param OP     C-Operator
+ * @param RES    Feld des Ergebnisses
+ */
+#define QUICK_BINARY(NAME, FIELD, OP, RES) \
+	static minako_data_t \
+	exec ## NAME(const syntree_node_t* node) \
+	{ \
+		minako_data_t lhs = dispatch(nodeFirst(node)); \
+		minako_data_t rhs = dispatch(nodeLast(node)); \
+		minako_data_t res; \
+		res.RES = lhs.FIELD OP rhs.FIELD; \
+		return res; \
+	}
 
-	default:
-		assert(!"unexpected type in operation");
+QUICK_BINARY(PlusInt,     integer, +,  integer)
+QUICK_BINARY(PlusFloat,   real,    +,  real)
+QUICK_BINARY(MinusInt,    integer, -,  integer)
+QUICK_BINARY(MinusFloat,  real,    -,  real)
+QUICK_BINARY(TimesInt,    integer, *,  integer)
+QUICK_BINARY(TimesFloat,  real,    *,  real)
+QUICK_BINARY(DivideInt,   integer, /,  integer)
+QUICK_BINARY(DivideFloat, real,    /,  real)
+QUICK_BINARY(EqtInt,      integer, ==, boolean)
+QUICK_BINARY(EqtFloat,    real,    ==, boolean)
+QUICK_BINARY(NeqInt,      integer, !=, boolean)
+QUICK_BINARY(NeqFloat,    real,    !=, boolean)
+QUICK_BINARY(LeqInt,      integer, <=, boolean)
+QUICK_BINARY(LeqFloat,    real,    <=, boolean)
+QUICK_BINARY(GeqInt,      integer, >=, boolean)
+QUICK_BINARY(GeqFloat,    real,    >=, boolean)
+QUICK_BINARY(LstInt,      integer, <,  boolean)
+QUICK_BINARY(LstFloat,    real,    <,  boolean)
+QUICK_BINARY(GrtInt,      integer, >,  boolean)
+QUICK_BINARY(GrtFloat,    real,    >,  boolean)
+
+#undef QUICK_BINARY
+
+/* ********************************* */
+/* Fusionierte Ausdrücke (siehe fuse.h) */
+/* ********************************* */
+
+/**@brief Erzeugt eine Interpreterfunktion für einen Operator mit lokaler
+ * Variable und Konstante als Operanden.
+ * @param NAME   Name der fusionierten Knotenart
+ * @param FIELD  Feld der Operanden
+ * @param OP     C-Operator
+ * @param RES    Feld des Ergebnisses
+ */
+#define FUSED_LOC_K(NAME, FIELD, OP, RES) \
+	static minako_data_t \
+	exec ## NAME(const syntree_node_t* node) \
+	{ \
+		minako_data_t res; \
+		res.RES = vm->ebp[nodeFirst(node)->value.variable].FIELD \
+			OP nodeLast(node)->value.FIELD; \
+		return res; \
+	}
+
+/**@brief Erzeugt eine Interpreterfunktion für einen Vergleich zweier lokaler
+ * Variablen.
+ * @param NAME   Name der fusionierten Knotenart
+ * @param OP     C-Operator
+ */
+#define FUSED_LOC_LOC(NAME, OP) \
+	static minako_data_t \
+	exec ## NAME(const syntree_node_t* node) \
+	{ \
+		minako_data_t res; \
+		res.boolean = vm->ebp[nodeFirst(node)->value.variable].integer \
+			OP vm->ebp[nodeLast(node)->value.variable].integer; \
+		return res; \
 	}
-	vm->eax.type = SYNTREE_TYPE_Boolean;
+
+FUSED_LOC_K(PlusIntLocK,     integer, +,  integer)
+FUSED_LOC_K(MinusIntLocK,    integer, -,  integer)
+FUSED_LOC_K(TimesIntLocK,    integer, *,  integer)
+FUSED_LOC_K(DivideIntLocK,   integer, /,  integer)
+FUSED_LOC_K(PlusFloatLocK,   real,    +,  real)
+FUSED_LOC_K(MinusFloatLocK,  real,    -,  real)
+FUSED_LOC_K(TimesFloatLocK,  real,    *,  real)
+FUSED_LOC_K(DivideFloatLocK, real,    /,  real)
+FUSED_LOC_K(EqtIntLocK,      integer, ==, boolean)
+FUSED_LOC_K(NeqIntLocK,      integer, !=, boolean)
+FUSED_LOC_K(LeqIntLocK,      integer, <=, boolean)
+FUSED_LOC_K(GeqIntLocK,      integer, >=, boolean)
+FUSED_LOC_K(LstIntLocK,      integer, <,  boolean)
+FUSED_LOC_K(GrtIntLocK,      integer, >,  boolean)
+
+FUSED_LOC_LOC(EqtIntLocLoc, ==)
+FUSED_LOC_LOC(NeqIntLocLoc, !=)
+FUSED_LOC_LOC(LeqIntLocLoc, <=)
+FUSED_LOC_LOC(GeqIntLocLoc, >=)
+FUSED_LOC_LOC(LstIntLocLoc, <)
+FUSED_LOC_LOC(GrtIntLocLoc, >)
+
+#undef FUSED_LOC_K
+#undef FUSED_LOC_LOC
+
+static minako_data_t
+execAssignLocPlusK(const syntree_node_t* node)
+{
+	const syntree_node_t* plus = nodeLast(node);
+	minako_data_t res;
+
+	res.integer = vm->ebp[nodeFirst(plus)->value.variable].integer
+	            + nodeLast(plus)->value.integer;
+	vm->ebp[nodeFirst(node)->value.variable] = res;
+	return res;
 }
 
-static void
-execNeq(const syntree_node_t* node)
+static minako_data_t
+execCastInt(const syntree_node_t* node)
 {
-    syntree_node_t *lhs = nodeFirst(node), *rhs = nodeLast(node);
+	minako_data_t res;
 
-    minako_value_t vlhs = dispatch(lhs);
-    minako_value_t vrhs = dispatch(rhs);
+	res.real = (float) dispatch(nodeFirst(node)).integer;
+	return res;
+}
 
-	switch (vlhs.type)
-	{
-	case SYNTREE_TYPE_Boolean:
-		if(vlhs.value.boolean != vrhs.value.boolean)
-            vm->eax.value.boolean = 1;
-        else
-            vm->eax.value.boolean = 0;
-		break;
+static minako_data_t
+execUminusInt(const syntree_node_t* node)
+{
+	minako_data_t res;
 
-	case SYNTREE_TYPE_Integer:
-		if(vlhs.value.integer != vrhs.value.integer)
-            vm->eax.value.boolean = 1;
-        else
-            vm->eax.value.boolean = 0;
-		break;
+	res.integer = -dispatch(nodeFirst(node)).integer;
+	return res;
+}
 
-	case SYNTREE_TYPE_Float:
-		if(vlhs.value.real != vrhs.value.real)
-            vm->eax.value.boolean = 1;
-        else
-            vm->eax.value.boolean = 0;
-		break;
+static minako_data_t
+execUminusFloat(const syntree_node_t* node)
+{
+	minako_data_t res;
 
-	default:
-		assert(!"unexpected type in operation");
-	}
-	vm->eax.type = SYNTREE_TYPE_Boolean;
+	res.real = -dispatch(nodeFirst(node)).real;
+	return res;
 }
 
+/* *************************************************************** driver *** */
+
+/**@brief Gibt die Aufrufsyntax aus und beendet das Programm.
+ */
 static void
-execLeq(const syntree_node_t* node)
+usage(const char* prog)
 {
-	syntree_node_t *lhs = nodeFirst(node), *rhs = nodeLast(node);
-
-    minako_value_t vlhs = dispatch(lhs);
-    minako_value_t vrhs = dispatch(rhs);
+	fprintf(stderr,
+	        "usage: %s [options] [file]\n"
+	        "  --engine=bytecode  execute on the register VM (default)\n"
+	        "  --engine=closure   execute precompiled closures\n"
+	        "  --engine=tree      execute with the tree-walking interpreter\n"
+	        "  --engine=stackless execute with a tree walker that keeps C1\n"
+	        "                     calls off the C stack (no depth limit)\n"
+	        "  --print-bytecode   print the compiled bytecode and exit\n"
+	        "  --jit              compile functions to x86-64 machine code\n"
+	        "                     (implies --engine=tree)\n"
+	        "  --trace            print every interpreted node to stdout\n"
+	        "                     (implies --engine=tree)\n"
+	        "  -S                 write x86-64 assembly instead of running\n"
+	        "  -o <file>          build a standalone executable (or, with -S,\n"
+	        "                     the name of the assembly file)\n"
+	        "  --emit-c           write equivalent C99 source to stdout (or to\n"
+	        "                     the file given with -o)\n"
+	        "  --tier-threshold=N promote tree-interpreted functions to closures\n"
+	        "                     after N calls and loop iterations (default\n"
+	        "                     1000, 0 disables tiering)\n"
+	        "  --tier-stats       report call and loop counters on stderr\n"
+	        "  --fuse, --no-fuse  fuse common node patterns into\n"
+	        "                     superinstructions (tree engine, default on)\n"
+	        "  --memo-size=KB     cache results of pure functions in a table of\n"
+	        "                     at most KB kibibytes (tree engine, default 1024)\n"
+	        "  --no-memo          do not cache results of pure functions\n"
+	        "  --no-iterate       keep linear recursion instead of rewriting it\n"
+	        "                     into accumulator loops\n"
+	        "  --inline-budget=N  inline non-recursive functions whose body has\n"
+	        "                     at most N nodes (default 40)\n"
+	        "  --no-inline        do not inline functions\n"
+	        "  --inline-report    report inlining decisions on stderr\n"
+	        "  --no-fold          do not fold constants, propagate constant\n"
+	        "                     locals or simplify identities\n"
+	        "  --fold-report      report folded expressions and the node count\n"
+	        "                     before and after folding on stderr\n"
+	        "  --no-licm          keep loop-invariant expressions inside loops\n"
+	        "  --no-strength      keep multiplications by loop counters and float\n"
+	        "                     divisions by powers of two\n"
+	        "  --no-scev          keep summation and counting loops instead of\n"
+	        "                     evaluating them in closed form\n"
+	        "  --no-dce           keep unreachable statements, uncalled\n"
+	        "                     functions and stores that are never read\n"
+	        "  --warn-uninit      report local variable slots that may be read\n"
+	        "                     before they are assigned\n"
+	        "  --max-stack=MB     reserve MB mebibytes for the variable stack\n"
+	        "                     (default 1024, pages are committed on use);\n"
+	        "                     exceeding it exits with status 5\n"
+	        "  --max-fuel=N       abort with status 3 after N function calls and\n"
+	        "                     loop iterations (0 = unlimited)\n"
+	        "  --timeout=SEC      abort with status 4 after SEC seconds of wall\n"
+	        "                     clock time (0 = unlimited)\n",
+	        prog);
+	exit(-1);
+}
 
-	switch (vlhs.type)
+/**@brief Wertet die Kommandozeilenargumente aus.
+ */
+static void
+parseOptions(minako_options_t* opts, int argc, const char* argv[])
+{
+	int i;
+
+	opts->engine = MINAKO_ENGINE_Bytecode;
+	opts->printBytecode = 0;
+	opts->jit = 0;
+	opts->trace = 0;
+	opts->emitAsm = 0;
+	opts->emitC = 0;
+	opts->tierThreshold = 1000;
+	opts->tierStats = 0;
+	opts->fuse = 1;
+	opts->warnUninit = 0;
+	opts->iterate = 1;
+	opts->inlineBudget = 40;
+	opts->inlineReport = 0;
+	opts->fold = 1;
+	opts->foldReport = 0;
+	opts->licm = 1;
+	opts->strength = 1;
+	opts->scev = 1;
+	opts->dce = 1;
+	opts->memoSize = 1024;
+	opts->maxStack = MINAKO_STACK_DEFAULT;
+	opts->maxFuel = 0;
+	opts->timeout = 0;
+	opts->output = NULL;
+	opts->file = NULL;
+
+	for (i = 1; i < argc; ++i)
 	{
-	case SYNTREE_TYPE_Integer:
-		if(vlhs.value.integer <= vrhs.value.integer)
-            vm->eax.value.boolean = 1;
-        else
-            vm->eax.value.boolean = 0;
-		break;
+		if (!strcmp(argv[i], "--engine=bytecode"))
+			opts->engine = MINAKO_ENGINE_Bytecode;
+		else if (!strcmp(argv[i], "--engine=closure"))
+			opts->engine = MINAKO_ENGINE_Closure;
+		else if (!strcmp(argv[i], "--engine=tree"))
+			opts->engine = MINAKO_ENGINE_Tree;
+		else if (!strcmp(argv[i], "--engine=stackless"))
+			opts->engine = MINAKO_ENGINE_Stackless;
+		else if (!strcmp(argv[i], "--print-bytecode"))
+			opts->printBytecode = 1;
+		else if (!strcmp(argv[i], "--jit"))
+			opts->jit = 1;
+		else if (!strcmp(argv[i], "--trace"))
+			opts->trace = 1;
+		else if (!strcmp(argv[i], "-S"))
+			opts->emitAsm = 1;
+		else if (!strcmp(argv[i], "--emit-c"))
+			opts->emitC = 1;
+		else if (!strncmp(argv[i], "--tier-threshold=", 17))
+			opts->tierThreshold = strtoul(argv[i] + 17, NULL, 10);
+		else if (!strcmp(argv[i], "--tier-stats"))
+			opts->tierStats = 1;
+		else if (!strcmp(argv[i], "--fuse"))
+			opts->fuse = 1;
+		else if (!strcmp(argv[i], "--no-fuse"))
+			opts->fuse = 0;
+		else if (!strncmp(argv[i], "--memo-size=", 12))
+			opts->memoSize = strtoul(argv[i] + 12, NULL, 10);
+		else if (!strcmp(argv[i], "--no-memo"))
+			opts->memoSize = 0;
+		else if (!strcmp(argv[i], "--no-iterate"))
+			opts->iterate = 0;
+		else if (!strncmp(argv[i], "--inline-budget=", 16))
+			opts->inlineBudget = strtoul(argv[i] + 16, NULL, 10);
+		else if (!strcmp(argv[i], "--no-inline"))
+			opts->inlineBudget = 0;
+		else if (!strcmp(argv[i], "--inline-report"))
+			opts->inlineReport = 1;
+		else if (!strcmp(argv[i], "--no-fold"))
+			opts->fold = 0;
+		else if (!strcmp(argv[i], "--fold-report"))
+			opts->foldReport = 1;
+		else if (!strcmp(argv[i], "--no-licm"))
+			opts->licm = 0;
+		else if (!strcmp(argv[i], "--no-strength"))
+			opts->strength = 0;
+		else if (!strcmp(argv[i], "--no-scev"))
+			opts->scev = 0;
+		else if (!strcmp(argv[i], "--no-dce"))
+			opts->dce = 0;
+		else if (!strcmp(argv[i], "--warn-uninit"))
+			opts->warnUninit = 1;
+		else if (!strncmp(argv[i], "--max-fuel=", 11))
+			opts->maxFuel = strtoul(argv[i] + 11, NULL, 10);
+		else if (!strncmp(argv[i], "--timeout=", 10))
+			opts->timeout = strtoul(argv[i] + 10, NULL, 10);
+		else if (!strncmp(argv[i], "--max-stack=", 12))
+			opts->maxStack = strtoul(argv[i] + 12, NULL, 10);
+		else if (!strcmp(argv[i], "-o") && i + 1 < argc)
+			opts->output = argv[++i];
+		else if (argv[i][0] == '-' || opts->file != NULL)
+			usage(argv[0]);
+		else
+			opts->file = argv[i];
+	}
 
-	case SYNTREE_TYPE_Float:
-		if(vlhs.value.real <= vrhs.value.real)
-            vm->eax.value.boolean = 1;
-        else
-            vm->eax.value.boolean = 0;
-		break;
+	/* der übersetzte Code wird aus dem Bauminterpreter heraus aufgerufen */
+	if (opts->jit || opts->trace)
+		opts->engine = MINAKO_ENGINE_Tree;
+}
 
-	default:
-		assert(!"unexpected type in operation");
+/**@brief Initialisiert die gestufte Ausführung.
+ */
+static void
+tierInit(minako_tier_t* self, unsigned long threshold)
+{
+	self->count = calloc(ast->len, sizeof(*self->count));
+	self->edges = calloc(ast->len, sizeof(*self->edges));
+	self->owner = calloc(ast->len, sizeof(*self->owner));
+	self->loops = calloc(ast->len, sizeof(*self->loops));
+	self->func = 0;
+	self->threshold = threshold;
+
+	if (self->count == NULL || self->edges == NULL || self->owner == NULL
+	 || self->loops == NULL
+	 || closureInit(&self->prog))
+	{
+		fputs("out-of-memory error\n", stderr);
+		exit(-1);
 	}
-	vm->eax.type = SYNTREE_TYPE_Boolean;
 }
 
+/**@brief Gibt die gestufte Ausführung wieder frei.
+ */
+static void
+tierRelease(minako_tier_t* self)
+{
+	closureRelease(&self->prog);
+	free(self->count);
+	free(self->edges);
+	free(self->owner);
+	free(self->loops);
+}
+
+/**@brief Gibt die Zähler aller ausgeführten Funktionen und Schleifen aus.
+ */
 static void
-execGeq(const syntree_node_t* node)
+tierReport(const minako_tier_t* self, FILE* out)
 {
-	syntree_node_t *lhs = nodeFirst(node), *rhs = nodeLast(node);
+	syntree_nid id, loop;
 
-    minako_value_t vlhs = dispatch(lhs);
-    minako_value_t vrhs = dispatch(rhs);
+	fprintf(out, "tier: threshold %lu\n", self->threshold);
 
-	switch (vlhs.type)
+	for (id = 1; id < ast->len; ++id)
 	{
-	case SYNTREE_TYPE_Integer:
-		if(vlhs.value.integer >= vrhs.value.integer)
-            vm->eax.value.boolean = 1;
-        else
-            vm->eax.value.boolean = 0;
-		break;
+		if (ast->nodes[id].tag != SYNTREE_TAG_Function
+		 || self->count[id] + self->edges[id] == 0)
+			continue;
+
+		fprintf(out, "function %s: %lu calls, %lu back-edges, %s\n",
+		        symtabFunctionName(tab, id), self->count[id], self->edges[id],
+		        (self->prog.funcs != NULL && self->prog.funcs[id] != NULL)
+		        ? "promoted" : "interpreted");
+
+		for (loop = 1; loop < ast->len; ++loop)
+			if (self->owner[loop] == id)
+				fprintf(out, "  loop #%u (%s): %lu back-edges, %s\n", loop,
+				        nodeTagName[ast->nodes[loop].tag], self->count[loop],
+				        (self->loops[loop] != NULL) ? "replaced" : "interpreted");
+	}
+}
 
-	case SYNTREE_TYPE_Float:
-		if(vlhs.value.real >= vrhs.value.real)
-            vm->eax.value.boolean = 1;
-        else
-            vm->eax.value.boolean = 0;
-		break;
+/**@brief Übersetzt den Syntaxbaum in Bytecode und führt ihn aus.
+ */
+static int
+runBytecode(const minako_options_t* opts)
+{
+	bytecode_t code;
+	int rc;
 
-	default:
-		assert(!"unexpected type in operation");
+	if (bytecodeInit(&code))
+	{
+		fputs("out-of-memory error\n", stderr);
+		exit(-1);
+	}
+
+	bytecodeCompile(&code, ast);
+
+	if (opts->printBytecode)
+	{
+		bytecodePrint(&code, stdout);
+		rc = 0;
 	}
-	vm->eax.type = SYNTREE_TYPE_Boolean;
+	else
+		rc = bytecodeRun(&code, opts->maxStack);
+
+	bytecodeRelease(&code);
+	return rc;
 }
 
-static void
-execLst(const syntree_node_t* node)
+/**@brief Übersetzt den Syntaxbaum in Assembler und bindet ihn gegebenenfalls
+ * zu einem eigenständigen Programm.
+ */
+static int
+runNative(const minako_options_t* opts)
 {
-	syntree_node_t *lhs = nodeFirst(node), *rhs = nodeLast(node);
+	const char* base = (opts->file == NULL) ? "a.c1" : opts->file;
+	size_t len = strlen(base);
+	char* path;
+	FILE* out;
+	int rc;
 
-    minako_value_t vlhs = dispatch(lhs);
-    minako_value_t vrhs = dispatch(rhs);
+	/* -S -o prog.s schreibt nach prog.s, ansonsten prog.c1 -> prog.s bzw.
+	 * -o prog -> prog.s als Zwischendatei */
+	if (opts->output != NULL)
+		base = opts->output, len = strlen(base);
+	else if (len > 3 && !strcmp(base + len - 3, ".c1"))
+		len -= 3;
 
-	switch (vlhs.type)
+	if ((path = malloc(len + 3)) == NULL)
 	{
-	case SYNTREE_TYPE_Integer:
-		if(vlhs.value.integer < vrhs.value.integer)
-            vm->eax.value.boolean = 1;
-        else
-            vm->eax.value.boolean = 0;
-		break;
+		fputs("out-of-memory error\n", stderr);
+		exit(-1);
+	}
 
-	case SYNTREE_TYPE_Float:
-		if(vlhs.value.real < vrhs.value.real)
-            vm->eax.value.boolean = 1;
-        else
-            vm->eax.value.boolean = 0;
-		break;
+	if (opts->output != NULL && opts->emitAsm)
+		strcpy(path, base);
+	else
+		sprintf(path, "%.*s.s", (int) len, base);
 
-	default:
-		assert(!"unexpected type in operation");
+	if ((out = fopen(path, "w")) == NULL)
+	{
+		fprintf(stderr, "couldn't open file %s\n", path);
+		free(path);
+		return -1;
 	}
-	vm->eax.type = SYNTREE_TYPE_Boolean;
+
+	nativeEmit(ast, out);
+	fclose(out);
+
+	if (opts->emitAsm)
+		rc = 0;
+	else
+	{
+		rc = nativeLink(path, opts->output);
+		remove(path);
+	}
+
+	free(path);
+	return rc;
 }
 
-static void
-execGrt(const syntree_node_t* node)
+/**@brief Übersetzt den Syntaxbaum in C-Quelltext.
+ */
+static int
+runEmitC(const minako_options_t* opts)
 {
-	syntree_node_t *lhs = nodeFirst(node), *rhs = nodeLast(node);
+	FILE* out = (opts->output == NULL) ? stdout : fopen(opts->output, "w");
 
-    minako_value_t vlhs = dispatch(lhs);
-    minako_value_t vrhs = dispatch(rhs);
-
-	switch (vlhs.type)
+	if (out == NULL)
 	{
-	case SYNTREE_TYPE_Integer:
-		if(vlhs.value.integer > vrhs.value.integer)
-            vm->eax.value.boolean = 1;
-        else
-            vm->eax.value.boolean = 0;
-		break;
+		fprintf(stderr, "couldn't open file %s\n", opts->output);
+		return -1;
+	}
 
-	case SYNTREE_TYPE_Float:
-		if(vlhs.value.real > vrhs.value.real)
-            vm->eax.value.boolean = 1;
-        else
-            vm->eax.value.boolean = 0;
-		break;
+	cgenEmit(ast, out);
 
-	default:
-		assert(!"unexpected type in operation");
-	}
-	vm->eax.type = SYNTREE_TYPE_Boolean;
+	if (out != stdout)
+		fclose(out);
+
+	return 0;
 }
 
-/* *************************************************************** driver *** */
+/**@brief Übersetzt den Syntaxbaum in Closures und führt sie aus.
+ */
+static void
+runClosure(void)
+{
+	closure_program_t prog;
+
+	if (closureInit(&prog))
+	{
+		fputs("out-of-memory error\n", stderr);
+		exit(-1);
+	}
+
+	tailcallTree(ast);
+	closureCompile(&prog, ast);
+	closureRun(&prog, vm);
+	closureRelease(&prog);
+}
 
 int main(int argc, const char* argv[])
 {
+	minako_options_t opts;
 	symtab_t symtab;
 	syntree_t syntree;
 	minako_vm_t engine;
+	jit_t code;
+	minako_tier_t tiers;
+	definite_t uninit;
+	fold_stats_t folded;
+	memo_t results;
 	int rc;
 
 	/* belege die globalen Zeiger mit den lokalen Werten */
@@ -811,12 +1473,13 @@ int main(int argc, const char* argv[])
 	ast = &syntree;
 	vm = &engine;
 
-	/* versuche die Datei aus der Kommandozeile zu öffnen
-	 * oder lies aus der Standardeingabe */
-	yyin = (argc != 2) ? stdin : fopen(argv[1], "r");
+	/* werte die Kommandozeile aus und versuche die angegebene Datei zu
+	 * öffnen oder lies aus der Standardeingabe */
+	parseOptions(&opts, argc, argv);
+	yyin = (opts.file == NULL) ? stdin : fopen(opts.file, "r");
 
 	if (yyin == NULL)
-		yyerror("couldn't open file %s\n", argv[1]);
+		yyerror("couldn't open file %s\n", opts.file);
 
 	/* initialisiere die Hilfsstrukturen */
 	if (symtabInit(tab))
@@ -831,6 +1494,15 @@ int main(int argc, const char* argv[])
 		exit(-1);
 	}
 
+	if (quotaInit(opts.maxFuel, opts.timeout))
+		fputs("warning: time limit unavailable\n", stderr);
+
+	if (vmstackInit(vm, opts.maxStack))
+	{
+		fputs("out-of-memory error\n", stderr);
+		exit(-1);
+	}
+
 	/* parse das Programm */
 	yydebug = 0;
 	rc = yyparse();
@@ -847,11 +1519,142 @@ int main(int argc, const char* argv[])
 	if (rc == 0)
 	{
 		yydebug = 0;
-		dispatch(syntreeNodePtr(ast, 0));
+
+		/* neue Plätze müssen vor der Analyse feststehen */
+		if (opts.iterate)
+			iterateTree(ast);
+
+		/* eingesetzte Körper profitieren von Faltung und Bereinigung */
+		if (opts.inlineBudget > 0)
+			inlineTree(ast, opts.inlineBudget, opts.inlineReport ? stderr : NULL, tab);
+
+		/* vor der Analyse, da Lesezugriffe wegfallen können */
+		if (opts.fold)
+		{
+			if (foldTree(ast, &folded))
+			{
+				fputs("out-of-memory error\n", stderr);
+				exit(-1);
+			}
+
+			if (opts.foldReport)
+				foldReport(&folded, stderr);
+		}
+
+		/* nach der Faltung, damit konstante Ausdrücke nicht gezogen werden */
+		if (opts.licm)
+			licmTree(ast);
+
+		/* nach dem Vorziehen sind invariante Faktoren lokale Variablen */
+		if (opts.strength)
+			strengthTree(ast);
+
+		/* fortgeschriebene Induktionsvariablen sind ebenfalls Summen */
+		if (opts.scev)
+			scevTree(ast);
+
+		/* ändert alle Knoten-IDs, muss also vor allen Analysen laufen */
+		if (opts.dce)
+			dceTree(ast, tab);
+
+		/* Plätze, die vor der Zuweisung gelesen werden können */
+		if (definiteInit(&uninit, ast))
+		{
+			fputs("out-of-memory error\n", stderr);
+			exit(-1);
+		}
+
+		defs = &uninit;
+
+		if (opts.warnUninit)
+			definiteReport(defs, ast, tab, stderr);
+
+		if (opts.emitC)
+			rc = runEmitC(&opts);
+		else if (opts.emitAsm || opts.output != NULL)
+			rc = runNative(&opts);
+		else switch (opts.engine)
+		{
+		case MINAKO_ENGINE_Bytecode:
+			rc = runBytecode(&opts);
+			break;
+
+		case MINAKO_ENGINE_Closure:
+			runClosure();
+			break;
+
+		case MINAKO_ENGINE_Stackless:
+			quickenTree(ast);
+			stacklessRun(ast, opts.maxStack);
+			break;
+
+		case MINAKO_ENGINE_Tree:
+			/* der JIT-Übersetzer erwartet die ursprünglichen Knotenarten */
+			if (opts.jit)
+			{
+				if (jitCompile(&code, ast) == 0)
+					jit = &code;
+				else
+					fputs("warning: jit unavailable, interpreting\n", stderr);
+			}
+
+			if (opts.memoSize > 0)
+			{
+				if (memoInit(&results, ast, opts.memoSize))
+				{
+					fputs("out-of-memory error\n", stderr);
+					exit(-1);
+				}
+
+				memo = &results;
+			}
+
+			if (opts.tierThreshold > 0)
+			{
+				tierInit(&tiers, opts.tierThreshold);
+				tier = &tiers;
+			}
+
+			quickenTree(ast);
+
+			if (opts.fuse)
+				fuseTree(ast);
+
+			tailcallTree(ast);
+
+			if (opts.trace)
+				dispatchTable = traceTable;
+
+			dispatch(syntreeNodePtr(ast, 0));
+
+			if (jit != NULL)
+				jitRelease(&code);
+
+			if (memo != NULL)
+				memoRelease(memo);
+
+			if (tier != NULL)
+			{
+				if (opts.tierStats)
+					tierReport(tier, stderr);
+
+				tierRelease(tier);
+			}
+
+			break;
+		}
 	}
 
-	/* gib den Syntaxbaum wieder frei */
+	/* ein Überlauf im letzten Rahmen wurde noch nicht gemeldet */
+	if (quotaFuel <= 0)
+		quotaExhausted();
+
+	/* gib den Syntaxbaum und den Variablenstack wieder frei */
+	if (defs != NULL)
+		definiteRelease(&uninit);
+
 	syntreeRelease(&syntree);
+	vmstackRelease(vm);
 
 	return rc;
 }
@@ -0,0 +1,68 @@
+/***************************************************************************//**
+ * @file minako.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält die Laufzeitstrukturen, die sich alle Ausführungsstufen des
+ * Interpreters teilen.
+ * @details
+ * Der Variablenstack wird vom Bauminterpreter in minako.c und von den daraus
+ * abgeleiteten Ausführungsstufen gemeinsam verwendet. Globale Variablen liegen
+ * am Anfang des Stacks, lokale Variablen relativ zum Base pointer. Nur das
+ * Ausgaberegister trägt einen Typ; die Zeichenkettenkonstanten sind über die
+ * Knoten-IDs ihrer Literale im Syntaxbaum erreichbar.
+ ******************************************************************************/
+
+#ifndef MINAKO_H_INCLUDED
+#define MINAKO_H_INCLUDED
+
+/* *** includes ************************************************************* */
+
+#include "syntree.h"
+
+/**@brief Standardgröße des Variablenstacks in MiB.
+ * @note Der Stack wird nur als Adressraum reserviert und seitenweise bei
+ * Bedarf angelegt (siehe vmstack.h).
+ */
+#define MINAKO_STACK_DEFAULT 1024
+#define DUMMY -1 // leerer Platz
+
+/* *** structures *********************************************************** */
+
+/**@brief Nutzlast eines Variablenwertes und zugleich ein Platz auf dem
+ * Variablenstack.
+ * @note Die Typen aller Variablen und Ausdrücke stehen statisch im
+ * Syntaxbaum, die Plätze tragen deshalb keine Typinformation.
+ */
+typedef union minako_data_u
+{
+	int boolean;         /**<@brief Boolescher Wert. */
+	int integer;         /**<@brief Ganzzahliger Wert. */
+	float real;          /**<@brief Fließkommawert. */
+	syntree_nid string;  /**<@brief Zeichenkette als Knoten-ID ihres Literals. */
+} minako_data_t;
+
+/**@brief Ein typisierter Wert im Ausgaberegister des Interpreters.
+ */
+typedef struct minako_value_s
+{
+	/**@brief Typ des Variablenwertes.
+	 */
+	syntree_node_type type;
+
+	/**@brief Variablenwert.
+	 */
+	minako_data_t value;
+} minako_value_t;
+
+/**@brief Struktur des Laufzeitzustands des Interpreters.
+ */
+typedef struct minako_vm_s
+{
+	minako_data_t* stack; /**<@brief Variablenstack. */
+	minako_data_t* limit; /**<@brief Ende des Variablenstacks. */
+	minako_value_t eax; /**<@brief Ausgaberegister. */
+	minako_data_t* ebp; /**<@brief Base pointer. */
+	minako_data_t* esp; /**<@brief Stack pointer. */
+	int returnFlag; /**<@brief Signalisiert das Verlassen einer Funktion. */
+} minako_vm_t;
+
+#endif /* MINAKO_H_INCLUDED */
@@ -0,0 +1,591 @@
+/***************************************************************************//**
+ * @file native.c
+ * @author Dorian Weber und die Studenten
+ * @brief Implementation des x86-64 Assembler-Backends.
+ * @details
+ * Der Codegenerator arbeitet wie der JIT-Übersetzer mit einem Akkumulator:
+ * jeder Ausdruck hinterlässt sein Ergebnis in \c %eax (Ganzzahlen,
+ * Wahrheitswerte) bzw. \c %xmm0 (Fließkommazahlen). Variable \c i des
+ * aktuellen Rahmens liegt bei \c 16+8*i(%rbp), also oberhalb der
+ * Rücksprungadresse im Stackbereich des Aufrufers.
+ ******************************************************************************/
+
+#define _DEFAULT_SOURCE
+
+#include "native.h"
+#include "minako.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <assert.h>
+#include <sys/wait.h>
+
+/* ******************************************************* private structures */
+
+/**@brief Zustand des Codegenerators.
+ */
+typedef struct native_emitter_s
+{
+	const syntree_t* tree; /**<@brief Der übersetzte Syntaxbaum. */
+	FILE* out;             /**<@brief Ausgabestrom. */
+	unsigned int labels;   /**<@brief Anzahl vergebener Sprungmarken. */
+	unsigned int depth;    /**<@brief Anzahl gesicherter Werte (je 8 Byte). */
+	syntree_nid func;      /**<@brief Aktuell übersetzte Funktion. */
+} native_emitter_t;
+
+/* ******************************************************** private functions */
+
+/**@brief Gibt den Zeiger auf einen Knoten der entsprechenden ID zurück.
+ */
+static inline const syntree_node_t*
+nodePtr(const native_emitter_t* e, syntree_nid id)
+{
+	return syntreeNodePtr(e->tree, id);
+}
+
+/**@brief Gibt die ID des Folgeknotens eines Knotens zurück.
+ */
+static inline syntree_nid
+nodeNext(const native_emitter_t* e, syntree_nid id)
+{
+	return nodePtr(e, id)->next;
+}
+
+/**@brief Vergibt eine neue Sprungmarke.
+ */
+static inline unsigned int
+label(native_emitter_t* e)
+{
+	return e->labels++;
+}
+
+/**@brief Gibt eine Instruktion aus.
+ */
+static void
+emit(native_emitter_t* e, const char* fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	putc('\t', e->out);
+	vfprintf(e->out, fmt, args);
+	putc('\n', e->out);
+	va_end(args);
+}
+
+/**@brief Gibt den Operanden einer Variablen aus.
+ */
+static void
+operand(const syntree_node_t* var, char* buf)
+{
+	if (var->tag == SYNTREE_TAG_GlobVar)
+		sprintf(buf, "minako_globals+%i(%%rip)", 4 * var->value.variable);
+	else
+		sprintf(buf, "%i(%%rbp)", 16 + 8 * var->value.variable);
+}
+
+/**@brief Sichert den Akkumulator auf dem Maschinenstack.
+ */
+static void
+pushAcc(native_emitter_t* e, syntree_node_type type)
+{
+	if (type == SYNTREE_TYPE_Float)
+		emit(e, "movd %%xmm0, %%eax");
+
+	emit(e, "pushq %%rax");
+	++e->depth;
+}
+
+/**@brief Ruft eine Funktion der Laufzeitunterstützung auf.
+ * @note Der Maschinenstack wird dabei auf 16 Byte ausgerichtet.
+ */
+static void
+callRuntime(native_emitter_t* e, const char* name)
+{
+	if (e->depth % 2)
+		emit(e, "subq $8, %%rsp");
+
+	emit(e, "call %s", name);
+
+	if (e->depth % 2)
+		emit(e, "addq $8, %%rsp");
+}
+
+static void
+genExpr(native_emitter_t* e, syntree_nid id);
+
+static void
+genStmt(native_emitter_t* e, syntree_nid id);
+
+/**@brief Erzeugt Code für eine binäre arithmetische Operation oder einen
+ * Vergleich.
+ */
+static void
+genBinary(native_emitter_t* e, const syntree_node_t* node)
+{
+	const syntree_node_t* lhs = nodePtr(e, node->value.container.first);
+	const char* setcc;
+
+	/* linker Operand in %eax/%xmm0, rechter Operand in %ecx/%xmm1 */
+	genExpr(e, node->value.container.first);
+	pushAcc(e, lhs->type);
+	genExpr(e, node->value.container.last);
+	--e->depth;
+
+	if (lhs->type == SYNTREE_TYPE_Float)
+	{
+		emit(e, "movaps %%xmm0, %%xmm1");
+		emit(e, "popq %%rax");
+		emit(e, "movd %%eax, %%xmm0");
+
+		switch (node->tag)
+		{
+		case SYNTREE_TAG_Plus:   emit(e, "addss %%xmm1, %%xmm0"); return;
+		case SYNTREE_TAG_Minus:  emit(e, "subss %%xmm1, %%xmm0"); return;
+		case SYNTREE_TAG_Times:  emit(e, "mulss %%xmm1, %%xmm0"); return;
+		case SYNTREE_TAG_Divide: emit(e, "divss %%xmm1, %%xmm0"); return;
+
+		/* bei NaN sind alle Vergleiche außer != falsch */
+		case SYNTREE_TAG_Eqt:
+			emit(e, "ucomiss %%xmm1, %%xmm0");
+			emit(e, "sete %%al");
+			emit(e, "setnp %%cl");
+			emit(e, "andb %%cl, %%al");
+			break;
+		case SYNTREE_TAG_Neq:
+			emit(e, "ucomiss %%xmm1, %%xmm0");
+			emit(e, "setne %%al");
+			emit(e, "setp %%cl");
+			emit(e, "orb %%cl, %%al");
+			break;
+		case SYNTREE_TAG_Lst:
+			emit(e, "ucomiss %%xmm0, %%xmm1");
+			emit(e, "seta %%al");
+			break;
+		case SYNTREE_TAG_Leq:
+			emit(e, "ucomiss %%xmm0, %%xmm1");
+			emit(e, "setae %%al");
+			break;
+		case SYNTREE_TAG_Grt:
+			emit(e, "ucomiss %%xmm1, %%xmm0");
+			emit(e, "seta %%al");
+			break;
+		case SYNTREE_TAG_Geq:
+			emit(e, "ucomiss %%xmm1, %%xmm0");
+			emit(e, "setae %%al");
+			break;
+		default:
+			assert(!"unexpected binary operator");
+		}
+
+		emit(e, "movzbl %%al, %%eax");
+		return;
+	}
+
+	emit(e, "movl %%eax, %%ecx");
+	emit(e, "popq %%rax");
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Plus:  emit(e, "addl %%ecx, %%eax"); return;
+	case SYNTREE_TAG_Minus: emit(e, "subl %%ecx, %%eax"); return;
+	case SYNTREE_TAG_Times: emit(e, "imull %%ecx, %%eax"); return;
+	case SYNTREE_TAG_Divide:
+		emit(e, "cltd");
+		emit(e, "idivl %%ecx");
+		return;
+	case SYNTREE_TAG_Eqt: setcc = "sete"; break;
+	case SYNTREE_TAG_Neq: setcc = "setne"; break;
+	case SYNTREE_TAG_Lst: setcc = "setl"; break;
+	case SYNTREE_TAG_Leq: setcc = "setle"; break;
+	case SYNTREE_TAG_Grt: setcc = "setg"; break;
+	case SYNTREE_TAG_Geq: setcc = "setge"; break;
+	default:
+		assert(!"unexpected binary operator");
+		return;
+	}
+
+	emit(e, "cmpl %%ecx, %%eax");
+	emit(e, "%s %%al", setcc);
+	emit(e, "movzbl %%al, %%eax");
+}
+
+/**@brief Erzeugt Code für einen Funktionsaufruf.
+ * @param func  Knoten-ID der aufgerufenen Funktion
+ * @param args  erstes Argument oder 0
+ */
+static void
+genCall(native_emitter_t* e, syntree_nid func, syntree_nid args)
+{
+	unsigned int locals = nodePtr(e, func)->value.function.locals;
+	unsigned int pad = (e->depth + locals) % 2, i;
+
+	/* lege den Rahmen der aufgerufenen Funktion an */
+	if (locals + pad > 0)
+		emit(e, "subq $%u, %%rsp", 8 * (locals + pad));
+
+	e->depth += locals + pad;
+
+	for (i = 0; args != 0; args = nodeNext(e, args), ++i)
+	{
+		genExpr(e, args);
+
+		if (nodePtr(e, args)->type == SYNTREE_TYPE_Float)
+			emit(e, "movss %%xmm0, %u(%%rsp)", 8 * i);
+		else
+			emit(e, "movl %%eax, %u(%%rsp)", 8 * i);
+	}
+
+	/* die übrigen Variablen sind wie im Interpreter vorbelegt */
+	for (; i < locals; ++i)
+		emit(e, "movl $%i, %u(%%rsp)", DUMMY, 8 * i);
+
+	emit(e, "call .Lfunc%u", func);
+
+	if (locals + pad > 0)
+		emit(e, "addq $%u, %%rsp", 8 * (locals + pad));
+
+	e->depth -= locals + pad;
+}
+
+/**@brief Erzeugt Code für eine Zuweisung.
+ */
+static void
+genAssign(native_emitter_t* e, const syntree_node_t* node)
+{
+	const syntree_node_t* var = nodePtr(e, node->value.container.first);
+	char buf[64];
+
+	genExpr(e, node->value.container.last);
+	operand(var, buf);
+
+	if (var->type == SYNTREE_TYPE_Float)
+		emit(e, "movss %%xmm0, %s", buf);
+	else
+		emit(e, "movl %%eax, %s", buf);
+}
+
+/**@brief Erzeugt Code für einen Ausdruck.
+ */
+static void
+genExpr(native_emitter_t* e, syntree_nid id)
+{
+	const syntree_node_t* node = nodePtr(e, id);
+	unsigned int end;
+	char buf[64];
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_Float:
+		emit(e, "movl $%i, %%eax", node->value.integer);
+
+		if (node->type == SYNTREE_TYPE_Float)
+			emit(e, "movd %%eax, %%xmm0");
+
+		break;
+
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+		operand(node, buf);
+
+		if (node->type == SYNTREE_TYPE_Float)
+			emit(e, "movss %s, %%xmm0", buf);
+		else
+			emit(e, "movl %s, %%eax", buf);
+
+		break;
+
+	case SYNTREE_TAG_Call:
+		genCall(e, node->value.container.last,
+		        nodePtr(e, node->value.container.first)->value.container.first);
+		break;
+
+	case SYNTREE_TAG_Assign:
+		genAssign(e, node);
+		break;
+
+	case SYNTREE_TAG_Cast:
+		genExpr(e, node->value.container.first);
+		emit(e, "cvtsi2ssl %%eax, %%xmm0");
+		break;
+
+	case SYNTREE_TAG_Uminus:
+		genExpr(e, node->value.container.first);
+
+		if (node->type == SYNTREE_TYPE_Float)
+		{
+			emit(e, "movd %%xmm0, %%eax");
+			emit(e, "xorl $0x80000000, %%eax");
+			emit(e, "movd %%eax, %%xmm0");
+		}
+		else
+			emit(e, "negl %%eax");
+
+		break;
+
+	case SYNTREE_TAG_LogOr:
+	case SYNTREE_TAG_LogAnd:
+		end = label(e);
+		genExpr(e, node->value.container.first);
+		emit(e, "testl %%eax, %%eax");
+		emit(e, "%s .L%u", (node->tag == SYNTREE_TAG_LogOr) ? "jnz" : "jz", end);
+		genExpr(e, node->value.container.last);
+		fprintf(e->out, ".L%u:\n", end);
+		break;
+
+	default:
+		genBinary(e, node);
+	}
+}
+
+/**@brief Erzeugt Code für eine Bedingung und einen bedingten Sprung.
+ */
+static void
+genBranch(native_emitter_t* e, syntree_nid cond, const char* jcc,
+          unsigned int target)
+{
+	genExpr(e, cond);
+	emit(e, "testl %%eax, %%eax");
+	emit(e, "%s .L%u", jcc, target);
+}
+
+/**@brief Gibt eine Zeichenkette als Assemblerliteral aus.
+ */
+static void
+emitString(FILE* out, const char* str)
+{
+	fputs("\t.string \"", out);
+
+	for (; *str != '\0'; ++str)
+	{
+		if (*str == '"' || *str == '\\')
+			fprintf(out, "\\%c", *str);
+		else if (*str >= ' ' && *str <= '~')
+			putc(*str, out);
+		else
+			fprintf(out, "\\%03o", (unsigned char) *str);
+	}
+
+	fputs("\"\n", out);
+}
+
+/**@brief Erzeugt Code für eine Ausgabeanweisung.
+ */
+static void
+genPrint(native_emitter_t* e, const syntree_node_t* node)
+{
+	const syntree_node_t* arg = nodePtr(e, node->value.container.first);
+	unsigned int str;
+
+	if (arg->tag == SYNTREE_TAG_String)
+	{
+		str = label(e);
+		fputs("\t.section .rodata\n", e->out);
+		fprintf(e->out, ".L%u:\n", str);
+		emitString(e->out, arg->value.string);
+		fputs("\t.text\n", e->out);
+		emit(e, "leaq .L%u(%%rip), %%rdi", str);
+		callRuntime(e, "minakoPrintString");
+		return;
+	}
+
+	genExpr(e, node->value.container.first);
+
+	switch (arg->type)
+	{
+	case SYNTREE_TYPE_Boolean:
+		emit(e, "movl %%eax, %%edi");
+		callRuntime(e, "minakoPrintBool");
+		break;
+
+	case SYNTREE_TYPE_Integer:
+		emit(e, "movl %%eax, %%edi");
+		callRuntime(e, "minakoPrintInt");
+		break;
+
+	case SYNTREE_TYPE_Float:
+		callRuntime(e, "minakoPrintFloat");
+		break;
+
+	default:
+		callRuntime(e, "minakoPrintVoid");
+	}
+}
+
+/**@brief Erzeugt Code für eine Anweisung.
+ */
+static void
+genStmt(native_emitter_t* e, syntree_nid id)
+{
+	const syntree_node_t* node = nodePtr(e, id);
+	syntree_nid init, cond, step, body;
+	unsigned int loop, test, end;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Sequence:
+		for (id = node->value.container.first; id != 0; id = nodeNext(e, id))
+			genStmt(e, id);
+
+		break;
+
+	case SYNTREE_TAG_Function:
+		/* Aufruf der Hauptfunktion im Programmkörper */
+		genCall(e, id, 0);
+		break;
+
+	case SYNTREE_TAG_If:
+		cond = node->value.container.first;
+		body = nodeNext(e, cond);
+		test = label(e);
+
+		genBranch(e, cond, "jz", test);
+		genStmt(e, body);
+
+		if (nodeNext(e, body) != 0)
+		{
+			end = label(e);
+			emit(e, "jmp .L%u", end);
+			fprintf(e->out, ".L%u:\n", test);
+			genStmt(e, nodeNext(e, body));
+			test = end;
+		}
+
+		fprintf(e->out, ".L%u:\n", test);
+		break;
+
+	case SYNTREE_TAG_For:
+		init = node->value.container.first;
+		cond = nodeNext(e, init);
+		step = nodeNext(e, cond);
+		body = nodeNext(e, step);
+		loop = label(e);
+		test = label(e);
+
+		genStmt(e, init);
+		emit(e, "jmp .L%u", test);
+		fprintf(e->out, ".L%u:\n", loop);
+		genStmt(e, body);
+		genStmt(e, step);
+		fprintf(e->out, ".L%u:\n", test);
+		genBranch(e, cond, "jnz", loop);
+		break;
+
+	case SYNTREE_TAG_While:
+		loop = label(e);
+		test = label(e);
+
+		emit(e, "jmp .L%u", test);
+		fprintf(e->out, ".L%u:\n", loop);
+		genStmt(e, node->value.container.last);
+		fprintf(e->out, ".L%u:\n", test);
+		genBranch(e, node->value.container.first, "jnz", loop);
+		break;
+
+	case SYNTREE_TAG_DoWhile:
+		loop = label(e);
+
+		fprintf(e->out, ".L%u:\n", loop);
+		genStmt(e, node->value.container.last);
+		genBranch(e, node->value.container.first, "jnz", loop);
+		break;
+
+	case SYNTREE_TAG_Print:
+		genPrint(e, node);
+		break;
+
+	case SYNTREE_TAG_Return:
+		if (node->value.container.first != 0)
+			genExpr(e, node->value.container.first);
+
+		emit(e, "jmp .Lret%u", e->func);
+		break;
+
+	default:
+		/* Ausdrucksanweisungen (Zuweisungen und Aufrufe) */
+		genExpr(e, id);
+	}
+}
+
+/**@brief Übersetzt eine Funktion.
+ */
+static void
+genFunction(native_emitter_t* e, syntree_nid id)
+{
+	e->func = id;
+	e->depth = 0;
+
+	fprintf(e->out, "\n.Lfunc%u:\n", id);
+	emit(e, "pushq %%rbp");
+	emit(e, "movq %%rsp, %%rbp");
+	genStmt(e, nodePtr(e, id)->value.function.body);
+	fprintf(e->out, ".Lret%u:\n", id);
+	emit(e, "popq %%rbp");
+	emit(e, "ret");
+}
+
+/* ********************************************************* public functions */
+
+void
+nativeEmit(const syntree_t* self, FILE* out)
+{
+	const syntree_node_t* prog = syntreeNodePtr(self, 0);
+	native_emitter_t e;
+	syntree_nid id;
+
+	e.tree = self;
+	e.out = out;
+	e.labels = 0;
+	e.depth = 0;
+	e.func = 0;
+
+	/* globale Variablen sind wie im Interpreter mit DUMMY vorbelegt */
+	fputs("\t.data\n\t.p2align 2\nminako_globals:\n", out);
+	fprintf(out, "\t.fill %u, 4, %i\n", prog->value.program.globals, DUMMY);
+
+	fputs("\n\t.text\n", out);
+
+	for (id = 1; id < self->len; ++id)
+		if (self->nodes[id].tag == SYNTREE_TAG_Function)
+			genFunction(&e, id);
+
+	/* Einstiegspunkt: globale Initialisierungen und Aufruf von main() */
+	e.func = 0;
+	e.depth = 0;
+	fputs("\n\t.globl main\nmain:\n", out);
+	emit(&e, "pushq %%rbp");
+	emit(&e, "movq %%rsp, %%rbp");
+	genStmt(&e, prog->value.program.body);
+	emit(&e, "xorl %%eax, %%eax");
+	emit(&e, "popq %%rbp");
+	emit(&e, "ret");
+
+	fputs("\n\t.section .note.GNU-stack,\"\",@progbits\n", out);
+}
+
+int
+nativeLink(const char* source, const char* target)
+{
+	static const char fmt[] = NATIVE_CC " -o '%s' '%s' '" MINAKO_RUNTIME "'";
+	char* cmd = malloc(sizeof(fmt) + strlen(source) + strlen(target));
+	int rc;
+
+	if (cmd == NULL)
+	{
+		fputs("out-of-memory error\n", stderr);
+		exit(-1);
+	}
+
+	sprintf(cmd, fmt, target, source);
+	rc = system(cmd);
+	free(cmd);
+
+	/* system() liefert einen Wartestatus, dessen untere Bits 0 sein können */
+	if (rc == -1 || !WIFEXITED(rc))
+		return 1;
+
+	return WEXITSTATUS(rc);
+}
@@ -0,0 +1,63 @@
+/***************************************************************************//**
+ * @file native.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält ein Backend, das C1-Programme vorab in x86-64 Assembler
+ * (GNU-Syntax) übersetzt und zu eigenständigen Programmen bindet.
+ * @details
+ * Hier ist ein Beispiel für die Übersetzung eines Programms:
+ * @code
+ * FILE* out = fopen("prog.s", "w");
+ *
+ * nativeEmit(ast, out);
+ * fclose(out);
+ * nativeLink("prog.s", "prog");
+ * @endcode
+ *
+ * Globale Variablen liegen in einem gemeinsamen Datenblock mit
+ * \c program.globals Einträgen. Wie im Interpreter legt der Aufrufer den
+ * Rahmen der aufgerufenen Funktion mit \c function.locals Einträgen an, belegt
+ * die Parameter und initialisiert die übrigen Variablen mit \c DUMMY.
+ * Ausgaben werden an die Laufzeitunterstützung in minako-rt.c delegiert, die
+ * beim Binden hinzugefügt wird.
+ ******************************************************************************/
+
+#ifndef NATIVE_H_INCLUDED
+#define NATIVE_H_INCLUDED
+
+/* *** includes ************************************************************* */
+
+#include <stdio.h>
+#include "syntree.h"
+
+/**@brief Objektdatei der Laufzeitunterstützung.
+ */
+#ifndef MINAKO_RUNTIME
+	#define MINAKO_RUNTIME "minako-rt.o"
+#endif
+
+/**@brief Aufruf des Systemcompilers zum Assemblieren und Binden.
+ */
+#ifndef NATIVE_CC
+	#define NATIVE_CC "cc"
+#endif
+
+/* *** interface ************************************************************ */
+
+/**@brief Übersetzt einen Syntaxbaum in x86-64 Assembler.
+ * @param self  der Syntaxbaum (mit den ursprünglichen Knotenarten)
+ * @param out   Ausgabestrom für den Assemblercode
+ */
+extern void
+nativeEmit(const syntree_t* self, FILE* out);
+
+/**@brief Assembliert eine Assemblerdatei und bindet sie mit der
+ * Laufzeitunterstützung zu einem ausführbaren Programm.
+ * @param source  Pfad der Assemblerdatei
+ * @param target  Pfad des zu erzeugenden Programms
+ * @return 0, falls das Binden erfolgreich war\n
+ *      != 0 ansonsten
+ */
+extern int
+nativeLink(const char* source, const char* target);
+
+#endif /* NATIVE_H_INCLUDED */
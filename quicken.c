@@ -0,0 +1,159 @@
+/***************************************************************************//**
+ * @file quicken.c
+ * @author Dorian Weber und die Studenten
+ * @brief Implementation des Quickening-Durchlaufs.
+ ******************************************************************************/
+
+#include "quicken.h"
+#include <stdio.h>
+#include <assert.h>
+
+/* ******************************************************** private functions */
+
+/**@brief Ermittelt die typspezialisierte Knotenart eines Operators.
+ * @param tag   Knotenart des Operators
+ * @param type  Typ der Operanden
+ * @return die spezialisierte Knotenart oder \p tag, falls es keine gibt
+ */
+static syntree_node_tag
+quickenTag(syntree_node_tag tag, syntree_node_type type)
+{
+	/* Wahrheitswerte werden wie Ganzzahlen verglichen */
+	int isFloat = (type == SYNTREE_TYPE_Float);
+
+	switch (tag)
+	{
+	case SYNTREE_TAG_Plus:
+		return isFloat ? SYNTREE_TAG_PlusFloat : SYNTREE_TAG_PlusInt;
+	case SYNTREE_TAG_Minus:
+		return isFloat ? SYNTREE_TAG_MinusFloat : SYNTREE_TAG_MinusInt;
+	case SYNTREE_TAG_Times:
+		return isFloat ? SYNTREE_TAG_TimesFloat : SYNTREE_TAG_TimesInt;
+	case SYNTREE_TAG_Divide:
+		return isFloat ? SYNTREE_TAG_DivideFloat : SYNTREE_TAG_DivideInt;
+	case SYNTREE_TAG_Uminus:
+		return isFloat ? SYNTREE_TAG_UminusFloat : SYNTREE_TAG_UminusInt;
+	case SYNTREE_TAG_Eqt:
+		return isFloat ? SYNTREE_TAG_EqtFloat : SYNTREE_TAG_EqtInt;
+	case SYNTREE_TAG_Neq:
+		return isFloat ? SYNTREE_TAG_NeqFloat : SYNTREE_TAG_NeqInt;
+	case SYNTREE_TAG_Leq:
+		return isFloat ? SYNTREE_TAG_LeqFloat : SYNTREE_TAG_LeqInt;
+	case SYNTREE_TAG_Geq:
+		return isFloat ? SYNTREE_TAG_GeqFloat : SYNTREE_TAG_GeqInt;
+	case SYNTREE_TAG_Lst:
+		return isFloat ? SYNTREE_TAG_LstFloat : SYNTREE_TAG_LstInt;
+	case SYNTREE_TAG_Grt:
+		return isFloat ? SYNTREE_TAG_GrtFloat : SYNTREE_TAG_GrtInt;
+	case SYNTREE_TAG_AssignLocPlusK:
+		return SYNTREE_TAG_Assign;
+	default:
+		return tag;
+	}
+}
+
+/* ********************************************************* public functions */
+
+unsigned int
+quickenTree(syntree_t* self)
+{
+	syntree_node_t *node, *child;
+	syntree_node_tag tag;
+	unsigned int count = 0, id;
+
+	/* die Reihenfolge spielt keine Rolle, da sich die Typen nicht ändern */
+	for (id = 1; id < self->len; ++id)
+	{
+		node = syntreeNodePtr(self, id);
+
+		switch (node->tag)
+		{
+		case SYNTREE_TAG_Cast:
+			assert(node->type == SYNTREE_TYPE_Float);
+			child = syntreeNodePtr(self, node->value.container.first);
+
+			if (child->tag == SYNTREE_TAG_Integer)
+			{
+				/* konvertiere Konstanten direkt */
+				node->tag = SYNTREE_TAG_Float;
+				node->value.real = child->value.integer;
+			}
+			else
+				node->tag = SYNTREE_TAG_CastInt;
+
+			++count;
+			break;
+
+		case SYNTREE_TAG_Eqt:
+		case SYNTREE_TAG_Neq:
+		case SYNTREE_TAG_Leq:
+		case SYNTREE_TAG_Geq:
+		case SYNTREE_TAG_Lst:
+		case SYNTREE_TAG_Grt:
+			/* Vergleiche sind nach dem Typ der Operanden spezialisiert */
+			child = syntreeNodePtr(self, node->value.container.first);
+			node->tag = quickenTag(node->tag, child->type);
+			++count;
+			break;
+
+		default:
+			tag = quickenTag(node->tag, node->type);
+
+			if (tag != node->tag)
+			{
+				node->tag = tag;
+				++count;
+			}
+		}
+	}
+
+	return count;
+}
+
+syntree_node_tag
+quickenGeneric(syntree_node_tag tag)
+{
+	switch (tag)
+	{
+	case SYNTREE_TAG_CastInt:
+		return SYNTREE_TAG_Cast;
+	case SYNTREE_TAG_PlusInt:   case SYNTREE_TAG_PlusFloat:
+	case SYNTREE_TAG_PlusIntLocK: case SYNTREE_TAG_PlusFloatLocK:
+		return SYNTREE_TAG_Plus;
+	case SYNTREE_TAG_MinusInt:  case SYNTREE_TAG_MinusFloat:
+	case SYNTREE_TAG_MinusIntLocK: case SYNTREE_TAG_MinusFloatLocK:
+		return SYNTREE_TAG_Minus;
+	case SYNTREE_TAG_TimesInt:  case SYNTREE_TAG_TimesFloat:
+	case SYNTREE_TAG_TimesIntLocK: case SYNTREE_TAG_TimesFloatLocK:
+		return SYNTREE_TAG_Times;
+	case SYNTREE_TAG_DivideInt: case SYNTREE_TAG_DivideFloat:
+	case SYNTREE_TAG_DivideIntLocK: case SYNTREE_TAG_DivideFloatLocK:
+		return SYNTREE_TAG_Divide;
+	case SYNTREE_TAG_UminusInt: case SYNTREE_TAG_UminusFloat:
+		return SYNTREE_TAG_Uminus;
+	case SYNTREE_TAG_EqtInt:    case SYNTREE_TAG_EqtFloat:
+	case SYNTREE_TAG_EqtIntLocK: case SYNTREE_TAG_EqtIntLocLoc:
+		return SYNTREE_TAG_Eqt;
+	case SYNTREE_TAG_NeqInt:    case SYNTREE_TAG_NeqFloat:
+	case SYNTREE_TAG_NeqIntLocK: case SYNTREE_TAG_NeqIntLocLoc:
+		return SYNTREE_TAG_Neq;
+	case SYNTREE_TAG_LeqInt:    case SYNTREE_TAG_LeqFloat:
+	case SYNTREE_TAG_LeqIntLocK: case SYNTREE_TAG_LeqIntLocLoc:
+		return SYNTREE_TAG_Leq;
+	case SYNTREE_TAG_GeqInt:    case SYNTREE_TAG_GeqFloat:
+	case SYNTREE_TAG_GeqIntLocK: case SYNTREE_TAG_GeqIntLocLoc:
+		return SYNTREE_TAG_Geq;
+	case SYNTREE_TAG_LstInt:    case SYNTREE_TAG_LstFloat:
+	case SYNTREE_TAG_LstIntLocK: case SYNTREE_TAG_LstIntLocLoc:
+		return SYNTREE_TAG_Lst;
+	case SYNTREE_TAG_GrtInt:    case SYNTREE_TAG_GrtFloat:
+	case SYNTREE_TAG_GrtIntLocK: case SYNTREE_TAG_GrtIntLocLoc:
+		return SYNTREE_TAG_Grt;
+	case SYNTREE_TAG_AssignLocPlusK:
+		return SYNTREE_TAG_Assign;
+	case SYNTREE_TAG_TailCall:
+		return SYNTREE_TAG_Call;
+	default:
+		return tag;
+	}
+}
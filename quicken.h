@@ -0,0 +1,48 @@
+/***************************************************************************//**
+ * @file quicken.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält einen Durchlauf, der Operatorknoten des Syntaxbaumes durch
+ * typspezialisierte Knotenarten ersetzt (Quickening).
+ * @details
+ * C1 ist statisch getypt und der Parser vermerkt den Typ an jedem
+ * Operatorknoten. Nach dem Parsen ersetzt quickenTree() deshalb z.B. einen
+ * Plus-Knoten vom Typ Integer durch einen PlusInt-Knoten und einen Lst-Knoten
+ * mit Fließkommaoperanden durch einen LstFloat-Knoten. Die zugehörigen
+ * Interpreterfunktionen kommen ohne Fallunterscheidung nach dem Typ aus.
+ * Typkonvertierungen von Integerkonstanten werden dabei direkt in
+ * Fließkommakonstanten umgewandelt.
+ *
+ * Die spezialisierten Knotenarten werden nur vom Bauminterpreter verstanden;
+ * der Durchlauf muss deshalb nach allen anderen Durchläufen und nur für diese
+ * Ausführungsstufe erfolgen.
+ ******************************************************************************/
+
+#ifndef QUICKEN_H_INCLUDED
+#define QUICKEN_H_INCLUDED
+
+/* *** includes ************************************************************* */
+
+#include "syntree.h"
+
+/* *** interface ************************************************************ */
+
+/**@brief Ersetzt alle Operatorknoten durch typspezialisierte Knotenarten.
+ * @param self  der Syntaxbaum
+ * @return Anzahl der ersetzten Knoten
+ */
+extern unsigned int
+quickenTree(syntree_t* self);
+
+/**@brief Ermittelt die ursprüngliche Knotenart einer spezialisierten oder
+ * fusionierten (siehe fuse.h) Knotenart.
+ * @note Erlaubt anderen Ausführungsstufen, auch nach dem Quickening aus dem
+ * Syntaxbaum zu übersetzen; der Typ der Operanden steht weiterhin an deren
+ * Knoten.
+ * @param tag  eine (möglicherweise spezialisierte) Knotenart
+ * @return die ursprüngliche Knotenart oder \p tag, falls sie nicht
+ *         spezialisiert ist
+ */
+extern syntree_node_tag
+quickenGeneric(syntree_node_tag tag);
+
+#endif /* QUICKEN_H_INCLUDED */
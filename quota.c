@@ -0,0 +1,125 @@
+/***************************************************************************//**
+ * @file quota.c
+ * @author Dorian Weber und die Studenten
+ * @brief Implementation der Begrenzung von Rechenzeit und Laufzeit.
+ ******************************************************************************/
+
+#define _DEFAULT_SOURCE
+
+#include "quota.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <signal.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+	#include <unistd.h>
+	#define QUOTA_ALARM 1
+#else
+	#define QUOTA_ALARM 0
+#endif
+
+/* ****************************************************************** globals */
+
+volatile long quotaFuel = LONG_MAX;
+
+/**@brief Gesetzt, sobald der Variablenstack überschritten ist.
+ */
+static volatile sig_atomic_t overflowed;
+
+#if QUOTA_ALARM
+
+/**@brief Gesetzt, sobald die Zeitgrenze erreicht ist.
+ */
+static volatile sig_atomic_t expired;
+
+/* ******************************************************** private functions */
+
+/**@brief Bricht die Ausführung bei Erreichen der Zeitgrenze ab.
+ * @note Beim ersten Signal wird nur der Treibstoff entzogen, damit der
+ * Interpreter an einer sicheren Stelle abbricht. Das zweite Signal beendet
+ * Code, der keinen Treibstoff verbraucht.
+ */
+static void
+timeout(int sig)
+{
+	static const char msg[] = "time limit exceeded\n";
+	ssize_t rc;
+
+	(void) sig;
+
+	if (!expired)
+	{
+		expired = 1;
+		quotaFuel = 0;
+		alarm(1);
+		return;
+	}
+
+	rc = write(STDERR_FILENO, msg, sizeof(msg) - 1);
+	(void) rc;
+	_exit(QUOTA_EXIT_TIME);
+}
+
+#endif /* QUOTA_ALARM */
+
+/* ********************************************************* public functions */
+
+int
+quotaInit(unsigned long fuel, unsigned long seconds)
+{
+#if QUOTA_ALARM
+	struct sigaction action;
+#endif
+
+	quotaFuel = (fuel == 0 || fuel > LONG_MAX) ? LONG_MAX : (long) fuel;
+
+	if (seconds == 0)
+		return 0;
+
+#if QUOTA_ALARM
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = timeout;
+	sigemptyset(&action.sa_mask);
+
+	if (sigaction(SIGALRM, &action, NULL) != 0)
+		return 1;
+
+	alarm(seconds);
+	return 0;
+#else
+	/* ohne Signale gibt es keine Zeitgrenze */
+	return 1;
+#endif
+}
+
+void
+quotaOverflow(void)
+{
+	overflowed = 1;
+	quotaFuel = 0;
+}
+
+void
+quotaExhausted(void)
+{
+	fflush(stdout);
+
+	if (overflowed)
+	{
+		fputs("stack overflow\n", stderr);
+		exit(QUOTA_EXIT_STACK);
+	}
+
+#if QUOTA_ALARM
+	if (expired)
+	{
+		fputs("time limit exceeded\n", stderr);
+		exit(QUOTA_EXIT_TIME);
+	}
+#endif
+
+	fputs("fuel exhausted\n", stderr);
+	exit(QUOTA_EXIT_FUEL);
+}
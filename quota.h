@@ -0,0 +1,87 @@
+/***************************************************************************//**
+ * @file quota.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält die Begrenzung von Rechenzeit und Laufzeit eines Programms.
+ * @details
+ * Hier ist ein Beispiel für die Benutzung:
+ * @code
+ * quotaInit(1000000, 10);
+ *
+ * while (running)
+ * {
+ *     QUOTA_BURN();
+ *     ...
+ * }
+ * @endcode
+ *
+ * Die Interpreter und der vom JIT-Übersetzer erzeugte Code verbrauchen bei
+ * jedem Funktionseintritt und jedem Rücksprung einer Schleife eine Einheit
+ * Treibstoff. Ist der Treibstoff
+ * aufgebraucht, wird die Standardausgabe geleert und das Programm mit
+ * \c QUOTA_EXIT_FUEL beendet.
+ *
+ * Die Zeitgrenze wird über \c SIGALRM umgesetzt: der Signalhandler setzt den
+ * Treibstoff auf 0, sodass der Interpreter beim nächsten Verbrauch sauber mit
+ * \c QUOTA_EXIT_TIME abbricht. Läuft nach einer weiteren Sekunde noch immer
+ * Code, der keinen Treibstoff verbraucht (etwa eine Ausgabe, die blockiert),
+ * beendet der Handler das Programm selbst.
+ *
+ * Überschreitet das Programm die Größe des Variablenstacks (siehe vmstack.h),
+ * endet es ebenso beim nächsten Verbrauch mit \c QUOTA_EXIT_STACK.
+ ******************************************************************************/
+
+#ifndef QUOTA_H_INCLUDED
+#define QUOTA_H_INCLUDED
+
+/**@brief Exitcode bei aufgebrauchtem Treibstoff.
+ */
+#define QUOTA_EXIT_FUEL 3
+
+/**@brief Exitcode bei überschrittener Zeitgrenze.
+ */
+#define QUOTA_EXIT_TIME 4
+
+/**@brief Exitcode bei überschrittener Stackgröße.
+ */
+#define QUOTA_EXIT_STACK 5
+
+/**@brief Verbraucht eine Einheit Treibstoff und bricht ab, sobald keiner mehr
+ * übrig ist.
+ */
+#define QUOTA_BURN() \
+	do { \
+		if (--quotaFuel <= 0) \
+			quotaExhausted(); \
+	} while (0)
+
+/* *** globals ************************************************************** */
+
+/**@brief Verbleibender Treibstoff.
+ * @note Wird vom Signalhandler der Zeitgrenze verändert.
+ */
+extern volatile long quotaFuel;
+
+/* *** interface ************************************************************ */
+
+/**@brief Setzt die Grenzen für die Ausführung.
+ * @param fuel     Treibstoff oder 0 für unbegrenzt
+ * @param seconds  Zeitgrenze in Sekunden oder 0 für unbegrenzt
+ * @return 0, falls keine Fehler aufgetreten sind\n
+ *      != 0 ansonsten
+ */
+extern int
+quotaInit(unsigned long fuel, unsigned long seconds);
+
+/**@brief Vermerkt einen Überlauf des Variablenstacks und entzieht den
+ * Treibstoff.
+ * @note Darf aus einem Signalhandler aufgerufen werden.
+ */
+extern void
+quotaOverflow(void);
+
+/**@brief Meldet eine erschöpfte Grenze und beendet das Programm.
+ */
+extern void
+quotaExhausted(void);
+
+#endif /* QUOTA_H_INCLUDED */
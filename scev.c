@@ -0,0 +1,1003 @@
+/***************************************************************************//**
+ * @file scev.c
+ * @author Dorian Weber und die Studenten
+ * @brief Implementation der geschlossenen Auswertung von Summationsschleifen.
+ ******************************************************************************/
+
+#include "scev.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+
+/* ******************************************************* private structures */
+
+/**@brief Höchster Grad eines Polynoms in der Anzahl der Durchläufe. */
+#define SCEV_DEGREE 3
+
+/**@brief Ergebnis der Auswertung eines Ausdrucks als Polynom.
+ */
+typedef enum scev_result_e
+{
+	SCEV_FAIL,  /**<@brief Der Ausdruck ist kein Polynom. */
+	SCEV_WAIT,  /**<@brief Eine benötigte Variable ist noch nicht gelöst. */
+	SCEV_OK     /**<@brief Das Polynom wurde bestimmt. */
+} scev_result;
+
+/**@brief Polynom in der Basis der Binomialkoeffizienten <tt>C(k, d)</tt>.
+ * @details Die Koeffizienten sind Ausdrücke, die nie selbst in den Baum
+ * eingehängt, sondern bei jeder Verwendung kopiert werden; 0 steht für einen
+ * verschwindenden Koeffizienten.
+ */
+typedef struct scev_poly_s
+{
+	syntree_nid coef[SCEV_DEGREE + 1];  /**<@brief Koeffizient je Grad. */
+} scev_poly_t;
+
+/**@brief Eine in der Schleife fortgeschriebene Variable <tt>v = v + e</tt>.
+ */
+typedef struct scev_rec_s
+{
+	unsigned int slot;  /**<@brief Platz der Variable. */
+	syntree_nid rhs;    /**<@brief Rechte Seite der Zuweisung. */
+	int solved;         /**<@brief Das Polynom ist bestimmt. */
+	scev_poly_t poly;   /**<@brief Wert zu Beginn des k-ten Durchlaufs. */
+} scev_rec_t;
+
+/**@brief Zustand während der Bearbeitung einer Funktion.
+ */
+typedef struct scev_ctx_s
+{
+	syntree_t* tree;   /**<@brief Der Syntaxbaum. */
+	syntree_nid func;  /**<@brief Knoten-ID der Funktion. */
+	scev_rec_t* recs;  /**<@brief Zuweisungen eines Durchlaufs in Reihenfolge. */
+	unsigned int len;  /**<@brief Anzahl der Einträge in recs. */
+	unsigned int cap;  /**<@brief Kapazität von recs. */
+	unsigned int pos;  /**<@brief Index der gerade ausgewerteten Zuweisung. */
+	unsigned int count;/**<@brief Anzahl der ersetzten Schleifen. */
+} scev_ctx_t;
+
+/* ******************************************************** private functions */
+
+/**@brief Gibt einen Zeiger auf einen Knoten zurück.
+ * @note Der Zeiger ist nach dem Anlegen neuer Knoten ungültig.
+ */
+static inline syntree_node_t*
+ptr(const scev_ctx_t* ctx, syntree_nid id)
+{
+	return syntreeNodePtr(ctx->tree, id);
+}
+
+/**@brief Prüft, ob ein Knoten ein Blatt ist.
+ */
+static inline int
+leaf(const syntree_node_t* node)
+{
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+		return 1;
+
+	default:
+		return 0;
+	}
+}
+
+/**@brief Legt eine Kopie eines einzelnen Knotens ohne Nachfolger an.
+ */
+static syntree_nid
+clone(scev_ctx_t* ctx, syntree_nid id)
+{
+	syntree_nid res = syntreeNodeVariable(ctx->tree, NULL);
+
+	*ptr(ctx, res) = *ptr(ctx, id);
+	ptr(ctx, res)->next = 0;
+	return res;
+}
+
+/**@brief Kopiert einen Ausdruck ohne Zeichenketten.
+ */
+static syntree_nid
+copy(scev_ctx_t* ctx, syntree_nid id)
+{
+	syntree_nid res = clone(ctx, id), child, last = 0;
+
+	if (leaf(ptr(ctx, id)))
+		return res;
+
+	for (child = ptr(ctx, id)->value.container.first; child != 0;
+	     child = ptr(ctx, child)->next)
+	{
+		syntree_nid dup = copy(ctx, child);
+
+		if (last == 0)
+			ptr(ctx, res)->value.container.first = dup;
+		else
+			ptr(ctx, last)->next = dup;
+
+		last = dup;
+	}
+
+	ptr(ctx, res)->value.container.last = last;
+	return res;
+}
+
+/**@brief Legt einen Knoten an, der einen ganzzahligen lokalen Platz liest.
+ */
+static syntree_nid
+variable(scev_ctx_t* ctx, unsigned int slot)
+{
+	syntree_nid id = syntreeNodeVariable(ctx->tree, NULL);
+	syntree_node_t* node = ptr(ctx, id);
+
+	node->tag = SYNTREE_TAG_LocVar;
+	node->type = SYNTREE_TYPE_Integer;
+	node->value.variable = slot;
+	return id;
+}
+
+/**@brief Legt einen binären Operator mit dem gegebenen Typ an.
+ */
+static syntree_nid
+binary(scev_ctx_t* ctx, syntree_node_tag tag, syntree_node_type type,
+       syntree_nid lhs, syntree_nid rhs)
+{
+	syntree_nid id = syntreeNodePair(ctx->tree, tag, lhs, rhs);
+
+	ptr(ctx, id)->type = type;
+	return id;
+}
+
+/**@brief Legt einen ganzzahligen binären Operator an.
+ */
+static inline syntree_nid
+arith(scev_ctx_t* ctx, syntree_node_tag tag, syntree_nid lhs, syntree_nid rhs)
+{
+	return binary(ctx, tag, SYNTREE_TYPE_Integer, lhs, rhs);
+}
+
+/**@brief Legt einen Vergleich an.
+ */
+static inline syntree_nid
+compare(scev_ctx_t* ctx, syntree_node_tag tag, syntree_nid lhs, syntree_nid rhs)
+{
+	return binary(ctx, tag, SYNTREE_TYPE_Boolean, lhs, rhs);
+}
+
+/**@brief Legt eine Zuweisung an einen lokalen Platz an.
+ */
+static syntree_nid
+assign(scev_ctx_t* ctx, unsigned int slot, syntree_nid expr)
+{
+	return syntreeNodePair(ctx->tree, SYNTREE_TAG_Assign, variable(ctx, slot), expr);
+}
+
+/**@brief Legt eine Verzweigung an.
+ * @param otherwise  Knoten-ID des Sonst-Zweiges oder 0
+ */
+static syntree_nid
+branch(scev_ctx_t* ctx, syntree_nid cond, syntree_nid then, syntree_nid otherwise)
+{
+	syntree_nid id = syntreeNodePair(ctx->tree, SYNTREE_TAG_If, cond, then);
+
+	if (otherwise != 0)
+		syntreeNodeAppend(ctx->tree, id, otherwise);
+
+	return id;
+}
+
+/**@brief Prüft, ob ein Knoten eine ganzzahlige Konstante ist.
+ */
+static int
+literal(const scev_ctx_t* ctx, syntree_nid id, int* value)
+{
+	if (id == 0 || ptr(ctx, id)->tag != SYNTREE_TAG_Integer)
+		return 0;
+
+	*value = ptr(ctx, id)->value.integer;
+	return 1;
+}
+
+/**@brief Legt einen konstanten Koeffizienten an.
+ */
+static syntree_nid
+constant(scev_ctx_t* ctx, int value)
+{
+	return (value != 0) ? syntreeNodeInteger(ctx->tree, value) : 0;
+}
+
+/**@brief Addiert zwei Koeffizienten.
+ */
+static syntree_nid
+cadd(scev_ctx_t* ctx, syntree_nid x, syntree_nid y)
+{
+	int a, b;
+
+	if (x == 0)
+		return y;
+
+	if (y == 0)
+		return x;
+
+	if (literal(ctx, x, &a) && literal(ctx, y, &b))
+		return constant(ctx, (int) ((unsigned int) a + (unsigned int) b));
+
+	return arith(ctx, SYNTREE_TAG_Plus, copy(ctx, x), copy(ctx, y));
+}
+
+/**@brief Multipliziert zwei Koeffizienten.
+ */
+static syntree_nid
+cmul(scev_ctx_t* ctx, syntree_nid x, syntree_nid y)
+{
+	int a, b;
+
+	if (x == 0 || y == 0)
+		return 0;
+
+	if (literal(ctx, x, &a) && literal(ctx, y, &b))
+		return constant(ctx, (int) ((unsigned int) a * (unsigned int) b));
+
+	if (literal(ctx, x, &a) && a == 1)
+		return y;
+
+	if (literal(ctx, y, &b) && b == 1)
+		return x;
+
+	return arith(ctx, SYNTREE_TAG_Times, copy(ctx, x), copy(ctx, y));
+}
+
+/**@brief Setzt ein Polynom auf 0.
+ */
+static void
+pzero(scev_poly_t* res)
+{
+	unsigned int d;
+
+	for (d = 0; d <= SCEV_DEGREE; ++d)
+		res->coef[d] = 0;
+}
+
+/**@brief Bestimmt den Grad eines Polynoms.
+ */
+static unsigned int
+pdegree(const scev_poly_t* p)
+{
+	unsigned int d;
+
+	for (d = SCEV_DEGREE; d > 0 && p->coef[d] == 0; --d)
+		;
+
+	return d;
+}
+
+/**@brief Addiert zwei Polynome.
+ */
+static void
+padd(scev_ctx_t* ctx, scev_poly_t* res, const scev_poly_t* p, const scev_poly_t* q)
+{
+	unsigned int d;
+
+	for (d = 0; d <= SCEV_DEGREE; ++d)
+		res->coef[d] = cadd(ctx, p->coef[d], q->coef[d]);
+}
+
+/**@brief Multipliziert ein Polynom mit einer Konstanten.
+ */
+static void
+pscale(scev_ctx_t* ctx, scev_poly_t* res, const scev_poly_t* p, int k)
+{
+	syntree_nid factor = constant(ctx, k);
+	unsigned int d;
+
+	for (d = 0; d <= SCEV_DEGREE; ++d)
+		res->coef[d] = cmul(ctx, factor, p->coef[d]);
+}
+
+/**@brief Multipliziert zwei Polynome.
+ * @details Es gilt <tt>C(k, a) * C(k, b) = sum M * C(k, a + b - i)</tt> über
+ * <tt>i <= min(a, b)</tt> mit dem Multinomialkoeffizienten
+ * <tt>M = (a + b - i)! / (i! (a - i)! (b - i)!)</tt>.
+ * @return 0, falls der Grad des Produkts zu groß ist
+ */
+static int
+pmul(scev_ctx_t* ctx, scev_poly_t* res, const scev_poly_t* p, const scev_poly_t* q)
+{
+	static const int fact[] = {1, 1, 2, 6, 24, 120, 720};
+	scev_poly_t tmp;
+	unsigned int a, b, i;
+	syntree_nid prod;
+
+	pzero(&tmp);
+
+	for (a = 0; a <= SCEV_DEGREE; ++a)
+		for (b = 0; b <= SCEV_DEGREE; ++b)
+		{
+			if ((prod = cmul(ctx, p->coef[a], q->coef[b])) == 0)
+				continue;
+
+			for (i = 0; i <= a && i <= b; ++i)
+			{
+				if (a + b - i > SCEV_DEGREE)
+					return 0;
+
+				tmp.coef[a + b - i] = cadd(ctx, tmp.coef[a + b - i],
+					cmul(ctx, constant(ctx, fact[a + b - i]
+						/ (fact[i] * fact[a - i] * fact[b - i])), prod));
+			}
+		}
+
+	*res = tmp;
+	return 1;
+}
+
+/**@brief Bildet die Summe <tt>p(0) + ... + p(k - 1)</tt>.
+ * @return 0, falls der Grad der Summe zu groß ist
+ */
+static int
+psum(scev_poly_t* res, const scev_poly_t* p)
+{
+	unsigned int d;
+
+	if (p->coef[SCEV_DEGREE] != 0)
+		return 0;
+
+	for (d = SCEV_DEGREE; d > 0; --d)
+		res->coef[d] = p->coef[d - 1];
+
+	res->coef[0] = 0;
+	return 1;
+}
+
+/**@brief Bildet <tt>p(k + 1)</tt>, denn <tt>C(k + 1, d) = C(k, d) + C(k, d - 1)</tt>.
+ */
+static void
+pshift(scev_ctx_t* ctx, scev_poly_t* res, const scev_poly_t* p)
+{
+	unsigned int d;
+
+	for (d = 0; d < SCEV_DEGREE; ++d)
+		res->coef[d] = cadd(ctx, p->coef[d], p->coef[d + 1]);
+
+	res->coef[SCEV_DEGREE] = p->coef[SCEV_DEGREE];
+}
+
+/**@brief Sucht die Fortschreibung einer Variable.
+ * @return Index in recs oder \c len
+ */
+static unsigned int
+find(const scev_ctx_t* ctx, unsigned int slot)
+{
+	unsigned int i;
+
+	for (i = 0; i < ctx->len; ++i)
+		if (ctx->recs[i].slot == slot)
+			break;
+
+	return i;
+}
+
+/**@brief Wertet einen Ausdruck als Polynom in der Anzahl der Durchläufe aus.
+ * @param self  Platz der fortgeschriebenen Variable, der als 0 zählt
+ */
+static scev_result
+eval(scev_ctx_t* ctx, syntree_nid id, unsigned int self, scev_poly_t* res)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	syntree_node_tag tag = node->tag;
+	syntree_nid lhs, rhs;
+	scev_poly_t p, q;
+	scev_result r1, r2;
+	unsigned int i;
+
+	pzero(res);
+
+	if (node->type != SYNTREE_TYPE_Integer)
+		return SCEV_FAIL;
+
+	switch (tag)
+	{
+	case SYNTREE_TAG_Integer:
+		res->coef[0] = constant(ctx, node->value.integer);
+		return SCEV_OK;
+
+	case SYNTREE_TAG_GlobVar:
+		/* der Körper ruft nichts auf, globale Variablen sind also invariant */
+		res->coef[0] = clone(ctx, id);
+		return SCEV_OK;
+
+	case SYNTREE_TAG_LocVar:
+		if (node->value.variable == self)
+			return SCEV_OK;
+
+		if ((i = find(ctx, node->value.variable)) == ctx->len)
+		{
+			res->coef[0] = clone(ctx, id);
+			return SCEV_OK;
+		}
+
+		if (!ctx->recs[i].solved)
+			return SCEV_WAIT;
+
+		/* vorher im Durchlauf zugewiesen: schon der Wert des nächsten */
+		if (i < ctx->pos)
+			pshift(ctx, res, &ctx->recs[i].poly);
+		else
+			*res = ctx->recs[i].poly;
+
+		return SCEV_OK;
+
+	case SYNTREE_TAG_Uminus:
+		if ((r1 = eval(ctx, node->value.container.first, self, &p)) != SCEV_OK)
+			return r1;
+
+		pscale(ctx, res, &p, -1);
+		return SCEV_OK;
+
+	case SYNTREE_TAG_Plus:
+	case SYNTREE_TAG_Minus:
+	case SYNTREE_TAG_Times:
+		lhs = node->value.container.first;
+		rhs = node->value.container.last;
+		r1 = eval(ctx, lhs, self, &p);
+		r2 = eval(ctx, rhs, self, &q);
+
+		if (r1 == SCEV_FAIL || r2 == SCEV_FAIL)
+			return SCEV_FAIL;
+
+		if (r1 == SCEV_WAIT || r2 == SCEV_WAIT)
+			return SCEV_WAIT;
+
+		if (tag == SYNTREE_TAG_Times)
+			return pmul(ctx, res, &p, &q) ? SCEV_OK : SCEV_FAIL;
+
+		if (tag == SYNTREE_TAG_Minus)
+			pscale(ctx, &q, &q, -1);
+
+		padd(ctx, res, &p, &q);
+		return SCEV_OK;
+
+	default:
+		return SCEV_FAIL;
+	}
+}
+
+/**@brief Zählt die Lesezugriffe auf einen Platz in einem Ausdruck.
+ * @param sign  != 0, falls nur Vorkommen mit Vorzeichen + über Additionen
+ *              und linken Seiten von Subtraktionen gezählt werden sollen
+ */
+static unsigned int
+occurs(const scev_ctx_t* ctx, syntree_nid id, unsigned int slot, int sign)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	unsigned int res = 0;
+
+	if (node->tag == SYNTREE_TAG_LocVar)
+		return node->value.variable == slot;
+
+	if (leaf(node))
+		return 0;
+
+	if (sign && node->tag == SYNTREE_TAG_Minus)
+		return occurs(ctx, node->value.container.first, slot, sign);
+
+	if (sign && node->tag != SYNTREE_TAG_Plus)
+		return 0;
+
+	id = node->value.container.first;
+
+	if (node->tag == SYNTREE_TAG_Call || node->tag == SYNTREE_TAG_TailCall)
+		id = ptr(ctx, id)->value.container.first;
+
+	for (; id != 0; id = ptr(ctx, id)->next)
+		res += occurs(ctx, id, slot, sign);
+
+	return res;
+}
+
+/**@brief Sammelt die Zuweisungen eines Durchlaufs.
+ * @return 0, falls der Teilbaum etwas anderes als <tt>v = v + e</tt> enthält
+ */
+static int
+collect(scev_ctx_t* ctx, syntree_nid id)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	const syntree_node_t* var;
+	scev_rec_t* rec;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Sequence:
+		for (id = node->value.container.first; id != 0; id = ptr(ctx, id)->next)
+			if (!collect(ctx, id))
+				return 0;
+
+		return 1;
+
+	case SYNTREE_TAG_Assign:
+		var = ptr(ctx, node->value.container.first);
+
+		if (var->tag != SYNTREE_TAG_LocVar || var->type != SYNTREE_TYPE_Integer
+		 || find(ctx, var->value.variable) < ctx->len
+		 || occurs(ctx, var->next, var->value.variable, 0) != 1
+		 || occurs(ctx, var->next, var->value.variable, 1) != 1)
+			return 0;
+
+		if (ctx->len == ctx->cap)
+		{
+			ctx->cap = ctx->cap ? 2 * ctx->cap : 8;
+
+			if ((ctx->recs = realloc(ctx->recs, ctx->cap * sizeof(*ctx->recs))) == NULL)
+			{
+				fputs("out-of-memory error\n", stderr);
+				exit(-1);
+			}
+		}
+
+		rec = &ctx->recs[ctx->len++];
+		rec->slot = var->value.variable;
+		rec->rhs = var->next;
+		rec->solved = 0;
+		return 1;
+
+	default:
+		return 0;
+	}
+}
+
+/**@brief Bestimmt die Polynome aller fortgeschriebenen Variablen.
+ * @return 0, falls eine Variable nicht polynomiell wächst
+ */
+static int
+solve(scev_ctx_t* ctx)
+{
+	scev_poly_t e, sum, start;
+	unsigned int i, left = ctx->len;
+	int progress = 1;
+
+	while (left > 0 && progress)
+	{
+		progress = 0;
+
+		for (i = 0; i < ctx->len; ++i)
+		{
+			if (ctx->recs[i].solved)
+				continue;
+
+			ctx->pos = i;
+
+			switch (eval(ctx, ctx->recs[i].rhs, ctx->recs[i].slot, &e))
+			{
+			case SCEV_FAIL:
+				return 0;
+
+			case SCEV_WAIT:
+				continue;
+
+			case SCEV_OK:
+				break;
+			}
+
+			/* v(k) = v(0) + e(0) + ... + e(k - 1) */
+			if (!psum(&sum, &e))
+				return 0;
+
+			pzero(&start);
+			start.coef[0] = variable(ctx, ctx->recs[i].slot);
+			padd(ctx, &ctx->recs[i].poly, &start, &sum);
+			ctx->recs[i].solved = 1;
+			progress = 1;
+			--left;
+		}
+	}
+
+	return left == 0;
+}
+
+/**@brief Prüft, ob ein Ausdruck ein ganzzahliger invarianter Wert ist.
+ */
+static int
+invariant(const scev_ctx_t* ctx, syntree_nid id)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+
+	if (node->type != SYNTREE_TYPE_Integer)
+		return 0;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_GlobVar:
+		return 1;
+
+	case SYNTREE_TAG_LocVar:
+		return find(ctx, node->value.variable) == ctx->len;
+
+	default:
+		return 0;
+	}
+}
+
+/**@brief Hängt eine Bedingung an eine Konjunktion an.
+ */
+static syntree_nid
+conjoin(scev_ctx_t* ctx, syntree_nid guard, syntree_nid cond)
+{
+	return (guard != 0) ? compare(ctx, SYNTREE_TAG_LogAnd, guard, cond) : cond;
+}
+
+/**@brief Prüft <tt>x cmp value</tt> statisch oder hängt es an den Wächter an.
+ * @param x  Ausdruck oder Konstante
+ * @return 0, falls die Bedingung statisch verletzt ist
+ */
+static int
+require(scev_ctx_t* ctx, syntree_nid* guard, syntree_nid x,
+        syntree_node_tag cmp, long long value)
+{
+	int known;
+
+	if (literal(ctx, x, &known))
+		return (cmp == SYNTREE_TAG_Geq) ? known >= value : known <= value;
+
+	/* trivial erfüllte Schranken */
+	if ((cmp == SYNTREE_TAG_Geq && value <= INT_MIN)
+	 || (cmp == SYNTREE_TAG_Leq && value >= INT_MAX))
+		return 1;
+
+	*guard = conjoin(ctx, *guard, compare(ctx, cmp, copy(ctx, x),
+		syntreeNodeInteger(ctx->tree, (int) value)));
+	return 1;
+}
+
+/**@brief Legt den Test <tt>v - v / k * k == 0</tt> an.
+ */
+static syntree_nid
+divisible(scev_ctx_t* ctx, unsigned int slot, int k)
+{
+	syntree_nid quot = arith(ctx, SYNTREE_TAG_Divide, variable(ctx, slot),
+		syntreeNodeInteger(ctx->tree, k));
+	syntree_nid rest = arith(ctx, SYNTREE_TAG_Minus, variable(ctx, slot),
+		arith(ctx, SYNTREE_TAG_Times, quot, syntreeNodeInteger(ctx->tree, k)));
+
+	return compare(ctx, SYNTREE_TAG_Eqt, rest, syntreeNodeInteger(ctx->tree, 0));
+}
+
+/**@brief Legt die Zuweisung <tt>v = v / k</tt> an.
+ */
+static syntree_nid
+divide(scev_ctx_t* ctx, unsigned int slot, int k)
+{
+	return assign(ctx, slot, arith(ctx, SYNTREE_TAG_Divide, variable(ctx, slot),
+		syntreeNodeInteger(ctx->tree, k)));
+}
+
+/**@brief Legt einen neuen lokalen Platz an.
+ */
+static unsigned int
+slot(scev_ctx_t* ctx)
+{
+	return ptr(ctx, ctx->func)->value.function.locals++;
+}
+
+/**@brief Hängt die Berechnung von <tt>C(T, 2)</tt> und <tt>C(T, 3)</tt> an.
+ * @details Die Faktoren werden vor dem Multiplizieren durch 2 bzw. 3
+ * geteilt, so dass das Produkt auch bei Überlauf exakt modulo 2^32 ist.
+ * @param binom  Plätze der Binomialkoeffizienten je Grad
+ */
+static void
+binomials(scev_ctx_t* ctx, syntree_nid seq, unsigned int degree, unsigned int* binom)
+{
+	unsigned int f[3], i;
+
+	for (i = 0; i + 2 <= degree && i < 2; ++i)
+	{
+		f[0] = slot(ctx);
+		f[1] = slot(ctx);
+		f[2] = (i == 1) ? slot(ctx) : 0;
+
+		/* f[j] = T - j */
+		syntreeNodeAppend(ctx->tree, seq, assign(ctx, f[0], variable(ctx, binom[1])));
+		syntreeNodeAppend(ctx->tree, seq, assign(ctx, f[1], arith(ctx,
+			SYNTREE_TAG_Minus, variable(ctx, binom[1]), syntreeNodeInteger(ctx->tree, 1))));
+
+		if (i == 1)
+		{
+			syntreeNodeAppend(ctx->tree, seq, assign(ctx, f[2], arith(ctx,
+				SYNTREE_TAG_Minus, variable(ctx, binom[1]), syntreeNodeInteger(ctx->tree, 2))));
+
+			/* einer von drei aufeinanderfolgenden Faktoren ist durch 3 teilbar */
+			syntreeNodeAppend(ctx->tree, seq, branch(ctx, divisible(ctx, f[0], 3),
+				divide(ctx, f[0], 3), branch(ctx, divisible(ctx, f[1], 3),
+					divide(ctx, f[1], 3), divide(ctx, f[2], 3))));
+		}
+
+		/* einer von zwei aufeinanderfolgenden Faktoren ist gerade */
+		syntreeNodeAppend(ctx->tree, seq, branch(ctx, divisible(ctx, f[0], 2),
+			divide(ctx, f[0], 2), divide(ctx, f[1], 2)));
+
+		syntreeNodeAppend(ctx->tree, seq, assign(ctx, f[0], arith(ctx,
+			SYNTREE_TAG_Times, variable(ctx, f[0]), variable(ctx, f[1]))));
+
+		if (i == 1)
+			syntreeNodeAppend(ctx->tree, seq, assign(ctx, f[0], arith(ctx,
+				SYNTREE_TAG_Times, variable(ctx, f[0]), variable(ctx, f[2]))));
+
+		binom[i + 2] = f[0];
+	}
+}
+
+/**@brief Wertet ein Polynom an den Binomialkoeffizienten aus.
+ */
+static syntree_nid
+evaluate(scev_ctx_t* ctx, const scev_poly_t* p, const unsigned int* binom)
+{
+	syntree_nid res = 0, term;
+	unsigned int d;
+	int one;
+
+	for (d = 0; d <= SCEV_DEGREE; ++d)
+	{
+		if (p->coef[d] == 0)
+			continue;
+
+		if (d == 0)
+			term = copy(ctx, p->coef[d]);
+		else if (literal(ctx, p->coef[d], &one) && one == 1)
+			term = variable(ctx, binom[d]);
+		else
+			term = arith(ctx, SYNTREE_TAG_Times, copy(ctx, p->coef[d]),
+			             variable(ctx, binom[d]));
+
+		res = (res != 0) ? arith(ctx, SYNTREE_TAG_Plus, res, term) : term;
+	}
+
+	return (res != 0) ? res : syntreeNodeInteger(ctx->tree, 0);
+}
+
+/**@brief Ersetzt eine Schleife durch ihr Ergebnis in geschlossener Form.
+ */
+static void
+loop(scev_ctx_t* ctx, syntree_nid id)
+{
+	syntree_nid init = 0, cond, step = 0, body, limit, lo, hi, span;
+	syntree_nid guard = 0, seq, stmt;
+	syntree_node_tag op;
+	unsigned int binom[SCEV_DEGREE + 1], temp[8], iv, i, degree = 0;
+	int c, known;
+	syntree_node_t* node;
+
+	if (ptr(ctx, id)->tag == SYNTREE_TAG_For)
+	{
+		init = ptr(ctx, id)->value.container.first;
+		cond = ptr(ctx, init)->next;
+		step = (cond != 0) ? ptr(ctx, cond)->next : 0;
+		body = (step != 0) ? ptr(ctx, step)->next : 0;
+
+		if (body == 0)
+			return;
+	}
+	else
+	{
+		cond = ptr(ctx, id)->value.container.first;
+		body = ptr(ctx, id)->value.container.last;
+	}
+
+	/* ein Durchlauf besteht aus dem Körper und dem Schritt */
+	ctx->len = 0;
+
+	if (!collect(ctx, body) || (step != 0 && !collect(ctx, step))
+	 || ctx->len > sizeof(temp) / sizeof(*temp) || !solve(ctx))
+		return;
+
+	/* die Bedingung vergleicht eine Zählvariable mit einer Invariante */
+	op = ptr(ctx, cond)->tag;
+
+	if (op != SYNTREE_TAG_Lst && op != SYNTREE_TAG_Leq
+	 && op != SYNTREE_TAG_Grt && op != SYNTREE_TAG_Geq)
+		return;
+
+	lo = ptr(ctx, cond)->value.container.first;
+	hi = ptr(ctx, cond)->value.container.last;
+
+	if (ptr(ctx, hi)->tag == SYNTREE_TAG_LocVar && !invariant(ctx, hi))
+	{
+		limit = lo;
+		lo = hi;
+		op = (op == SYNTREE_TAG_Lst) ? SYNTREE_TAG_Grt
+		   : (op == SYNTREE_TAG_Leq) ? SYNTREE_TAG_Geq
+		   : (op == SYNTREE_TAG_Grt) ? SYNTREE_TAG_Lst : SYNTREE_TAG_Leq;
+	}
+	else
+		limit = hi;
+
+	if (ptr(ctx, lo)->tag != SYNTREE_TAG_LocVar || !invariant(ctx, limit)
+	 || (i = find(ctx, ptr(ctx, lo)->value.variable)) == ctx->len)
+		return;
+
+	iv = ctx->recs[i].slot;
+
+	if (!literal(ctx, ctx->recs[i].poly.coef[1], &c) || c == INT_MIN
+	 || pdegree(&ctx->recs[i].poly) != 1)
+		return;
+
+	for (i = 0; i < ctx->len; ++i)
+		if (pdegree(&ctx->recs[i].poly) > degree)
+			degree = pdegree(&ctx->recs[i].poly);
+
+	/* ist der Startwert nach der Initialisierung eine Konstante? */
+	node = (init != 0) ? ptr(ctx, ptr(ctx, init)->value.container.first) : NULL;
+	node = (node != NULL && node->tag == SYNTREE_TAG_LocVar && node->value.variable == iv
+	     && literal(ctx, ptr(ctx, init)->value.container.last, &known)) ? node : NULL;
+
+	/* Überläufe von Durchlaufzahl und Zählvariable ausschließen */
+	if (c > 0 && (op == SYNTREE_TAG_Lst || op == SYNTREE_TAG_Leq))
+	{
+		lo = variable(ctx, iv);
+
+		if (node != NULL)
+		{
+			if (known < 0)
+				return;
+		}
+		else if (!require(ctx, &guard, lo, SYNTREE_TAG_Geq, 0))
+			return;
+
+		if (!require(ctx, &guard, limit, SYNTREE_TAG_Leq,
+		             (long long) INT_MAX - c + (op == SYNTREE_TAG_Lst)))
+			return;
+
+		hi = copy(ctx, limit);
+
+		if (op == SYNTREE_TAG_Leq)
+			hi = arith(ctx, SYNTREE_TAG_Plus, hi, syntreeNodeInteger(ctx->tree, 1));
+	}
+	else if (c < 0 && (op == SYNTREE_TAG_Grt || op == SYNTREE_TAG_Geq))
+	{
+		if (!require(ctx, &guard, limit, SYNTREE_TAG_Geq, (op == SYNTREE_TAG_Geq) ? 0 : -1))
+			return;
+
+		/* mit lo >= -1 bleibt hi - lo <= INT_MAX */
+		hi = variable(ctx, iv);
+
+		if (node != NULL)
+		{
+			if (known > INT_MAX - 1)
+				return;
+		}
+		else if (!require(ctx, &guard, hi, SYNTREE_TAG_Leq, (long long) INT_MAX - 1))
+			return;
+
+		lo = copy(ctx, limit);
+
+		if (op == SYNTREE_TAG_Geq)
+			lo = arith(ctx, SYNTREE_TAG_Minus, lo, syntreeNodeInteger(ctx->tree, 1));
+
+		c = -c;
+	}
+	else
+		return;
+
+	/* T = 0; if (lo < hi) T = (hi - lo - 1) / c + 1 */
+	seq = syntreeNodeEmpty(ctx->tree, SYNTREE_TAG_Sequence);
+	binom[0] = 0;
+	binom[1] = slot(ctx);
+	syntreeNodeAppend(ctx->tree, seq, assign(ctx, binom[1], syntreeNodeInteger(ctx->tree, 0)));
+	span = arith(ctx, SYNTREE_TAG_Minus, copy(ctx, hi), copy(ctx, lo));
+
+	if (c != 1)
+		span = arith(ctx, SYNTREE_TAG_Plus, arith(ctx, SYNTREE_TAG_Divide,
+			arith(ctx, SYNTREE_TAG_Minus, span, syntreeNodeInteger(ctx->tree, 1)),
+			syntreeNodeInteger(ctx->tree, c)), syntreeNodeInteger(ctx->tree, 1));
+
+	syntreeNodeAppend(ctx->tree, seq, branch(ctx, compare(ctx, SYNTREE_TAG_Lst, lo, hi),
+		assign(ctx, binom[1], span), 0));
+	binomials(ctx, seq, degree, binom);
+
+	/* erst alle Ergebnisse, dann die Zuweisungen, da sie Startwerte lesen */
+	for (i = 0; i < ctx->len; ++i)
+	{
+		temp[i] = (ctx->len > 1) ? slot(ctx) : ctx->recs[i].slot;
+		syntreeNodeAppend(ctx->tree, seq,
+			assign(ctx, temp[i], evaluate(ctx, &ctx->recs[i].poly, binom)));
+	}
+
+	if (ctx->len > 1)
+		for (i = 0; i < ctx->len; ++i)
+			syntreeNodeAppend(ctx->tree, seq,
+				assign(ctx, ctx->recs[i].slot, variable(ctx, temp[i])));
+
+	if (guard != 0)
+	{
+		/* sonst läuft die ursprüngliche Schleife */
+		if (init != 0)
+		{
+			ptr(ctx, init)->next = ptr(ctx, step)->next = 0;
+			stmt = syntreeNodeTag(ctx->tree, SYNTREE_TAG_Sequence, body);
+			syntreeNodeAppend(ctx->tree, stmt, step);
+			stmt = syntreeNodePair(ctx->tree, SYNTREE_TAG_While, cond, stmt);
+		}
+		else
+			stmt = clone(ctx, id);
+
+		seq = branch(ctx, guard, seq, stmt);
+	}
+	else if (init != 0)
+		ptr(ctx, init)->next = 0;
+
+	node = ptr(ctx, id);
+	node->tag = SYNTREE_TAG_Sequence;
+	node->type = SYNTREE_TYPE_Void;
+	node->value.container.first = node->value.container.last = 0;
+
+	if (init != 0)
+		syntreeNodeAppend(ctx->tree, id, init);
+
+	syntreeNodeAppend(ctx->tree, id, seq);
+	++ctx->count;
+}
+
+/**@brief Bearbeitet alle Schleifen einer Anweisung.
+ */
+static void
+statement(scev_ctx_t* ctx, syntree_nid id)
+{
+	syntree_nid child;
+
+	switch (ptr(ctx, id)->tag)
+	{
+	case SYNTREE_TAG_Sequence:
+		for (child = ptr(ctx, id)->value.container.first; child != 0;
+		     child = ptr(ctx, child)->next)
+			statement(ctx, child);
+		break;
+
+	case SYNTREE_TAG_If:
+		for (child = ptr(ctx, ptr(ctx, id)->value.container.first)->next;
+		     child != 0; child = ptr(ctx, child)->next)
+			statement(ctx, child);
+		break;
+
+	case SYNTREE_TAG_For:
+	case SYNTREE_TAG_While:
+		statement(ctx, ptr(ctx, id)->value.container.last);
+		loop(ctx, id);
+		break;
+
+	case SYNTREE_TAG_DoWhile:
+		statement(ctx, ptr(ctx, id)->value.container.last);
+		break;
+
+	default:
+		break;
+	}
+}
+
+/* ********************************************************* public functions */
+
+unsigned int
+scevTree(syntree_t* self)
+{
+	scev_ctx_t ctx;
+	unsigned int id, len = self->len;
+
+	ctx.tree = self;
+	ctx.recs = NULL;
+	ctx.len = ctx.cap = 0;
+	ctx.count = 0;
+
+	for (id = 1; id < len; ++id)
+	{
+		if (syntreeNodePtr(self, id)->tag != SYNTREE_TAG_Function)
+			continue;
+
+		ctx.func = id;
+		statement(&ctx, syntreeNodePtr(self, id)->value.function.body);
+	}
+
+	free(ctx.recs);
+	return ctx.count;
+}
@@ -0,0 +1,53 @@
+/***************************************************************************//**
+ * @file scev.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält einen Durchlauf, der Summations- und Zählschleifen durch ihr
+ * Ergebnis in geschlossener Form ersetzt.
+ * @details
+ * Betrachtet werden \c for- und \c while-Schleifen, deren Körper (samt
+ * Schritt) nur aus Zuweisungen der Form <tt>v = v + e</tt> an verschiedene
+ * ganzzahlige lokale Variablen besteht, wobei \c e aus Konstanten,
+ * schleifeninvarianten Variablen und anderen solchen Variablen mit \c +,
+ * \c - und \c * gebildet ist. Der Wert jeder Variable zu Beginn des
+ * \c k-ten Durchlaufs ist dann ein Polynom in \c k, das in der Basis der
+ * Binomialkoeffizienten <tt>C(k, d)</tt> ganzzahlige Koeffizienten hat, denn
+ * die Summe über <tt>C(j, d)</tt> für <tt>j < k</tt> ist <tt>C(k, d + 1)</tt>.
+ * Bis zum Grad 3 wird das Polynom an der Anzahl der Durchläufe ausgewertet,
+ * so dass aus
+ * @code
+ * for (i = 0; i < n; i = i + 1) sum = sum + i;
+ * @endcode
+ * sinngemäß
+ * @code
+ * i = 0; T = 0; if (i < n) T = n - i;
+ * sum = sum + i * T + C(T, 2); i = i + T;
+ * @endcode
+ * wird. Die Bedingung muss eine Variable mit konstanter Schrittweite mit
+ * einem invarianten Wert vergleichen (\c < und \c <= beim Hoch-, \c > und
+ * \c >= beim Herunterzählen). Da die Binomialkoeffizienten ohne Division
+ * durch <tt>d!</tt> berechnet werden, gilt das Ergebnis auch bei Überlauf
+ * exakt modulo 2^32. Lässt sich nicht statisch zeigen, dass weder die
+ * Anzahl der Durchläufe noch die Zählvariable überlaufen kann, wird die
+ * ursprüngliche Schleife als Alternative behalten.
+ *
+ * Der Durchlauf muss vor definiteInit() laufen, da er neue Plätze einführt.
+ ******************************************************************************/
+
+#ifndef SCEV_H_INCLUDED
+#define SCEV_H_INCLUDED
+
+/* *** includes ************************************************************* */
+
+#include "syntree.h"
+
+/* *** interface ************************************************************ */
+
+/**@brief Ersetzt Summations- und Zählschleifen aller Funktionen durch ihr
+ * Ergebnis in geschlossener Form.
+ * @param self  der Syntaxbaum
+ * @return Anzahl der ersetzten Schleifen
+ */
+extern unsigned int
+scevTree(syntree_t* self);
+
+#endif /* SCEV_H_INCLUDED */
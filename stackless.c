@@ -0,0 +1,720 @@
+/***************************************************************************//**
+ * @file stackless.c
+ * @author Dorian Weber und die Studenten
+ * @brief Implementation des stacklosen Bauminterpreters.
+ ******************************************************************************/
+
+#include "stackless.h"
+#include "minako.h"
+#include "quota.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**@brief Anfangskapazität der wachsenden Stacks.
+ */
+#define STACKLESS_INITIAL_SIZE 256
+
+/* *************************************************************** structures */
+
+/**@brief Kontrollrahmen eines gerade ausgewerteten Knotens.
+ */
+typedef struct stackless_frame_s
+{
+	const syntree_node_t* node; /**<@brief Ausgewerteter Knoten. */
+	unsigned int state;         /**<@brief Fortschritt innerhalb des Knotens. */
+	syntree_nid child;          /**<@brief Nächstes Kind einer Sequenz. */
+	unsigned int mark;          /**<@brief Höhe des Wertestacks. */
+	unsigned int ebp;           /**<@brief Gesicherter Base pointer. */
+} stackless_frame_t;
+
+/**@brief Laufzeitzustand des Interpreters.
+ * @note Alle Positionen sind Indizes statt Zeiger, da die Stacks beim
+ * Wachsen verschoben werden können.
+ */
+typedef struct stackless_s
+{
+	stackless_frame_t* frames; /**<@brief Kontrollstack. */
+	unsigned int nframes;      /**<@brief Anzahl der Kontrollrahmen. */
+	unsigned int cframes;      /**<@brief Kapazität des Kontrollstacks. */
+
+	minako_data_t* values;     /**<@brief Wertestack. */
+	unsigned int nvalues;      /**<@brief Anzahl der Zwischenergebnisse. */
+	unsigned int cvalues;      /**<@brief Kapazität des Wertestacks. */
+
+	minako_data_t* vars;       /**<@brief Variablenstack. */
+	unsigned int nvars;        /**<@brief Anzahl der belegten Variablen. */
+	unsigned int cvars;        /**<@brief Kapazität des Variablenstacks. */
+
+	size_t limit;              /**<@brief Höchstgröße aller Stacks in Bytes. */
+	unsigned int ebp;          /**<@brief Base pointer der aktuellen Funktion. */
+	minako_data_t ret;         /**<@brief Rückgaberegister. */
+} stackless_t;
+
+/* ****************************************************************** globals */
+
+/**@brief Der ausgeführte Syntaxbaum.
+ */
+static const syntree_t* ast;
+
+/* ******************************************************** private functions */
+
+/**@brief Meldet einen Stacküberlauf und beendet das Programm.
+ */
+static void
+overflow(void)
+{
+	fflush(stdout);
+	fputs("stack overflow\n", stderr);
+	exit(QUOTA_EXIT_STACK);
+}
+
+/**@brief Vergrößert einen Stack so, dass er mindestens \p need Elemente
+ * fasst.
+ * @note Kontroll-, Werte- und Variablenstack zählen gemeinsam zur
+ * Stackgröße, da sie zusammen die Rekursionstiefe bestimmen.
+ */
+static void*
+grow(const stackless_t* self, void* data, unsigned int* cap, unsigned int need,
+     size_t size)
+{
+	size_t used = self->cframes * sizeof(*self->frames)
+	            + self->cvalues * sizeof(*self->values)
+	            + self->cvars * sizeof(*self->vars) - *cap * size;
+	unsigned int len = *cap;
+
+	if (used + (size_t) need * size > self->limit)
+		overflow();
+
+	while (len < need)
+		len *= 2;
+
+	if (used + (size_t) len * size > self->limit)
+		len = (unsigned int) ((self->limit - used) / size);
+
+	data = realloc(data, len * size);
+
+	if (data == NULL)
+	{
+		fputs("out-of-memory error\n", stderr);
+		exit(-1);
+	}
+
+	*cap = len;
+	return data;
+}
+
+/**@brief Legt einen Kontrollrahmen für einen Knoten an.
+ * @note Macht alle Zeiger auf Kontrollrahmen ungültig.
+ */
+static inline void
+enter(stackless_t* self, syntree_nid id)
+{
+	stackless_frame_t* frame;
+
+	if (self->nframes == self->cframes)
+		self->frames = grow(self, self->frames, &self->cframes, self->nframes + 1,
+			sizeof(*self->frames));
+
+	frame = &self->frames[self->nframes++];
+	frame->node = syntreeNodePtr(ast, id);
+	frame->state = 0;
+}
+
+/**@brief Legt ein Zwischenergebnis auf den Wertestack.
+ */
+static inline void
+push(stackless_t* self, minako_data_t value)
+{
+	if (self->nvalues == self->cvalues)
+		self->values = grow(self, self->values, &self->cvalues, self->nvalues + 1,
+			sizeof(*self->values));
+
+	self->values[self->nvalues++] = value;
+}
+
+/**@brief Entnimmt ein Zwischenergebnis vom Wertestack.
+ */
+static inline minako_data_t
+pop(stackless_t* self)
+{
+	return self->values[--self->nvalues];
+}
+
+/**@brief Belegt \p count neue Variablen mit \c DUMMY.
+ * @return Index der ersten neuen Variable
+ */
+static inline unsigned int
+allocate(stackless_t* self, unsigned int count)
+{
+	unsigned int base = self->nvars, i;
+
+	if (base + count > self->cvars)
+		self->vars = grow(self, self->vars, &self->cvars, base + count,
+			sizeof(*self->vars));
+
+	for (i = 0; i < count; ++i)
+		self->vars[base + i].integer = DUMMY;
+
+	self->nvars += count;
+	return base;
+}
+
+/**@brief Gibt an, ob die Auswertung eines Knotens einen Wert hinterlässt.
+ */
+static inline int
+produces(syntree_node_tag tag)
+{
+	switch (tag)
+	{
+	case SYNTREE_TAG_Program:
+	case SYNTREE_TAG_Function:
+	case SYNTREE_TAG_Sequence:
+	case SYNTREE_TAG_If:
+	case SYNTREE_TAG_For:
+	case SYNTREE_TAG_DoWhile:
+	case SYNTREE_TAG_While:
+	case SYNTREE_TAG_Print:
+	case SYNTREE_TAG_Return:
+		return 0;
+
+	default:
+		return 1;
+	}
+}
+
+/**@brief Wertet einen Operanden aus. Blätter werden sofort auf den
+ * Wertestack gelegt, alle anderen Knoten bekommen einen Kontrollrahmen.
+ * @note Kann alle Zeiger auf Kontrollrahmen ungültig machen.
+ */
+static inline void
+operand(stackless_t* self, syntree_nid id)
+{
+	const syntree_node_t* node = syntreeNodePtr(ast, id);
+	minako_data_t value;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+		value.integer = node->value.integer;
+		break;
+
+	case SYNTREE_TAG_Float:
+		value.real = node->value.real;
+		break;
+
+	case SYNTREE_TAG_Boolean:
+		value.boolean = node->value.boolean;
+		break;
+
+	case SYNTREE_TAG_String:
+		value.string = id;
+		break;
+
+	case SYNTREE_TAG_LocVar:
+		value = self->vars[self->ebp + node->value.variable];
+		break;
+
+	case SYNTREE_TAG_GlobVar:
+		value = self->vars[node->value.variable];
+		break;
+
+	default:
+		enter(self, id);
+		return;
+	}
+
+	push(self, value);
+}
+
+/**@brief Verknüpft die beiden obersten Zwischenergebnisse.
+ */
+static inline void
+binary(stackless_t* self, syntree_node_tag tag)
+{
+	minako_data_t rhs = pop(self);
+	minako_data_t* lhs = &self->values[self->nvalues - 1];
+
+	switch (tag)
+	{
+	case SYNTREE_TAG_PlusInt:     lhs->integer += rhs.integer; break;
+	case SYNTREE_TAG_MinusInt:    lhs->integer -= rhs.integer; break;
+	case SYNTREE_TAG_TimesInt:    lhs->integer *= rhs.integer; break;
+	case SYNTREE_TAG_DivideInt:   lhs->integer /= rhs.integer; break;
+	case SYNTREE_TAG_PlusFloat:   lhs->real += rhs.real; break;
+	case SYNTREE_TAG_MinusFloat:  lhs->real -= rhs.real; break;
+	case SYNTREE_TAG_TimesFloat:  lhs->real *= rhs.real; break;
+	case SYNTREE_TAG_DivideFloat: lhs->real /= rhs.real; break;
+	case SYNTREE_TAG_EqtInt: lhs->boolean = lhs->integer == rhs.integer; break;
+	case SYNTREE_TAG_NeqInt: lhs->boolean = lhs->integer != rhs.integer; break;
+	case SYNTREE_TAG_LeqInt: lhs->boolean = lhs->integer <= rhs.integer; break;
+	case SYNTREE_TAG_GeqInt: lhs->boolean = lhs->integer >= rhs.integer; break;
+	case SYNTREE_TAG_LstInt: lhs->boolean = lhs->integer <  rhs.integer; break;
+	case SYNTREE_TAG_GrtInt: lhs->boolean = lhs->integer >  rhs.integer; break;
+	case SYNTREE_TAG_EqtFloat: lhs->boolean = lhs->real == rhs.real; break;
+	case SYNTREE_TAG_NeqFloat: lhs->boolean = lhs->real != rhs.real; break;
+	case SYNTREE_TAG_LeqFloat: lhs->boolean = lhs->real <= rhs.real; break;
+	case SYNTREE_TAG_GeqFloat: lhs->boolean = lhs->real >= rhs.real; break;
+	case SYNTREE_TAG_LstFloat: lhs->boolean = lhs->real <  rhs.real; break;
+	case SYNTREE_TAG_GrtFloat: lhs->boolean = lhs->real >  rhs.real; break;
+	default: break;
+	}
+}
+
+/**@brief Gibt ein Zwischenergebnis wie execPrint() aus.
+ */
+static void
+print(syntree_node_type type, minako_data_t value)
+{
+	switch (type)
+	{
+	case SYNTREE_TYPE_Boolean:
+		fputs(value.boolean ? "true" : "false", stdout);
+		break;
+
+	case SYNTREE_TYPE_Integer:
+		printf("%i", value.integer);
+		break;
+
+	case SYNTREE_TYPE_Float:
+		printf("%g", value.real);
+		break;
+
+	case SYNTREE_TYPE_String:
+		fputs(syntreeNodePtr(ast, value.string)->value.string, stdout);
+		break;
+
+	default:
+		break;
+	}
+
+	putc('\n', stdout);
+}
+
+/**@brief Verlässt die aktuelle Funktion. Alle Kontrollrahmen bis zum Aufruf
+ * bzw. zur Funktion werden verworfen, der Wertestack wird auf seine Höhe beim
+ * Eintritt zurückgesetzt.
+ */
+static void
+unwind(stackless_t* self)
+{
+	const stackless_frame_t* frame;
+
+	for (;;)
+	{
+		frame = &self->frames[self->nframes - 1];
+
+		if (frame->node->tag == SYNTREE_TAG_Call
+		 || frame->node->tag == SYNTREE_TAG_Function)
+			break;
+
+		--self->nframes;
+	}
+
+	self->nvalues = frame->mark;
+}
+
+/**@brief Die Interpreterschleife.
+ * @details Jeder Schritt bearbeitet den obersten Kontrollrahmen. Ein Knoten
+ * vermerkt vor dem Anlegen eines Kindrahmens, an welcher Stelle er fortgesetzt
+ * wird, und entfernt seinen Rahmen, sobald er fertig ist. Ausdrücke
+ * hinterlassen genau einen Wert auf dem Wertestack.
+ */
+static void
+run(stackless_t* self)
+{
+	stackless_frame_t* frame;
+	const syntree_node_t* node;
+	const syntree_node_t* func;
+	minako_data_t value;
+	unsigned int base, count, i;
+
+	while (self->nframes > 0)
+	{
+		frame = &self->frames[self->nframes - 1];
+		node = frame->node;
+
+		switch (node->tag)
+		{
+		/* Blätter als Anweisung bzw. als Wurzel eines Ausdrucks */
+		case SYNTREE_TAG_Integer:
+		case SYNTREE_TAG_Float:
+		case SYNTREE_TAG_Boolean:
+		case SYNTREE_TAG_String:
+		case SYNTREE_TAG_LocVar:
+		case SYNTREE_TAG_GlobVar:
+			--self->nframes;
+			operand(self, syntreeNodeId(ast, node));
+			break;
+
+		case SYNTREE_TAG_Program:
+			if (frame->state == 0)
+			{
+				frame->state = 1;
+				frame->child = node->value.program.body;
+				self->ebp = allocate(self, node->value.program.globals);
+			}
+
+			/* der Programmkörper ist eine verkettete Anweisungsliste */
+			if (frame->state == 2)
+			{
+				--self->nvalues;
+				frame->state = 1;
+			}
+
+			if (frame->child == 0)
+			{
+				--self->nframes;
+				break;
+			}
+
+			i = frame->child;
+			frame->child = syntreeNodePtr(ast, i)->next;
+			frame->state = produces(syntreeNodePtr(ast, i)->tag) ? 2 : 1;
+			enter(self, i);
+			break;
+
+		case SYNTREE_TAG_Function:
+			/* nur main wird direkt betreten, alle anderen über Call */
+			if (frame->state == 0)
+			{
+				frame->state = 1;
+				frame->ebp = self->ebp;
+				frame->mark = self->nvalues;
+				self->ebp = allocate(self, node->value.function.locals);
+				enter(self, node->value.function.body);
+				break;
+			}
+
+			self->nvars = self->ebp;
+			self->ebp = frame->ebp;
+			--self->nframes;
+			break;
+
+		case SYNTREE_TAG_Call:
+			func = syntreeNodePtr(ast, node->value.container.last);
+
+			switch (frame->state)
+			{
+			case 0:
+				frame->state = 1;
+				frame->mark = self->nvalues;
+				frame->child =
+					syntreeNodePtr(ast, node->value.container.first)->value.container.first;
+				/* fall through */
+
+			case 1:
+				if (frame->child != 0)
+				{
+					i = frame->child;
+					frame->child = syntreeNodePtr(ast, i)->next;
+					operand(self, i);
+					break;
+				}
+
+				QUOTA_BURN();
+
+				/* Argumente in den neuen Rahmen übernehmen */
+				count = self->nvalues - frame->mark;
+				base = allocate(self, func->value.function.locals);
+
+				for (i = 0; i < count; ++i)
+					self->vars[base + i] = self->values[frame->mark + i];
+
+				self->nvalues = frame->mark;
+				frame->ebp = self->ebp;
+				frame->state = 2;
+				self->ebp = base;
+				enter(self, func->value.function.body);
+				break;
+
+			default:
+				self->nvars = self->ebp;
+				self->ebp = frame->ebp;
+				--self->nframes;
+				push(self, self->ret);
+				break;
+			}
+			break;
+
+		case SYNTREE_TAG_Sequence:
+			if (frame->state == 0)
+				frame->child = node->value.container.first;
+			else if (frame->state == 2)
+				--self->nvalues;
+
+			if (frame->child == 0)
+			{
+				--self->nframes;
+				break;
+			}
+
+			i = frame->child;
+			frame->child = syntreeNodePtr(ast, i)->next;
+			frame->state = produces(syntreeNodePtr(ast, i)->tag) ? 2 : 1;
+			enter(self, i);
+			break;
+
+		case SYNTREE_TAG_If:
+			switch (frame->state)
+			{
+			case 0:
+				frame->state = 1;
+				operand(self, node->value.container.first);
+				break;
+
+			case 1:
+				frame->state = 2;
+				node = syntreeNodePtr(ast, node->value.container.first);
+
+				if (pop(self).boolean)
+					enter(self, node->next);
+				else if (syntreeNodePtr(ast, node->next)->next != 0)
+					enter(self, syntreeNodePtr(ast, node->next)->next);
+				break;
+
+			default:
+				--self->nframes;
+				break;
+			}
+			break;
+
+		case SYNTREE_TAG_While:
+			/* Zustand 0: Bedingung, Zustand 1: Test und Körper */
+			if (frame->state == 0)
+			{
+				frame->state = 1;
+				operand(self, node->value.container.first);
+			}
+			else if (pop(self).boolean)
+			{
+				QUOTA_BURN();
+				frame->state = 0;
+				enter(self, node->value.container.last);
+			}
+			else
+				--self->nframes;
+			break;
+
+		case SYNTREE_TAG_DoWhile:
+			switch (frame->state)
+			{
+			case 0:
+				frame->state = 1;
+				enter(self, node->value.container.last);
+				break;
+
+			case 1:
+				frame->state = 2;
+				operand(self, node->value.container.first);
+				break;
+
+			default:
+				if (pop(self).boolean)
+				{
+					QUOTA_BURN();
+					frame->state = 0;
+				}
+				else
+					--self->nframes;
+				break;
+			}
+			break;
+
+		case SYNTREE_TAG_For:
+			/* Kinder: Initialisierung, Bedingung, Schritt, Körper */
+			switch (frame->state)
+			{
+			case 0:
+				frame->state = 1;
+				enter(self, node->value.container.first);
+				break;
+
+			case 1:
+			case 5:
+				/* Wert der Initialisierung bzw. des Schrittes verwerfen */
+				--self->nvalues;
+				frame->state = 3;
+				operand(self, syntreeNodePtr(ast, node->value.container.first)->next);
+				break;
+
+			case 3:
+				if (!pop(self).boolean)
+				{
+					--self->nframes;
+					break;
+				}
+
+				frame->state = 4;
+				node = syntreeNodePtr(ast, node->value.container.first);
+				node = syntreeNodePtr(ast, node->next);
+				enter(self, syntreeNodePtr(ast, node->next)->next);
+				break;
+
+			default:
+				QUOTA_BURN();
+				frame->state = 5;
+				node = syntreeNodePtr(ast, node->value.container.first);
+				node = syntreeNodePtr(ast, node->next);
+				enter(self, node->next);
+				break;
+			}
+			break;
+
+		case SYNTREE_TAG_Print:
+			if (frame->state == 0)
+			{
+				frame->state = 1;
+				operand(self, node->value.container.first);
+				break;
+			}
+
+			print(syntreeNodePtr(ast, node->value.container.first)->type,
+				pop(self));
+			--self->nframes;
+			break;
+
+		case SYNTREE_TAG_Return:
+			if (frame->state == 0 && node->value.container.first != 0)
+			{
+				frame->state = 1;
+				operand(self, node->value.container.first);
+				break;
+			}
+
+			if (frame->state == 1)
+				self->ret = pop(self);
+
+			unwind(self);
+			break;
+
+		case SYNTREE_TAG_Assign:
+			if (frame->state == 0)
+			{
+				frame->state = 1;
+				operand(self, node->value.container.last);
+				break;
+			}
+
+			node = syntreeNodePtr(ast, node->value.container.first);
+			value = self->values[self->nvalues - 1];
+
+			if (node->tag == SYNTREE_TAG_GlobVar)
+				self->vars[node->value.variable] = value;
+			else
+				self->vars[self->ebp + node->value.variable] = value;
+
+			--self->nframes;
+			break;
+
+		case SYNTREE_TAG_LogOr:
+		case SYNTREE_TAG_LogAnd:
+			switch (frame->state)
+			{
+			case 0:
+				frame->state = 1;
+				operand(self, node->value.container.first);
+				break;
+
+			case 1:
+				/* Kurzschlussauswertung; wie beim rekursiven Interpreter zählt
+				 * jeder Wert ungleich 0 als wahr und das Ergebnis ist 0 oder 1 */
+				if ((self->values[self->nvalues - 1].boolean != 0)
+				 == (node->tag == SYNTREE_TAG_LogOr))
+				{
+					self->values[self->nvalues - 1].boolean =
+						(node->tag == SYNTREE_TAG_LogOr);
+					--self->nframes;
+					break;
+				}
+
+				--self->nvalues;
+				frame->state = 2;
+				operand(self, node->value.container.last);
+				break;
+
+			default:
+				self->values[self->nvalues - 1].boolean =
+					(self->values[self->nvalues - 1].boolean != 0);
+				--self->nframes;
+				break;
+			}
+			break;
+
+		case SYNTREE_TAG_CastInt:
+		case SYNTREE_TAG_UminusInt:
+		case SYNTREE_TAG_UminusFloat:
+			if (frame->state == 0)
+			{
+				frame->state = 1;
+				operand(self, node->value.container.first);
+				break;
+			}
+
+			value = self->values[self->nvalues - 1];
+
+			if (node->tag == SYNTREE_TAG_CastInt)
+				value.real = (float) value.integer;
+			else if (node->tag == SYNTREE_TAG_UminusInt)
+				value.integer = -value.integer;
+			else
+				value.real = -value.real;
+
+			self->values[self->nvalues - 1] = value;
+			--self->nframes;
+			break;
+
+		default:
+			/* typspezialisierte zweistellige Operatoren */
+			switch (frame->state)
+			{
+			case 0:
+				frame->state = 1;
+				operand(self, node->value.container.first);
+				break;
+
+			case 1:
+				frame->state = 2;
+				operand(self, node->value.container.last);
+				break;
+
+			default:
+				binary(self, node->tag);
+				--self->nframes;
+				break;
+			}
+			break;
+		}
+	}
+}
+
+/* ********************************************************* public functions */
+
+void
+stacklessRun(const syntree_t* tree, size_t size)
+{
+	stackless_t self;
+
+	ast = tree;
+
+	self.nframes = self.nvalues = self.nvars = 0;
+	self.cframes = self.cvalues = self.cvars = STACKLESS_INITIAL_SIZE;
+	self.frames = malloc(self.cframes * sizeof(*self.frames));
+	self.values = malloc(self.cvalues * sizeof(*self.values));
+	self.vars = malloc(self.cvars * sizeof(*self.vars));
+	self.limit = size << 20;
+	self.ebp = 0;
+	self.ret.integer = DUMMY;
+
+	if (self.frames == NULL || self.values == NULL || self.vars == NULL)
+	{
+		fputs("out-of-memory error\n", stderr);
+		exit(-1);
+	}
+
+	enter(&self, 0);
+	run(&self);
+
+	free(self.frames);
+	free(self.values);
+	free(self.vars);
+}
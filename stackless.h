@@ -0,0 +1,41 @@
+/***************************************************************************//**
+ * @file stackless.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält einen Bauminterpreter, der C1-Aufrufe nicht auf dem C-Stack
+ * schachtelt.
+ * @details
+ * Hier ist ein Beispiel für die Benutzung:
+ * @code
+ * quickenTree(ast);
+ * stacklessRun(ast, 1024);
+ * @endcode
+ *
+ * Der Interpreter läuft in einer einzigen Schleife. Der Kontrollzustand jedes
+ * gerade ausgewerteten Knotens liegt als Rahmen (Knoten, Zustand, aktuelles
+ * Kind) auf einem expliziten, im Heap wachsenden Kontrollstack; Zwischen-
+ * ergebnisse liegen auf einem Wertestack und die C1-Variablen auf einem
+ * ebenfalls wachsenden Variablenstack. Aufrufe und Rücksprünge verschieben nur
+ * Indizes, die Rekursionstiefe ist allein durch die Stackgröße begrenzt.
+ *
+ * Der Interpreter erwartet die Knotenarten von quickenTree().
+ ******************************************************************************/
+
+#ifndef STACKLESS_H_INCLUDED
+#define STACKLESS_H_INCLUDED
+
+/* *** includes ************************************************************* */
+
+#include "syntree.h"
+#include <stddef.h>
+
+/* *** interface ************************************************************ */
+
+/**@brief Führt ein Programm aus.
+ * @param tree  der (spezialisierte) Syntaxbaum
+ * @param size  gemeinsame Größe aller Stacks in MiB; wird sie überschritten,
+ *              endet das Programm mit \c QUOTA_EXIT_STACK
+ */
+extern void
+stacklessRun(const syntree_t* tree, size_t size);
+
+#endif /* STACKLESS_H_INCLUDED */
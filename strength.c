@@ -0,0 +1,666 @@
+/***************************************************************************//**
+ * @file strength.c
+ * @author Dorian Weber und die Studenten
+ * @brief Implementation der Induktionsvariablenanalyse und Stärkereduktion.
+ ******************************************************************************/
+
+#include "strength.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* ******************************************************* private structures */
+
+/**@brief Eine abgeleitete Induktionsvariable <tt>i * m</tt> der Schleife.
+ */
+typedef struct strength_derived_s
+{
+	syntree_node_tag tag;  /**<@brief Art des Faktors (Konstante oder Platz). */
+	int value;             /**<@brief Wert oder Platz des Faktors. */
+	unsigned int weight;   /**<@brief Gewichtete Anzahl der Vorkommen. */
+	unsigned int slot;     /**<@brief Neuer Platz oder 0, falls nicht ersetzt. */
+	syntree_nid update;    /**<@brief Fortschreibung am Ende des Körpers. */
+} strength_derived_t;
+
+/**@brief Zustand während der Bearbeitung einer Funktion.
+ */
+typedef struct strength_ctx_s
+{
+	syntree_t* tree;              /**<@brief Der Syntaxbaum. */
+	syntree_nid func;             /**<@brief Knoten-ID der Funktion. */
+	unsigned int iv;              /**<@brief Platz der Basisinduktionsvariable. */
+	unsigned char* written;       /**<@brief Platz -> in der Schleife zugewiesen. */
+	unsigned int cap;             /**<@brief Kapazität von written. */
+	strength_derived_t* derived;  /**<@brief Abgeleitete Induktionsvariablen. */
+	unsigned int len;             /**<@brief Anzahl der Einträge in derived. */
+	unsigned int dcap;            /**<@brief Kapazität von derived. */
+	unsigned int count;           /**<@brief Anzahl der ersetzten Ausdrücke. */
+} strength_ctx_t;
+
+/* ******************************************************** private functions */
+
+/**@brief Gibt einen Zeiger auf einen Knoten zurück.
+ * @note Der Zeiger ist nach dem Anlegen neuer Knoten ungültig.
+ */
+static inline syntree_node_t*
+ptr(const strength_ctx_t* ctx, syntree_nid id)
+{
+	return syntreeNodePtr(ctx->tree, id);
+}
+
+/**@brief Prüft, ob ein Knoten ein Blatt ist.
+ */
+static inline int
+leaf(const syntree_node_t* node)
+{
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Integer:
+	case SYNTREE_TAG_Float:
+	case SYNTREE_TAG_Boolean:
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_LocVar:
+	case SYNTREE_TAG_GlobVar:
+		return 1;
+
+	default:
+		return 0;
+	}
+}
+
+/**@brief Vergrößert einen Puffer oder beendet das Programm.
+ */
+static void*
+grow(void* buf, size_t size)
+{
+	if ((buf = realloc(buf, size)) == NULL)
+	{
+		fputs("out-of-memory error\n", stderr);
+		exit(-1);
+	}
+
+	return buf;
+}
+
+/**@brief Legt eine Kopie eines einzelnen Knotens ohne Nachfolger an.
+ */
+static syntree_nid
+clone(strength_ctx_t* ctx, syntree_nid id)
+{
+	syntree_nid res = syntreeNodeVariable(ctx->tree, NULL);
+
+	*ptr(ctx, res) = *ptr(ctx, id);
+	ptr(ctx, res)->next = 0;
+	return res;
+}
+
+/**@brief Kopiert einen seiteneffektfreien Ausdruck (siehe pure()).
+ */
+static syntree_nid
+copy(strength_ctx_t* ctx, syntree_nid id)
+{
+	syntree_nid res = clone(ctx, id), child, last = 0;
+
+	if (leaf(ptr(ctx, id)))
+		return res;
+
+	for (child = ptr(ctx, id)->value.container.first; child != 0;
+	     child = ptr(ctx, child)->next)
+	{
+		syntree_nid dup = copy(ctx, child);
+
+		if (last == 0)
+			ptr(ctx, res)->value.container.first = dup;
+		else
+			ptr(ctx, last)->next = dup;
+
+		last = dup;
+	}
+
+	ptr(ctx, res)->value.container.last = last;
+	return res;
+}
+
+/**@brief Prüft, ob ein Ausdruck ohne Seiteneffekte ein zweites Mal
+ * ausgewertet werden darf.
+ */
+static int
+pure(const strength_ctx_t* ctx, syntree_nid id)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_String:
+	case SYNTREE_TAG_Assign:
+	case SYNTREE_TAG_Call:
+	case SYNTREE_TAG_TailCall:
+		return 0;
+
+	default:
+		if (leaf(node))
+			return 1;
+
+		break;
+	}
+
+	for (id = node->value.container.first; id != 0; id = ptr(ctx, id)->next)
+		if (!pure(ctx, id))
+			return 0;
+
+	return 1;
+}
+
+/**@brief Legt einen Knoten an, der einen lokalen Platz liest.
+ */
+static syntree_nid
+variable(strength_ctx_t* ctx, unsigned int slot)
+{
+	syntree_nid id = syntreeNodeVariable(ctx->tree, NULL);
+	syntree_node_t* node = ptr(ctx, id);
+
+	node->tag = SYNTREE_TAG_LocVar;
+	node->type = SYNTREE_TYPE_Integer;
+	node->value.variable = slot;
+	return id;
+}
+
+/**@brief Legt einen ganzzahligen binären Operator an.
+ */
+static syntree_nid
+binary(strength_ctx_t* ctx, syntree_node_tag tag, syntree_nid lhs, syntree_nid rhs)
+{
+	syntree_nid id = syntreeNodePair(ctx->tree, tag, lhs, rhs);
+
+	ptr(ctx, id)->type = SYNTREE_TYPE_Integer;
+	return id;
+}
+
+/**@brief Legt eine Zuweisung an einen lokalen Platz an.
+ */
+static syntree_nid
+assign(strength_ctx_t* ctx, unsigned int slot, syntree_nid expr)
+{
+	return syntreeNodePair(ctx->tree, SYNTREE_TAG_Assign, variable(ctx, slot), expr);
+}
+
+/**@brief Sammelt die in einem Teilbaum zugewiesenen lokalen Variablen.
+ */
+static void
+writes(strength_ctx_t* ctx, syntree_nid id)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	const syntree_node_t* var;
+
+	if (leaf(node))
+		return;
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Assign:
+		var = ptr(ctx, node->value.container.first);
+
+		if (var->tag == SYNTREE_TAG_LocVar)
+			ctx->written[var->value.variable] = 1;
+
+		id = var->next;
+		break;
+
+	case SYNTREE_TAG_Call:
+	case SYNTREE_TAG_TailCall:
+		id = ptr(ctx, node->value.container.first)->value.container.first;
+		break;
+
+	default:
+		id = node->value.container.first;
+		break;
+	}
+
+	for (; id != 0; id = ptr(ctx, id)->next)
+		writes(ctx, id);
+}
+
+/**@brief Prüft, ob ein Knoten die Basisinduktionsvariable liest.
+ */
+static inline int
+induction(const strength_ctx_t* ctx, syntree_nid id)
+{
+	return ptr(ctx, id)->tag == SYNTREE_TAG_LocVar
+	    && ptr(ctx, id)->value.variable == ctx->iv;
+}
+
+/**@brief Gibt den Faktor eines Produkts <tt>i * m</tt> zurück.
+ * @return Knoten-ID von \c m oder 0, falls der Knoten keine abgeleitete
+ *         Induktionsvariable ist
+ */
+static syntree_nid
+factor(const strength_ctx_t* ctx, syntree_nid id)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	syntree_nid lhs, rhs;
+
+	if (node->tag != SYNTREE_TAG_Times || node->type != SYNTREE_TYPE_Integer)
+		return 0;
+
+	lhs = node->value.container.first;
+	rhs = node->value.container.last;
+
+	if (induction(ctx, rhs))
+	{
+		rhs = lhs;
+		lhs = node->value.container.last;
+	}
+
+	if (!induction(ctx, lhs))
+		return 0;
+
+	node = ptr(ctx, rhs);
+
+	if (node->tag == SYNTREE_TAG_Integer
+	 || (node->tag == SYNTREE_TAG_LocVar && !ctx->written[node->value.variable]))
+		return rhs;
+
+	return 0;
+}
+
+/**@brief Sucht die abgeleitete Induktionsvariable zu einem Faktor.
+ * @param insert  != 0, falls ein fehlender Eintrag angelegt werden soll
+ * @return Index in derived oder \c len, falls es keinen Eintrag gibt
+ */
+static unsigned int
+lookup(strength_ctx_t* ctx, syntree_nid mul, int insert)
+{
+	const syntree_node_t* node = ptr(ctx, mul);
+	int value = (node->tag == SYNTREE_TAG_Integer)
+	          ? node->value.integer : (int) node->value.variable;
+	unsigned int i;
+
+	for (i = 0; i < ctx->len; ++i)
+		if (ctx->derived[i].tag == node->tag && ctx->derived[i].value == value)
+			return i;
+
+	if (!insert)
+		return i;
+
+	if (ctx->len == ctx->dcap)
+	{
+		ctx->dcap = ctx->dcap ? 2 * ctx->dcap : 8;
+		ctx->derived = grow(ctx->derived, ctx->dcap * sizeof(*ctx->derived));
+	}
+
+	ctx->derived[i].tag = node->tag;
+	ctx->derived[i].value = value;
+	ctx->derived[i].weight = 0;
+	ctx->derived[i].slot = 0;
+	return ctx->len++;
+}
+
+/**@brief Zählt die Vorkommen abgeleiteter Induktionsvariablen.
+ * @param depth  Schachtelungstiefe innerhalb der Schleife
+ */
+static void
+count(strength_ctx_t* ctx, syntree_nid id, unsigned int depth)
+{
+	const syntree_node_t* node = ptr(ctx, id);
+	syntree_nid mul;
+	unsigned int i;
+
+	if (leaf(node))
+		return;
+
+	if ((mul = factor(ctx, id)) != 0)
+	{
+		/* in einer inneren Schleife lohnt schon ein Vorkommen */
+		i = lookup(ctx, mul, 1);
+		ctx->derived[i].weight += (depth > 0) ? 2 : 1;
+		return;
+	}
+
+	switch (node->tag)
+	{
+	case SYNTREE_TAG_Call:
+	case SYNTREE_TAG_TailCall:
+		id = ptr(ctx, node->value.container.first)->value.container.first;
+		break;
+
+	case SYNTREE_TAG_For:
+	case SYNTREE_TAG_While:
+	case SYNTREE_TAG_DoWhile:
+		++depth;
+		/* fall through */
+	default:
+		id = node->value.container.first;
+		break;
+	}
+
+	for (; id != 0; id = ptr(ctx, id)->next)
+		count(ctx, id, depth);
+}
+
+/**@brief Ersetzt die gewählten Produkte durch ihre Plätze.
+ */
+static void
+replace(strength_ctx_t* ctx, syntree_nid id)
+{
+	syntree_node_t* node = ptr(ctx, id);
+	syntree_nid mul;
+	unsigned int i;
+
+	if (leaf(node))
+		return;
+
+	if ((mul = factor(ctx, id)) != 0)
+	{
+		if ((i = lookup(ctx, mul, 0)) < ctx->len && ctx->derived[i].slot != 0)
+		{
+			node->tag = SYNTREE_TAG_LocVar;
+			node->value.variable = ctx->derived[i].slot;
+			++ctx->count;
+		}
+
+		return;
+	}
+
+	if (node->tag == SYNTREE_TAG_Call || node->tag == SYNTREE_TAG_TailCall)
+		id = ptr(ctx, node->value.container.first)->value.container.first;
+	else
+		id = node->value.container.first;
+
+	for (; id != 0; id = ptr(ctx, id)->next)
+		replace(ctx, id);
+}
+
+/**@brief Hängt eine Anweisung an den Körper einer Schleife an.
+ */
+static void
+append(strength_ctx_t* ctx, syntree_nid body, syntree_nid stmt)
+{
+	syntree_nid old;
+	syntree_node_t* node;
+
+	if (ptr(ctx, body)->tag != SYNTREE_TAG_Sequence)
+	{
+		/* aus dem Körper wird { Körper } */
+		old = clone(ctx, body);
+		node = ptr(ctx, body);
+		node->tag = SYNTREE_TAG_Sequence;
+		node->type = SYNTREE_TYPE_Void;
+		node->value.container.first = node->value.container.last = 0;
+		syntreeNodeAppend(ctx->tree, body, old);
+	}
+
+	syntreeNodeAppend(ctx->tree, body, stmt);
+}
+
+/**@brief Bestimmt die Schrittweite einer Zuweisung <tt>i = i +- c</tt>.
+ * @return != 0, falls der Schritt diese Form hat
+ */
+static int
+stride(const strength_ctx_t* ctx, syntree_nid step, int* c)
+{
+	const syntree_node_t* node = ptr(ctx, step);
+	syntree_nid lhs, rhs;
+
+	if (node->tag != SYNTREE_TAG_Assign || !induction(ctx, node->value.container.first))
+		return 0;
+
+	node = ptr(ctx, node->value.container.last);
+
+	if (node->tag != SYNTREE_TAG_Plus && node->tag != SYNTREE_TAG_Minus)
+		return 0;
+
+	lhs = node->value.container.first;
+	rhs = node->value.container.last;
+
+	if (node->tag == SYNTREE_TAG_Plus && induction(ctx, rhs))
+	{
+		rhs = lhs;
+		lhs = node->value.container.last;
+	}
+
+	if (!induction(ctx, lhs) || ptr(ctx, rhs)->tag != SYNTREE_TAG_Integer)
+		return 0;
+
+	*c = ptr(ctx, rhs)->value.integer;
+
+	if (node->tag == SYNTREE_TAG_Minus)
+		*c = (int) -(unsigned int) *c;
+
+	return 1;
+}
+
+/**@brief Ersetzt die abgeleiteten Induktionsvariablen einer Zählschleife.
+ */
+static void
+loop(strength_ctx_t* ctx, syntree_nid id)
+{
+	syntree_nid init, cond, step, body, pre = 0, mul, inc, stmt;
+	unsigned int locals, i, tmp;
+	strength_derived_t* d;
+	syntree_node_t* node;
+	int c;
+
+	init = ptr(ctx, id)->value.container.first;
+	cond = ptr(ctx, init)->next;
+	step = (cond != 0) ? ptr(ctx, cond)->next : 0;
+	body = (step != 0) ? ptr(ctx, step)->next : 0;
+
+	if (body == 0 || ptr(ctx, init)->tag != SYNTREE_TAG_Assign)
+		return;
+
+	node = ptr(ctx, ptr(ctx, init)->value.container.first);
+
+	if (node->tag != SYNTREE_TAG_LocVar || node->type != SYNTREE_TYPE_Integer)
+		return;
+
+	ctx->iv = node->value.variable;
+
+	if (!stride(ctx, step, &c) || !pure(ctx, ptr(ctx, init)->value.container.last))
+		return;
+
+	/* die Induktionsvariable ändert sich nur im Schritt */
+	locals = ptr(ctx, ctx->func)->value.function.locals;
+
+	if (locals > ctx->cap)
+	{
+		ctx->cap = 2 * locals;
+		ctx->written = grow(ctx->written, ctx->cap);
+	}
+
+	for (i = 0; i < locals; ++i)
+		ctx->written[i] = 0;
+
+	writes(ctx, cond);
+	writes(ctx, body);
+
+	if (ctx->written[ctx->iv])
+		return;
+
+	/* Faktoren dürfen auch vor dem Schritt nicht zugewiesen werden */
+	writes(ctx, init);
+	writes(ctx, step);
+
+	ctx->len = 0;
+	count(ctx, cond, 0);
+	count(ctx, body, 0);
+
+	for (i = 0; i < ctx->len; ++i)
+	{
+		if (ctx->derived[i].weight < 2)
+			continue;
+
+		if (pre == 0)
+			pre = syntreeNodeEmpty(ctx->tree, SYNTREE_TAG_Sequence);
+
+		d = &ctx->derived[i];
+		d->slot = ptr(ctx, ctx->func)->value.function.locals++;
+
+		if (d->tag == SYNTREE_TAG_Integer)
+		{
+			mul = syntreeNodeInteger(ctx->tree, d->value);
+			inc = syntreeNodeInteger(ctx->tree,
+				(int) ((unsigned int) c * (unsigned int) d->value));
+		}
+		else
+		{
+			mul = variable(ctx, d->value);
+			inc = variable(ctx, d->value);
+
+			if (c != 1)
+			{
+				/* die Schrittweite wird einmal vor der Schleife berechnet */
+				tmp = ptr(ctx, ctx->func)->value.function.locals++;
+				inc = binary(ctx, SYNTREE_TAG_Times, syntreeNodeInteger(ctx->tree, c), inc);
+				syntreeNodeAppend(ctx->tree, pre, assign(ctx, tmp, inc));
+				inc = variable(ctx, tmp);
+			}
+		}
+
+		/* d = a * m vor der Schleife, d = d + c * m am Ende des Körpers */
+		if (d->tag == SYNTREE_TAG_Integer
+		 && ptr(ctx, ptr(ctx, init)->value.container.last)->tag == SYNTREE_TAG_Integer)
+			ptr(ctx, mul)->value.integer = (int) ((unsigned int) d->value
+				* (unsigned int) ptr(ctx, ptr(ctx, init)->value.container.last)->value.integer);
+		else
+			mul = binary(ctx, SYNTREE_TAG_Times,
+				copy(ctx, ptr(ctx, init)->value.container.last), mul);
+
+		syntreeNodeAppend(ctx->tree, pre, assign(ctx, d->slot, mul));
+		inc = binary(ctx, SYNTREE_TAG_Plus, variable(ctx, d->slot), inc);
+		d->update = assign(ctx, d->slot, inc);
+	}
+
+	if (pre == 0)
+		return;
+
+	replace(ctx, cond);
+	replace(ctx, body);
+
+	for (i = 0; i < ctx->len; ++i)
+		if (ctx->derived[i].slot != 0)
+			append(ctx, body, ctx->derived[i].update);
+
+	/* aus der Schleife wird { pre; Schleife } */
+	stmt = clone(ctx, id);
+	node = ptr(ctx, id);
+	node->tag = SYNTREE_TAG_Sequence;
+	node->type = SYNTREE_TYPE_Void;
+	node->value.container.first = node->value.container.last = 0;
+	syntreeNodeAppend(ctx->tree, id, pre);
+	syntreeNodeAppend(ctx->tree, id, stmt);
+}
+
+/**@brief Prüft, ob eine Gleitkommazahl eine Zweierpotenz mit normalisiert
+ * darstellbarem Kehrwert ist.
+ * @details Der Kehrwert ist dann exakt, Division und Multiplikation runden
+ * also dasselbe Ergebnis.
+ */
+static int
+power(float value)
+{
+	union { float f; unsigned int u; } bits;
+	unsigned int exp;
+
+	bits.f = value;
+	exp = (bits.u >> 23) & 0xff;
+	return (bits.u & 0x7fffff) == 0 && exp >= 1 && exp <= 253;
+}
+
+/**@brief Ersetzt Gleitkommadivisionen durch Zweierpotenzen.
+ */
+static void
+reciprocal(strength_ctx_t* ctx, syntree_nid id)
+{
+	syntree_node_t* node = ptr(ctx, id);
+	syntree_node_t* rhs;
+
+	if (leaf(node))
+		return;
+
+	if (node->tag == SYNTREE_TAG_Divide && node->type == SYNTREE_TYPE_Float)
+	{
+		rhs = ptr(ctx, node->value.container.last);
+
+		if (rhs->tag == SYNTREE_TAG_Float && power(rhs->value.real))
+		{
+			node->tag = SYNTREE_TAG_Times;
+			rhs->value.real = 1.0f / rhs->value.real;
+			++ctx->count;
+		}
+	}
+
+	if (node->tag == SYNTREE_TAG_Call || node->tag == SYNTREE_TAG_TailCall)
+		id = ptr(ctx, node->value.container.first)->value.container.first;
+	else
+		id = node->value.container.first;
+
+	for (; id != 0; id = ptr(ctx, id)->next)
+		reciprocal(ctx, id);
+}
+
+/**@brief Bearbeitet alle Zählschleifen einer Anweisung, innere zuerst.
+ */
+static void
+statement(strength_ctx_t* ctx, syntree_nid id)
+{
+	syntree_nid child;
+
+	switch (ptr(ctx, id)->tag)
+	{
+	case SYNTREE_TAG_Sequence:
+		for (child = ptr(ctx, id)->value.container.first; child != 0;
+		     child = ptr(ctx, child)->next)
+			statement(ctx, child);
+		break;
+
+	case SYNTREE_TAG_If:
+		for (child = ptr(ctx, ptr(ctx, id)->value.container.first)->next;
+		     child != 0; child = ptr(ctx, child)->next)
+			statement(ctx, child);
+		break;
+
+	case SYNTREE_TAG_For:
+		statement(ctx, ptr(ctx, id)->value.container.last);
+		loop(ctx, id);
+		break;
+
+	case SYNTREE_TAG_While:
+	case SYNTREE_TAG_DoWhile:
+		statement(ctx, ptr(ctx, id)->value.container.last);
+		break;
+
+	default:
+		break;
+	}
+}
+
+/* ********************************************************* public functions */
+
+unsigned int
+strengthTree(syntree_t* self)
+{
+	strength_ctx_t ctx;
+	unsigned int id, len = self->len;
+	syntree_nid body;
+
+	ctx.tree = self;
+	ctx.written = NULL;
+	ctx.cap = 0;
+	ctx.derived = NULL;
+	ctx.len = ctx.dcap = 0;
+	ctx.count = 0;
+
+	for (id = 1; id < len; ++id)
+	{
+		if (syntreeNodePtr(self, id)->tag != SYNTREE_TAG_Function)
+			continue;
+
+		ctx.func = id;
+		body = syntreeNodePtr(self, id)->value.function.body;
+		reciprocal(&ctx, body);
+		statement(&ctx, body);
+	}
+
+	free(ctx.written);
+	free(ctx.derived);
+	return ctx.count;
+}
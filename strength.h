@@ -0,0 +1,49 @@
+/***************************************************************************//**
+ * @file strength.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält einen Durchlauf, der Induktionsvariablen in Zählschleifen
+ * erkennt und Multiplikationen mit ihnen durch Additionen ersetzt.
+ * @details
+ * Eine \c for-Schleife, deren Schritt eine ganzzahlige lokale Variable \c i
+ * um eine Konstante \c c erhöht oder verringert und deren Bedingung und
+ * Körper \c i nicht zuweisen, hat \c i als Basisinduktionsvariable. Ein
+ * Produkt <tt>i * m</tt> mit einer Konstanten oder einer in der Schleife
+ * nicht zugewiesenen lokalen Variable \c m ist dann eine abgeleitete
+ * Induktionsvariable und wächst pro Durchlauf um <tt>c * m</tt>. Aus
+ * @code
+ * for (i = a; i < n; i = i + 1) { s = s + v * i; t = t + v * i; }
+ * @endcode
+ * wird dann sinngemäß
+ * @code
+ * d = a * v;
+ * for (i = a; i < n; i = i + 1) { s = s + d; t = t + d; d = d + v; }
+ * @endcode
+ * Da C1 weder \c break noch \c continue kennt, wird das Ende des Körpers vor
+ * jedem Schritt erreicht, sofern die Funktion nicht zurückspringt. Weil die
+ * Fortschreibung selbst eine Zuweisung pro Durchlauf kostet, wird ein Produkt
+ * nur ersetzt, wenn es mindestens zweimal oder in einer inneren Schleife
+ * vorkommt.
+ *
+ * Außerdem wird die Gleitkommadivision durch eine Zweierpotenz zur
+ * Multiplikation mit ihrem exakten Kehrwert. Der Durchlauf muss vor
+ * definiteInit() laufen, da er neue Plätze einführt.
+ ******************************************************************************/
+
+#ifndef STRENGTH_H_INCLUDED
+#define STRENGTH_H_INCLUDED
+
+/* *** includes ************************************************************* */
+
+#include "syntree.h"
+
+/* *** interface ************************************************************ */
+
+/**@brief Ersetzt Multiplikationen mit Induktionsvariablen und Divisionen
+ * durch Zweierpotenzen in allen Funktionen.
+ * @param self  der Syntaxbaum
+ * @return Anzahl der ersetzten Ausdrücke
+ */
+extern unsigned int
+strengthTree(syntree_t* self);
+
+#endif /* STRENGTH_H_INCLUDED */
@@ -182,6 +182,18 @@ symtabLookup(const symtab_t* self, const char* id)
 	return dictGet(&self->map, id);
 }
 
+const char*
+symtabFunctionName(const symtab_t* self, syntree_nid func)
+{
+	unsigned int i;
+	
+	for (i = 0; i < stackCount(self->decl); ++i)
+		if (self->decl[i]->is_function && self->decl[i]->body == func)
+			return self->decl[i]->name;
+	
+	return "?";
+}
+
 symtab_symbol_t*
 symtabSymbol(const char* name, syntree_node_type type)
 {
@@ -172,6 +172,15 @@ symtabParam(symtab_symbol_t* func, symtab_symbol_t* sym);
 extern symtab_symbol_t*
 symtabLookup(const symtab_t* self, const char* id);
 
+/**@brief Sucht den Namen einer Funktion anhand ihres Funktionsknotens.
+ * @param self  die Symboltabelle
+ * @param func  Knoten-ID der Funktion im Syntaxbaum
+ * @return der Bezeichner der Funktion oder\n
+ *      \c "?", falls keine Funktion zu diesem Knoten gehört
+ */
+extern const char*
+symtabFunctionName(const symtab_t* self, syntree_nid func);
+
 /**@brief Erstellt und initialisiert ein neues Symbol für die Symboltabelle.
  * 
  * Das Symbol sollte konfiguriert und dann in die Symboltabelle eingetragen
@@ -301,8 +301,9 @@ syntreePrint(const syntree_t* self, syntree_nid root, FILE* out, int indent)
 		break;
 		
 	case SYNTREE_TAG_Call:
-		fprintf(out, "Call %s [nid=%i] {\n", nodeTypeName[node->type],
-		        node->value.container.last);
+	case SYNTREE_TAG_TailCall:
+		fprintf(out, "%s %s [nid=%i] {\n", nodeTagName[node->tag],
+		        nodeTypeName[node->type], node->value.container.last);
 		syntreePrint(self, node->value.container.first, out, indent+1);
 		fprintf(out, "%*s}\n", indent*4, "");
 		break;
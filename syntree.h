@@ -77,7 +77,55 @@
 	NODE(Leq) \
 	NODE(Geq) \
 	NODE(Lst) \
-	NODE(Grt)
+	NODE(Grt) \
+	/* Typspezialisierte Ausdrücke (siehe quicken.h) */ \
+	NODE(CastInt) \
+	NODE(PlusInt) \
+	NODE(PlusFloat) \
+	NODE(MinusInt) \
+	NODE(MinusFloat) \
+	NODE(TimesInt) \
+	NODE(TimesFloat) \
+	NODE(DivideInt) \
+	NODE(DivideFloat) \
+	NODE(UminusInt) \
+	NODE(UminusFloat) \
+	NODE(EqtInt) \
+	NODE(EqtFloat) \
+	NODE(NeqInt) \
+	NODE(NeqFloat) \
+	NODE(LeqInt) \
+	NODE(LeqFloat) \
+	NODE(GeqInt) \
+	NODE(GeqFloat) \
+	NODE(LstInt) \
+	NODE(LstFloat) \
+	NODE(GrtInt) \
+	NODE(GrtFloat) \
+	/* Fusionierte Ausdrücke (siehe fuse.h) */ \
+	NODE(PlusIntLocK) \
+	NODE(MinusIntLocK) \
+	NODE(TimesIntLocK) \
+	NODE(DivideIntLocK) \
+	NODE(PlusFloatLocK) \
+	NODE(MinusFloatLocK) \
+	NODE(TimesFloatLocK) \
+	NODE(DivideFloatLocK) \
+	NODE(EqtIntLocK) \
+	NODE(NeqIntLocK) \
+	NODE(LeqIntLocK) \
+	NODE(GeqIntLocK) \
+	NODE(LstIntLocK) \
+	NODE(GrtIntLocK) \
+	NODE(EqtIntLocLoc) \
+	NODE(NeqIntLocLoc) \
+	NODE(LeqIntLocLoc) \
+	NODE(GeqIntLocLoc) \
+	NODE(LstIntLocLoc) \
+	NODE(GrtIntLocLoc) \
+	NODE(AssignLocPlusK) \
+	/* Endaufrufe (siehe tailcall.h) */ \
+	NODE(TailCall)
 
 /**@brief X-Liste aller eingebauten Datentypen für C1-Programme.
  * @see https://en.wikipedia.org/wiki/X_Macro
@@ -0,0 +1,35 @@
+/***************************************************************************//**
+ * @file tailcall.c
+ * @author Dorian Weber und die Studenten
+ * @brief Implementation der Markierung von Endaufrufen.
+ ******************************************************************************/
+
+#include "tailcall.h"
+
+/* ********************************************************* public functions */
+
+unsigned int
+tailcallTree(syntree_t* self)
+{
+	syntree_node_t *node, *call;
+	unsigned int count = 0, id;
+
+	for (id = 1; id < self->len; ++id)
+	{
+		node = syntreeNodePtr(self, id);
+
+		if (node->tag != SYNTREE_TAG_Return || node->value.container.first == 0)
+			continue;
+
+		call = syntreeNodePtr(self, node->value.container.first);
+
+		/* ein umzuwandelnder Rückgabewert steht in einem Cast-Knoten */
+		if (call->tag == SYNTREE_TAG_Call)
+		{
+			call->tag = SYNTREE_TAG_TailCall;
+			++count;
+		}
+	}
+
+	return count;
+}
@@ -0,0 +1,34 @@
+/***************************************************************************//**
+ * @file tailcall.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält einen Durchlauf, der Aufrufe in Endposition markiert.
+ * @details
+ * Ein Aufruf steht in Endposition, wenn er unmittelbar das Argument einer
+ * Rücksprunganweisung ist (<tt>return f(...);</tt>). Solche Aufrufe erhalten
+ * die Knotenart \c TailCall. Der Bauminterpreter legt für sie keinen neuen
+ * Rahmen an, sondern überschreibt den Rahmen der aufrufenden Funktion mit den
+ * Argumenten und setzt die Ausführung im Körper der gerufenen Funktion fort,
+ * ohne den C-Stack wachsen zu lassen. Endrekursive Funktionen laufen damit in
+ * konstantem Speicher.
+ *
+ * Andere Ausführungsstufen behandeln \c TailCall wie \c Call
+ * (siehe quickenGeneric()).
+ ******************************************************************************/
+
+#ifndef TAILCALL_H_INCLUDED
+#define TAILCALL_H_INCLUDED
+
+/* *** includes ************************************************************* */
+
+#include "syntree.h"
+
+/* *** interface ************************************************************ */
+
+/**@brief Markiert alle Aufrufe in Endposition.
+ * @param self  der Syntaxbaum
+ * @return Anzahl der markierten Aufrufe
+ */
+extern unsigned int
+tailcallTree(syntree_t* self);
+
+#endif /* TAILCALL_H_INCLUDED */
@@ -0,0 +1,236 @@
+/***************************************************************************//**
+ * @file vmstack.c
+ * @author Dorian Weber und die Studenten
+ * @brief Implementation des Variablenstacks mit Schutzbereich.
+ ******************************************************************************/
+
+#define _DEFAULT_SOURCE
+
+#include "vmstack.h"
+#include "quota.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+	#include <signal.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/resource.h>
+	#define VMSTACK_GUARDED 1
+#else
+	#define VMSTACK_GUARDED 0
+#endif
+
+#ifndef MAP_NORESERVE
+	#define MAP_NORESERVE 0
+#endif
+
+/**@brief Größe des Schutzbereichs hinter dem Stack.
+ * @note Muss größer sein als jeder Funktionsrahmen, damit ein Zugriff nicht
+ * über den Schutzbereich hinweg in fremden Speicher springen kann.
+ */
+#define VMSTACK_GUARD_SIZE (16u << 20)
+
+/**@brief Größe der Blöcke, die bei Bedarf angelegt werden.
+ */
+#define VMSTACK_CHUNK_SIZE (64u << 10)
+
+/* ****************************************************************** globals */
+
+char* vmstackFloor;
+
+#if VMSTACK_GUARDED
+
+/**@brief Beginn des reservierten Bereichs.
+ */
+static char* base;
+
+/**@brief Ende des nutzbaren Stacks und Beginn des Schutzbereichs.
+ */
+static char* guard;
+
+/**@brief Ende des Schutzbereichs.
+ */
+static char* end;
+
+/**@brief Grenzen des C-Stacks, innerhalb derer Schutzverletzungen als
+ * Stacküberlauf gelten.
+ */
+static char *cstackLow, *cstackHigh;
+
+/**@brief Alternativer Stack für den Signalhandler.
+ */
+static void* altstack;
+
+/* ******************************************************** private functions */
+
+/**@brief Beendet das Programm nach einem Überlauf, an dem nicht weitergerechnet
+ * werden kann.
+ * @note Im Signalhandler sind nur async-signal-sichere Funktionen erlaubt; die
+ * gepufferte Standardausgabe geht dabei verloren.
+ */
+static void
+overflow(void)
+{
+	static const char msg[] = "stack overflow\n";
+	ssize_t rc;
+
+	rc = write(STDERR_FILENO, msg, sizeof(msg) - 1);
+	(void) rc;
+	_exit(QUOTA_EXIT_STACK);
+}
+
+/**@brief Gibt den Block eines Bereichs frei, in dem eine Adresse liegt.
+ * @return 0, falls der Block angelegt werden konnte\n
+ *      != 0 ansonsten
+ */
+static int
+commit(char* addr, char* from, char* to)
+{
+	char* chunk = from + (size_t) (addr - from) / VMSTACK_CHUNK_SIZE * VMSTACK_CHUNK_SIZE;
+	size_t len = (to - chunk < VMSTACK_CHUNK_SIZE) ? (size_t) (to - chunk)
+	                                               : VMSTACK_CHUNK_SIZE;
+
+	if (mprotect(chunk, len, PROT_READ | PROT_WRITE) != 0)
+		return 1;
+
+	/* DUMMY ist -1, also sind alle Bytes 0xff */
+	memset(chunk, 0xff, len);
+	return 0;
+}
+
+/**@brief Legt beim ersten Zugriff einen Block des Stacks an.
+ */
+static void
+fault(int sig, siginfo_t* info, void* context)
+{
+	char* addr = info->si_addr;
+
+	(void) context;
+
+	if (addr >= base && addr < guard && commit(addr, base, guard) == 0)
+		return;
+
+	/* der Rahmen darf noch in den Schutzbereich schreiben, abgebrochen wird
+	 * beim nächsten Verbrauch von Treibstoff, an dem die Ausgabe sicher
+	 * geleert werden kann */
+	if (addr >= guard && addr < end && commit(addr, guard, end) == 0)
+	{
+		quotaOverflow();
+		return;
+	}
+
+	if ((addr >= guard && addr < end) || (addr >= cstackLow && addr < cstackHigh))
+		overflow();
+
+	/* keine bekannte Ursache, das Standardverhalten auslösen */
+	signal(sig, SIG_DFL);
+}
+
+#endif /* VMSTACK_GUARDED */
+
+/* ********************************************************* public functions */
+
+int
+vmstackInit(minako_vm_t* self, size_t size)
+{
+#if VMSTACK_GUARDED
+	struct sigaction action;
+	struct rlimit limit;
+	stack_t alt;
+	char here;
+	size_t page = (size_t) sysconf(_SC_PAGESIZE);
+
+	size = (size << 20) / page * page;
+
+	if (size == 0)
+		size = page;
+
+	base = mmap(NULL, size + VMSTACK_GUARD_SIZE, PROT_NONE,
+	            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+	if (base == MAP_FAILED)
+		return 1;
+
+	guard = base + size;
+	end = guard + VMSTACK_GUARD_SIZE;
+
+	/* der C-Stack wächst von hier aus höchstens um das Ressourcenlimit; ohne
+	 * Limit gibt es keine Untergrenze und keine Prüfung beim Aufruf */
+	cstackHigh = &here + VMSTACK_CHUNK_SIZE;
+	cstackLow = NULL;
+	vmstackFloor = NULL;
+
+	if (getrlimit(RLIMIT_STACK, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY)
+	{
+		if ((uintptr_t) &here > limit.rlim_cur + VMSTACK_CHUNK_SIZE)
+			cstackLow = &here - limit.rlim_cur - VMSTACK_CHUNK_SIZE;
+
+		/* ein Achtel des C-Stacks bleibt für das Melden des Überlaufs */
+		if ((uintptr_t) &here > limit.rlim_cur)
+			vmstackFloor = &here - limit.rlim_cur + limit.rlim_cur / 8;
+	}
+
+	/* der Handler muss auch bei erschöpftem C-Stack laufen können */
+	altstack = malloc(SIGSTKSZ);
+
+	if (altstack == NULL)
+	{
+		munmap(base, size + VMSTACK_GUARD_SIZE);
+		return 1;
+	}
+
+	alt.ss_sp = altstack;
+	alt.ss_size = SIGSTKSZ;
+	alt.ss_flags = 0;
+	sigaltstack(&alt, NULL);
+
+	memset(&action, 0, sizeof(action));
+	action.sa_sigaction = fault;
+	action.sa_flags = SA_SIGINFO | SA_ONSTACK | SA_NODEFER;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGSEGV, &action, NULL);
+	sigaction(SIGBUS, &action, NULL);
+
+	self->stack = (minako_data_t*) base;
+	self->limit = (minako_data_t*) guard;
+#else
+	/* ohne Schutzbereich wird der gesamte Stack sofort angelegt */
+	size <<= 20;
+	self->stack = malloc(size);
+
+	if (self->stack == NULL)
+		return 1;
+
+	memset(self->stack, 0xff, size);
+	self->limit = self->stack + size / sizeof(*self->stack);
+#endif
+
+	self->ebp = self->esp = self->stack;
+	return 0;
+}
+
+void
+vmstackRelease(minako_vm_t* self)
+{
+#if VMSTACK_GUARDED
+	stack_t alt;
+
+	signal(SIGSEGV, SIG_DFL);
+	signal(SIGBUS, SIG_DFL);
+
+	memset(&alt, 0, sizeof(alt));
+	alt.ss_flags = SS_DISABLE;
+	sigaltstack(&alt, NULL);
+
+	munmap(base, (size_t) (end - base));
+	free(altstack);
+	vmstackFloor = NULL;
+#else
+	free(self->stack);
+#endif
+
+	self->stack = self->limit = self->ebp = self->esp = NULL;
+}
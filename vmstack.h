@@ -0,0 +1,75 @@
+/***************************************************************************//**
+ * @file vmstack.h
+ * @author Dorian Weber und die Studenten
+ * @brief Enthält die Verwaltung des Variablenstacks der virtuellen Maschine.
+ * @details
+ * Hier ist ein Beispiel für die Benutzung:
+ * @code
+ * vmstackInit(vm, 1024);
+ * ...
+ * vmstackRelease(vm);
+ * @endcode
+ *
+ * Der Stack wird als Adressbereich ohne Zugriffsrechte reserviert, gefolgt von
+ * einem ebenfalls unzugänglichen Schutzbereich. Der erste Zugriff auf eine
+ * noch nicht angelegte Seite löst eine Schutzverletzung aus; der
+ * Signalhandler gibt dann einen Block von Seiten frei und belegt ihn mit
+ * \c DUMMY, danach wird der Zugriff wiederholt. Auch ein Zugriff auf den
+ * Schutzbereich wird noch zugelassen, entzieht aber den Treibstoff (siehe
+ * quota.h), sodass der Interpreter beim nächsten Funktionseintritt die
+ * Ausgabe leert und "stack overflow" meldet. Erst am Ende des Schutzbereichs
+ * oder des C-Stacks beendet der Signalhandler das Programm selbst, ohne die
+ * gepufferte Ausgabe zu schreiben.
+ *
+ * Die Interpreter müssen deshalb bei Aufrufen keine Grenzen des
+ * Variablenstacks prüfen; der Schutzbereich ist so groß gewählt, dass ihn kein
+ * Funktionsrahmen überspringen kann. Interpreter, die C1-Aufrufe auf den
+ * C-Stack abbilden, vergleichen dagegen mit VMSTACK_PROBE() dessen Tiefe,
+ * damit auch ein Überlauf des C-Stacks an einer sicheren Stelle endet.
+ ******************************************************************************/
+
+#ifndef VMSTACK_H_INCLUDED
+#define VMSTACK_H_INCLUDED
+
+/* *** includes ************************************************************* */
+
+#include "minako.h"
+#include "quota.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**@brief Prüft bei einem Funktionseintritt, ob der C-Stack fast erschöpft
+ * ist, und behandelt dies wie einen Überlauf des Variablenstacks.
+ * @note Der Rest des C-Stacks reicht noch zum Leeren der Ausgabe.
+ */
+#define VMSTACK_PROBE() \
+	do { \
+		char probe_; \
+		if ((uintptr_t) &probe_ < (uintptr_t) vmstackFloor) \
+			quotaOverflow(); \
+	} while (0)
+
+/* *** globals ************************************************************** */
+
+/**@brief Adresse, unterhalb derer der C-Stack als erschöpft gilt, oder NULL.
+ */
+extern char* vmstackFloor;
+
+/* *** interface ************************************************************ */
+
+/**@brief Reserviert den Variablenstack und installiert den Signalhandler.
+ * @param self  die virtuelle Maschine
+ * @param size  maximale Größe des Stacks in MiB
+ * @return 0, falls keine Fehler aufgetreten sind\n
+ *      != 0 ansonsten
+ */
+extern int
+vmstackInit(minako_vm_t* self, size_t size);
+
+/**@brief Gibt den Variablenstack wieder frei.
+ * @param self  die virtuelle Maschine
+ */
+extern void
+vmstackRelease(minako_vm_t* self);
+
+#endif /* VMSTACK_H_INCLUDED */